@@ -0,0 +1,207 @@
+#include "rvemu.h"
+#include "decode_table.h"
+
+/**
+ * Decoder microbenchmark
+ *
+ * Runs inst_decode alone over millions of instructions and reports the time
+ * and the host branch misses per instruction, so changes of the decoder can
+ * be judged on numbers. Two sets are measured: random valid encodings of
+ * every instruction of insts.spec, and the instructions found in the
+ * executable segments of a real program.
+ *
+ *   bench_decode [program]
+ */
+
+#define BENCH_DECODES   (1 << 23)   // instructions decoded per set
+#define BENCH_RANDOM    (1 << 20)   // random encodings in the random set
+
+typedef struct {
+    u32 *insts;
+    u64 count;
+    u64 skipped;    // words of the program the decoder does not know
+} inst_set_t;
+
+static u64 rng = 0x9E3779B97F4A7C15ULL;
+
+static u64 bench_rand() {
+    rng ^= rng << 13;
+    rng ^= rng >> 7;
+    rng ^= rng << 17;
+    return rng;
+}
+
+/**
+ * @brief find the encoding of an instruction the way inst_decode does
+ *
+ * @param raw raw instruction
+ * @return const decode_entry_t* the matching encoding, NULL if invalid
+ */
+static const decode_entry_t *bench_lookup(u32 raw) {
+    const decode_key_t *key = &decode_keys[DECODE_KEY(raw)];
+    const decode_entry_t *entry = &decode_slots[key->base + ((raw >> key->shift) & key->mask)];
+    while ((raw & entry->mask) != entry->match) {
+        if (!entry->next) return NULL;
+        entry = &decode_overflow[entry->next];
+    }
+    // c.addi4spn needs a non zero immediate
+    if (entry->format == fmt_ciw && !(raw & 0x1FE0)) return NULL;
+    return entry;
+}
+
+static void set_push(inst_set_t *set, u32 raw, u64 *capacity) {
+    if (set->count == *capacity) {
+        *capacity = *capacity ? *capacity * 2 : 4096;
+        set->insts = realloc(set->insts, *capacity * sizeof(u32));
+        if (!set->insts) fatal("realloc failed.");
+    }
+    set->insts[set->count++] = raw;
+}
+
+/**
+ * @brief random valid encodings, every encoding of the spec is equally likely
+ *
+ * @param set set to fill
+ */
+static void bench_random_set(inst_set_t *set) {
+    const decode_entry_t *encodings[sizeof(decode_slots) / sizeof(decode_slots[0])];
+    u64 num_encodings = 0, capacity = 0;
+
+    // the slots repeat the encodings of their key, keep one of each
+    for (u64 i = 0; i < sizeof(decode_slots) / sizeof(decode_slots[0]); i++) {
+        const decode_entry_t *entry = &decode_slots[i];
+        if (!entry->mask) continue;
+        bool seen = false;
+        for (u64 j = 0; j < num_encodings && !seen; j++) {
+            seen = encodings[j]->mask == entry->mask && encodings[j]->match == entry->match;
+        }
+        if (!seen) encodings[num_encodings++] = entry;
+    }
+    for (u64 i = 1; i < sizeof(decode_overflow) / sizeof(decode_overflow[0]); i++) {
+        const decode_entry_t *entry = &decode_overflow[i];
+        bool seen = false;
+        for (u64 j = 0; j < num_encodings && !seen; j++) {
+            seen = encodings[j]->mask == entry->mask && encodings[j]->match == entry->match;
+        }
+        if (!seen) encodings[num_encodings++] = entry;
+    }
+
+    while (set->count < BENCH_RANDOM) {
+        const decode_entry_t *entry = encodings[bench_rand() % num_encodings];
+        u32 raw = ((u32) bench_rand() & ~entry->mask) | entry->match;
+        if (entry->inst.rvc) raw &= 0xFFFF;
+        if (bench_lookup(raw)) set_push(set, raw, &capacity);
+    }
+}
+
+/**
+ * @brief the instructions of the executable segments of an ELF file
+ *
+ * @param set   set to fill
+ * @param path  path of the ELF file
+ */
+static void bench_program_set(inst_set_t *set, const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (!file) fatalf("can not open %s", path);
+
+    elf64_ehdr_t ehdr;
+    if (fread(&ehdr, 1, sizeof(ehdr), file) != sizeof(ehdr) || memcmp(ehdr.e_ident, ELFMAG, 4)) {
+        fatalf("%s is not an ELF file", path);
+    }
+    if (ehdr.e_machine != ELF_MACHINE_RISCV || ehdr.e_ident[EI_CLASS] != ELFCLASS64) {
+        fatalf("%s is not a RV64 program", path);
+    }
+
+    u64 capacity = 0;
+    for (int i = 0; i < ehdr.e_phnum; i++) {
+        elf64_phdr_t phdr;
+        if (fseek(file, ehdr.e_phoff + i * ehdr.e_phentsize, SEEK_SET) ||
+            fread(&phdr, 1, sizeof(phdr), file) != sizeof(phdr)) {
+            fatalf("can not read the program headers of %s", path);
+        }
+        if (phdr.p_type != PT_LOAD || !(phdr.p_flags & PF_X)) continue;
+
+        // two bytes of padding, the last instruction is read as a 32 bits word
+        u8 *code = calloc(phdr.p_filesz + 2, 1);
+        if (!code) fatal("calloc failed.");
+        if (fseek(file, phdr.p_offset, SEEK_SET) || fread(code, 1, phdr.p_filesz, file) != phdr.p_filesz) {
+            fatalf("can not read the code of %s", path);
+        }
+        for (u64 offset = 0; offset + 2 <= phdr.p_filesz;) {
+            u32 raw;
+            memcpy(&raw, code + offset, sizeof(raw));
+            if (bench_lookup(raw)) set_push(set, raw, &capacity);
+            else                   set->skipped++;
+            offset += (raw & 0x3) == 0x3 ? 4 : 2;
+        }
+        free(code);
+    }
+    fclose(file);
+}
+
+/**
+ * @brief decode a set of instructions over and over and print the results
+ *
+ * @param name  name of the set
+ * @param set   instructions to decode
+ * @param perf  host counters
+ */
+static void bench_run(const char *name, inst_set_t *set, perf_t *perf) {
+    inst_t inst;
+    u64 sum = 0;    // keeps the results alive
+
+    // warm up the caches and the branch predictors
+    for (u64 i = 0; i < set->count; i++) {
+        inst_decode(&inst, set->insts[i]);
+        sum += inst.type;
+    }
+
+    u64 branches[2], misses[2];
+    bool counters = perf_read(perf, perf_branches, &branches[0]) && perf_read(perf, perf_branch_misses, &misses[0]);
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (u64 i = 0, j = 0; i < BENCH_DECODES; i++) {
+        inst_decode(&inst, set->insts[j]);
+        sum += inst.type;
+        if (++j == set->count) j = 0;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    counters = counters && perf_read(perf, perf_branches, &branches[1]) && perf_read(perf, perf_branch_misses, &misses[1]);
+
+    f64 ns = (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+    printf("%-8s %d decodes of %lu instructions: %.2f ns/inst", name, BENCH_DECODES, set->count, ns / BENCH_DECODES);
+    if (counters) {
+        u64 branch_count = branches[1] - branches[0], miss_count = misses[1] - misses[0];
+        printf(", %.3f branch misses/inst (%.2f%% of %.1f branches/inst)",
+               (f64) miss_count / BENCH_DECODES, branch_count ? 100.0 * miss_count / branch_count : 0.0,
+               (f64) branch_count / BENCH_DECODES);
+    } else {
+        printf(", branch misses unavailable");
+    }
+    printf(" [%lx]\n", sum & 0xF);
+}
+
+int main(int argc, char **argv) {
+    if (argc > 2) {
+        fprintf(stderr, "usage: %s [program]\n", argv[0]);
+        return 1;
+    }
+
+    perf_t perf;
+    perf_open(&perf);
+
+    inst_set_t random = {0};
+    bench_random_set(&random);
+    bench_run("random", &random, &perf);
+
+    if (argc == 2) {
+        inst_set_t program = {0};
+        bench_program_set(&program, argv[1]);
+        if (!program.count) fatalf("no instruction found in %s", argv[1]);
+        bench_run("program", &program, &perf);
+        if (program.skipped) printf("program: %lu unknown instructions skipped\n", program.skipped);
+    }
+    return 0;
+}
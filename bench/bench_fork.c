@@ -0,0 +1,89 @@
+#define _GNU_SOURCE
+#include <spawn.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include "rvemu.h"
+
+/**
+ * Fork server benchmark
+ *
+ * Runs a guest program many times with the same input, first with a fresh
+ * rvemu launch per run, then with the runs forked by one rvemu --fork-server
+ * from the ready point of the guest, and prints the runs per second of both.
+ * The guest reads the input on its stdin, its output is dropped.
+ *
+ *   bench_fork rvemu program [runs [input]]
+ */
+
+extern char **environ;
+
+static f64 bench_now() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+static pid_t bench_spawn(char **argv, int in, int request, int status) {
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, in, STDIN_FILENO);
+    posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+    if (request >= 0) {
+        posix_spawn_file_actions_adddup2(&actions, request, SNAPSHOT_REQUEST_FD);
+        posix_spawn_file_actions_adddup2(&actions, status, SNAPSHOT_STATUS_FD);
+    }
+    pid_t pid;
+    if (posix_spawn(&pid, argv[0], &actions, NULL, argv, environ)) fatal("posix_spawn failed");
+    posix_spawn_file_actions_destroy(&actions);
+    return pid;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3 || argc > 5) {
+        fprintf(stderr, "usage: %s rvemu program [runs [input]]\n", argv[0]);
+        return 1;
+    }
+    int runs = argc > 3 ? atoi(argv[3]) : 1000;
+    const char *input = argc > 4 ? argv[4] : "";
+    u32 len = strlen(input);
+    if (runs < 1) fatal("runs out of range");
+
+    // a fresh emulator, loading and starting the guest at each run
+    int in = memfd_create("input", MFD_CLOEXEC);
+    if (in < 0 || write(in, input, len) != len) fatal(strerror(errno));
+    char *fresh[] = {argv[1], argv[2], NULL};
+    f64 start = bench_now();
+    int status = 0;
+    for (int i = 0; i < runs; i++) {
+        lseek(in, 0, SEEK_SET);
+        waitpid(bench_spawn(fresh, in, -1, -1), &status, 0);
+    }
+    f64 launch = bench_now() - start;
+    printf("fresh launch %8.1f runs/s, exit status %d\n", runs / launch, WEXITSTATUS(status));
+
+    // one fork server, each run forked from the ready point
+    int request[2], reply[2];
+    if (pipe2(request, O_CLOEXEC) || pipe2(reply, O_CLOEXEC)) fatal(strerror(errno));
+    char *server[] = {argv[1], "--fork-server", argv[2], NULL};
+    start = bench_now();
+    pid_t pid = bench_spawn(server, in, request[0], reply[1]);
+    close(request[0]);
+    close(reply[1]);
+    u32 hello;
+    if (read(reply[0], &hello, sizeof(hello)) != sizeof(hello) || hello != SNAPSHOT_HELLO) {
+        fatal("no fork server, does the guest reach its ready point?");
+    }
+    f64 ready = bench_now();
+    for (int i = 0; i < runs; i++) {
+        if (write(request[1], &len, sizeof(len)) != sizeof(len) || write(request[1], input, len) != len ||
+            read(reply[0], &status, sizeof(status)) != sizeof(status)) {
+            fatal("fork server stopped");
+        }
+    }
+    f64 forked = bench_now() - ready;
+    close(request[1]);
+    waitpid(pid, NULL, 0);
+    printf("fork server  %8.1f runs/s, exit status %d, %.1f ms to the ready point, %.1fx\n",
+           runs / forked, WEXITSTATUS(status), (ready - start) * 1e3, launch / forked);
+    return 0;
+}
@@ -0,0 +1,108 @@
+#include "rvemu.h"
+
+/**
+ * Guest file I/O benchmark
+ *
+ * Streams a file through the guest syscalls, the way a guest program does:
+ * the arguments are set in the guest registers and the data lives in guest
+ * memory. The file is written in chunks, closed, then read back in chunks,
+ * with the blocking host calls and then with the io_uring backend. Each chunk
+ * is filled before it is written, as a guest producing its output would.
+ *
+ *   bench_io [file]
+ */
+
+#define BENCH_IO_BYTES  (256ULL << 20)  // bytes written and read per run
+#define BENCH_IO_BUFFER (1 << 20)       // guest buffer, the largest chunk
+
+// newlib open flags
+#define GUEST_O_RDONLY  0x0000
+#define GUEST_O_WRONLY  0x0001
+#define GUEST_O_CREAT   0x0200
+#define GUEST_O_TRUNC   0x0400
+
+static machine_t machine;
+
+static u64 bench_syscall(u64 n, u64 arg0, u64 arg1, u64 arg2, u64 arg3) {
+    machine_set_gp_reg(&machine, a0, arg0);
+    machine_set_gp_reg(&machine, a1, arg1);
+    machine_set_gp_reg(&machine, a2, arg2);
+    machine_set_gp_reg(&machine, a3, arg3);
+    machine_set_gp_reg(&machine, a7, n);
+    return do_syscall(&machine, n);
+}
+
+static f64 bench_now() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief write then read the file in chunks through the guest syscalls
+ *
+ * @param name  name of the backend
+ * @param path  guest address of the file name
+ * @param buf   guest address of the buffer
+ * @param chunk bytes per syscall
+ */
+static void bench_run(const char *name, u64 path, u64 buf, u64 chunk) {
+    f64 start = bench_now();
+    i64 fd = bench_syscall(SYS_openat, -100, path, GUEST_O_WRONLY | GUEST_O_CREAT | GUEST_O_TRUNC, 0644);
+    if (fd < 0) fatalf("openat: %s", strerror(-fd));
+    for (u64 done = 0; done < BENCH_IO_BYTES; done += chunk) {
+        memset((void *) TO_HOST(&machine.mmu, buf), (u8) (done / chunk), chunk);
+        if (bench_syscall(SYS_write, fd, buf, chunk, 0) != chunk) fatal("short write");
+    }
+    if (bench_syscall(SYS_close, fd, 0, 0, 0)) fatal("close failed");
+    f64 written = bench_now();
+
+    fd = bench_syscall(SYS_openat, -100, path, GUEST_O_RDONLY, 0);
+    if (fd < 0) fatalf("openat: %s", strerror(-fd));
+    for (u64 done = 0; done < BENCH_IO_BYTES; done += chunk) {
+        if (bench_syscall(SYS_read, fd, buf, chunk, 0) != chunk) fatal("short read");
+        u8 *data = (u8 *) TO_HOST(&machine.mmu, buf);
+        if (data[0] != (u8) (done / chunk) || data[chunk - 1] != data[0]) fatal("data read back differs");
+    }
+    bench_syscall(SYS_close, fd, 0, 0, 0);
+    f64 read = bench_now();
+
+    printf("%-8s %7lu byte chunks: write %8.1f MB/s, read %8.1f MB/s\n", name, chunk,
+           BENCH_IO_BYTES / (written - start) * 1e-6, BENCH_IO_BYTES / (read - written) * 1e-6);
+}
+
+// a fresh machine with the file name and the buffer in guest memory
+static void bench_setup(bool uring, const char *file, u64 *path, u64 *buf) {
+    mmu_t mmu = machine.mmu;
+    memset(&machine, 0, sizeof(machine));
+    machine.mmu = mmu;
+    syscall_init(&machine);
+    if (uring) uring_init(&machine.uring);
+
+    *path = mmu_alloc(&machine.mmu, strlen(file) + 1);
+    mmu_write(&machine.mmu, *path, (u8 *) file, strlen(file) + 1);
+    *buf = mmu_alloc(&machine.mmu, BENCH_IO_BUFFER);
+}
+
+int main(int argc, char **argv) {
+    if (argc > 2) {
+        fprintf(stderr, "usage: %s [file]\n", argv[0]);
+        return 1;
+    }
+    const char *file = argc == 2 ? argv[1] : "bench_io.tmp";
+
+    mmu_init(&machine.mmu);
+    machine.mmu.base = machine.mmu.alloc = GUEST_PAGE_SIZE;
+    machine.mmu.host_alloc = TO_HOST(&machine.mmu, GUEST_PAGE_SIZE);
+
+    static const u64 chunks[] = {4096, 65536, BENCH_IO_BUFFER};
+    for (u64 i = 0; i < sizeof(chunks) / sizeof(chunks[0]); i++) {
+        u64 path, buf;
+        bench_setup(false, file, &path, &buf);
+        bench_run("sync", path, buf, chunks[i]);
+        bench_setup(true, file, &path, &buf);
+        bench_run("io_uring", path, buf, chunks[i]);
+    }
+    unlink(file);
+    return 0;
+}
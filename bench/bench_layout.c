@@ -0,0 +1,207 @@
+#include <stddef.h>
+#include "rvemu.h"
+
+/**
+ * Instruction and CPU state layout microbenchmark
+ *
+ * Runs the same decoded blocks through a dispatch loop twice: once with the
+ * inst_t and state_t of rvemu.h, and once with the layout they replaced. The
+ * old layout is a 20 bytes inst_t and a state_t with the 32 KiB CSR array
+ * between the integer registers and pc. The handlers are those of a few
+ * common integer instructions and are the same code for both layouts, so the
+ * difference comes from the layout only.
+ *
+ * Blocks are run in a pseudo random order over working sets of growing size.
+ * For each set and layout it reports the time per guest instruction of the
+ * fastest of a few interleaved runs, and the host IPC and L1d read misses per
+ * guest instruction of that run when the host provides the counters (see
+ * perf.c).
+ *
+ *   bench_layout
+ */
+
+#define BENCH_BLOCK_LEN 16          // instructions per block, the last one a branch
+#define BENCH_INSTS     (1 << 24)   // guest instructions of a run
+#define BENCH_RUNS      5           // runs per working set and layout, the fastest is kept
+
+// inst_t before it was packed into 8 bytes
+typedef struct {
+    i8 rd;
+    i8 rs1;
+    i8 rs2;
+    i8 rs3;
+    i32 imm;
+    i16 csr;
+    enum inst_type_t type;
+    bool rvc;
+    bool cont;
+    bool fused;
+} old_inst_t;
+
+// state_t before its hot fields were moved first and the CSRs out of it
+typedef struct {
+    enum exit_reason_t exit_reason;
+    u64 gp_regs[num_gp_regs];
+    u64 csr[4096];
+    fp_reg_t fp_regs[num_fp_regs];
+    u64 pc;
+    u64 reenter_pc;
+    bool raise_exception;
+    u32 exception_code;
+    u64 instret;
+} old_state_t;
+
+// instructions of the blocks, the common integer ones of compiled code
+static const enum inst_type_t bench_types[] = {
+    inst_addi, inst_addi, inst_add, inst_xor, inst_slli, inst_lui, inst_sltu,
+};
+
+static u64 rng = 0x9E3779B97F4A7C15ULL;
+
+static u64 bench_rand() {
+    rng ^= rng << 13;
+    rng ^= rng >> 7;
+    rng ^= rng << 17;
+    return rng;
+}
+
+/**
+ * Dispatch loop over blocks of inst_type with a state_type, the interpreter
+ * loop reduced to its accesses to the instructions and to the state. The
+ * next block is picked by a linear congruential generator, the order is the
+ * same for both layouts.
+ */
+#define BENCH_DISPATCH(name, inst_type, state_type)                                             \
+    static __attribute__((noinline)) void name(state_type *state, inst_type *insts, u64 blocks) { \
+        u64 seed = 0, block = 0;                                                                  \
+        for (u64 step = 0; step < BENCH_INSTS / BENCH_BLOCK_LEN; step++) {                        \
+            u64 *r = state->gp_regs;                                                              \
+            state->instret += BENCH_BLOCK_LEN;                                                    \
+            for (inst_type *inst = insts + block * BENCH_BLOCK_LEN, *end = inst + BENCH_BLOCK_LEN; \
+                 inst < end; inst++) {                                                            \
+                switch (inst->type) {                                                             \
+                    case inst_addi: r[inst->rd] = r[inst->rs1] + (i64) inst->imm; break;          \
+                    case inst_add:  r[inst->rd] = r[inst->rs1] + r[inst->rs2]; break;             \
+                    case inst_xor:  r[inst->rd] = r[inst->rs1] ^ r[inst->rs2]; break;             \
+                    case inst_slli: r[inst->rd] = r[inst->rs1] << (inst->imm & 0x3f); break;      \
+                    case inst_lui:  r[inst->rd] = (i64) inst->imm; break;                         \
+                    case inst_sltu: r[inst->rd] = r[inst->rs1] < r[inst->rs2]; break;             \
+                    case inst_bne:                                                                \
+                        state->pc += r[inst->rs1] != r[inst->rs2] ? (i64) inst->imm : 4;          \
+                        break;                                                                    \
+                    default: unreachable();                                                       \
+                }                                                                                 \
+            }                                                                                     \
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;                        \
+            block = (seed >> 33) & (blocks - 1);                                                  \
+        }                                                                                         \
+    }
+
+BENCH_DISPATCH(bench_dispatch_new, inst_t, state_t)
+BENCH_DISPATCH(bench_dispatch_old, old_inst_t, old_state_t)
+
+/**
+ * @brief fill the blocks of both layouts with the same random instructions
+ *
+ * @param new_insts instructions with the layout of rvemu.h
+ * @param old_insts instructions with the old layout
+ * @param count     instructions to fill
+ */
+static void bench_fill(inst_t *new_insts, old_inst_t *old_insts, u64 count) {
+    for (u64 i = 0; i < count; i++) {
+        enum inst_type_t type = bench_types[bench_rand() % (sizeof(bench_types) / sizeof(bench_types[0]))];
+        u8 rd = 1 + bench_rand() % (num_gp_regs - 1), rs1 = bench_rand() % num_gp_regs, rs2 = bench_rand() % num_gp_regs;
+        i32 imm = (i32) (bench_rand() % 4096) - 2048;
+        if (type == inst_lui) imm = (i32) ((u32) bench_rand() & ~0xfffU);
+        bool cont = i % BENCH_BLOCK_LEN == BENCH_BLOCK_LEN - 1;
+        if (cont) type = inst_bne, imm = (i32) (bench_rand() % 4096) * 2 - 4096;
+
+        new_insts[i] = (inst_t) {.type = type, .rd = rd, .rs1 = rs1, .rs2 = rs2, .imm = imm, .cont = cont};
+        old_insts[i] = (old_inst_t) {.type = type, .rd = rd, .rs1 = rs1, .rs2 = rs2, .imm = imm, .cont = cont};
+    }
+}
+
+// counters of a run, valid is false if the host does not provide them
+typedef struct {
+    f64 ns;
+    u64 cycles;
+    u64 insts;
+    u64 l1d_misses;
+    bool valid;
+} bench_result_t;
+
+static bool bench_counters(perf_t *perf, u64 values[3]) {
+    return perf_read(perf, perf_cycles, &values[0]) && perf_read(perf, perf_instructions, &values[1]) &&
+           perf_read(perf, perf_l1d_misses, &values[2]);
+}
+
+static void bench_print(const char *layout, u64 blocks, u64 bytes, bench_result_t *result) {
+    printf("%6lu blocks %8.1f KiB  %s: %.3f ns/inst", blocks, bytes / 1024.0, layout, result->ns / BENCH_INSTS);
+    if (result->valid) {
+        printf(", IPC %.2f, %.4f L1d misses/inst", (f64) result->insts / result->cycles,
+               (f64) result->l1d_misses / BENCH_INSTS);
+    } else {
+        printf(", counters unavailable");
+    }
+    printf("\n");
+}
+
+// run call and keep its counters in best if it is the fastest run so far
+#define BENCH_RUN(best, call)                                                                    \
+    do {                                                                                         \
+        u64 before[3], after[3];                                                                 \
+        struct timespec start, end;                                                              \
+        bench_result_t result;                                                                   \
+        result.valid = bench_counters(&perf, before);                                            \
+        clock_gettime(CLOCK_MONOTONIC, &start);                                                  \
+        call;                                                                                    \
+        clock_gettime(CLOCK_MONOTONIC, &end);                                                    \
+        result.valid = result.valid && bench_counters(&perf, after);                             \
+        result.ns = (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);           \
+        result.cycles = after[0] - before[0];                                                    \
+        result.insts = after[1] - before[1];                                                     \
+        result.l1d_misses = after[2] - before[2];                                                \
+        if (!(best).ns || result.ns < (best).ns) (best) = result;                                \
+    } while (0)
+
+int main() {
+    perf_t perf;
+    perf_open(&perf);
+
+    state_t *new_state = aligned_alloc(64, sizeof(state_t));
+    old_state_t *old_state = malloc(sizeof(old_state_t));
+    if (!new_state || !old_state) fatal("malloc failed.");
+
+    printf("inst_t %lu bytes (was %lu), state_t pc at offset %lu (was %lu)\n", sizeof(inst_t), sizeof(old_inst_t),
+           offsetof(state_t, pc), offsetof(old_state_t, pc));
+
+    // from blocks fitting the L1d with either layout to blocks fitting neither
+    for (u64 blocks = 16; blocks <= 16384; blocks *= 8) {
+        u64 count = blocks * BENCH_BLOCK_LEN;
+        inst_t *new_insts = malloc(count * sizeof(inst_t));
+        old_inst_t *old_insts = malloc(count * sizeof(old_inst_t));
+        if (!new_insts || !old_insts) fatal("malloc failed.");
+        bench_fill(new_insts, old_insts, count);
+
+        // interleaved, so that a slower period of the host hits both layouts
+        bench_result_t new_result = {0}, old_result = {0};
+        for (int run = 0; run < BENCH_RUNS; run++) {
+            memset(new_state, 0, sizeof(state_t));
+            memset(old_state, 0, sizeof(old_state_t));
+            BENCH_RUN(new_result, bench_dispatch_new(new_state, new_insts, blocks));
+            BENCH_RUN(old_result, bench_dispatch_old(old_state, old_insts, blocks));
+        }
+        if (memcmp(new_state->gp_regs, old_state->gp_regs, sizeof(old_state->gp_regs)) || new_state->pc != old_state->pc) {
+            fatal("the layouts computed different results");
+        }
+
+        bench_print("new", blocks, count * sizeof(inst_t), &new_result);
+        bench_print("old", blocks, count * sizeof(old_inst_t), &old_result);
+        printf("%6lu blocks  old/new time: %.2f\n", blocks, old_result.ns / new_result.ns);
+        free(new_insts);
+        free(old_insts);
+    }
+    free(new_state);
+    free(old_state);
+    return 0;
+}
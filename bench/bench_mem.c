@@ -0,0 +1,112 @@
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include "rvemu.h"
+
+/**
+ * Guest memory policy benchmark
+ *
+ * Grows the guest heap through mmu_alloc the way a guest malloc moves the
+ * break, touching each new page, then makes random accesses all over the
+ * heap, the TLB bound part of a large heap guest. Each memory policy runs in
+ * a child process with a fresh guest window, and prints the host page faults
+ * and the time of both phases.
+ *
+ *   bench_mem [heap MiB]
+ */
+
+#define BENCH_MEM_STEP      (1ULL << 20)    // bytes the break moves at a time
+#define BENCH_MEM_ACCESSES  (32ULL << 20)   // random accesses over the heap
+
+static const struct {
+    const char *name;
+    bool thp;
+    bool hugetlb;
+    bool populate;
+    bool bind;
+} policies[] = {
+    {"default", false, false, false, false},
+    {"populate", false, false, true, false},
+    {"thp", true, false, false, false},
+    {"thp+populate", true, false, true, false},
+    {"hugetlb", false, true, false, false},
+    {"numa-node 0", false, false, false, true},
+};
+
+static f64 bench_now() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+static u64 bench_faults() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_minflt + usage.ru_majflt;
+}
+
+/**
+ * @brief grow then access a heap of heap_size bytes with a memory policy
+ *
+ * @param i         index of the policy
+ * @param heap_size bytes of heap
+ */
+static void bench_run(int i, u64 heap_size) {
+    mmu_t mmu = {0};
+    mmu.thp = policies[i].thp;
+    mmu.hugetlb = policies[i].hugetlb;
+    mmu.populate = policies[i].populate;
+    mmu.nodes = policies[i].bind ? 1 : 0;
+    mmu_init(&mmu);
+    mmu.base = mmu.alloc = GUEST_PAGE_SIZE;
+    mmu.host_alloc = TO_HOST(&mmu, GUEST_PAGE_SIZE);
+
+    u64 faults = bench_faults();
+    f64 start = bench_now();
+    u64 heap = mmu.alloc;
+    for (u64 size = 0; size < heap_size; size += BENCH_MEM_STEP) {
+        u64 addr = mmu_alloc(&mmu, BENCH_MEM_STEP);
+        for (u64 page = 0; page < BENCH_MEM_STEP; page += GUEST_PAGE_SIZE) *(u64 *) TO_HOST(&mmu, addr + page) = page;
+    }
+    f64 grown = bench_now();
+    u64 grow_faults = bench_faults() - faults;
+
+    u64 x = 88172645463325252ULL, sum = 0;
+    for (u64 n = 0; n < BENCH_MEM_ACCESSES; n++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        u64 *p = (u64 *) TO_HOST(&mmu, heap + (x % heap_size & ~7ULL));
+        sum += *p;
+        *p = sum;
+    }
+    f64 accessed = bench_now();
+
+    printf("%-13s grow %7.1f ms, %7lu faults, %3lu mmap | random %7.1f ms, %5.1f ns per access%s\n",
+           policies[i].name, (grown - start) * 1e3, grow_faults, mmu.maps, (accessed - grown) * 1e3,
+           (accessed - grown) / BENCH_MEM_ACCESSES * 1e9,
+           mmu.huge_fallbacks ? " (no free huge pages, small pages used)" : "");
+    if (sum == 42) printf("\n");   // keep the accesses
+}
+
+int main(int argc, char **argv) {
+    if (argc > 2) {
+        fprintf(stderr, "usage: %s [heap MiB]\n", argv[0]);
+        return 1;
+    }
+    u64 heap_size = (argc == 2 ? strtoull(argv[1], NULL, 10) : 1024) << 20;
+    if (!heap_size || heap_size > GUEST_MMAP_BASE / 2) fatal("heap size out of range");
+
+    for (int i = 0; i < sizeof(policies) / sizeof(policies[0]); i++) {
+        fflush(stdout);
+        pid_t pid = fork();
+        if (pid < 0) fatal(strerror(errno));
+        if (pid == 0) {
+            bench_run(i, heap_size);
+            exit(0);
+        }
+        int status;
+        waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status)) printf("%-13s failed\n", policies[i].name);
+    }
+    return 0;
+}
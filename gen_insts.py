@@ -0,0 +1,217 @@
+#!/usr/bin/python3
+# Generate the instruction tables of the emulator from src/insts.spec
+#
+#   gen_insts.py src/insts.spec outdir
+#
+# writes outdir/inst_type_t.h, funcs.h, ops.h and decode_table.h
+
+import os
+import sys
+
+HEADER = "// Generated by gen_insts.py from {}, do not edit.\n"
+
+# First level of the decoder: the bits every encoding fixes.
+# 16 bits instructions are indexed by quadrant and funct3 (inst[15:13]),
+# 32 bits instructions by opcode (inst[6:2]) and funct3 (inst[14:12]).
+NUM_KEYS = 32 + 32 * 8
+# the second level indexes the encodings of a key by a window of their bits
+MAX_WINDOW = 8
+DECODE_KEY = """\
+#define DECODE_KEY(raw) (((raw) & 0x3) == 0x3 \\
+    ? 32 + ((((raw) >> 2) & 0x1F) << 3 | (((raw) >> 12) & 0x7)) \\
+    : (((raw) & 0x3) << 3 | (((raw) >> 13) & 0x7)))
+"""
+
+
+class Inst:
+
+    def __init__(self, name, comment):
+        self.name = name
+        self.comment = comment
+        self.rd = False
+
+
+class Encoding:
+
+    def __init__(self, inst, match, mask, fmt, cont, line):
+        self.inst = inst
+        self.match = match
+        self.mask = mask
+        self.fmt = fmt
+        self.cont = cont
+        self.line = line
+
+    def keys(self):
+        if self.match & 0x3 == 0x3:
+            if self.mask & 0x7F != 0x7F:
+                raise ValueError("opcode is not fixed")
+            base, shift = 32 + ((self.match >> 2) & 0x1F) * 8, 12
+        else:
+            if self.mask & 0x3 != 0x3:
+                raise ValueError("quadrant is not fixed")
+            base, shift = (self.match & 0x3) * 8, 13
+        fixed = (self.mask >> shift) & 0x7
+        value = (self.match >> shift) & 0x7
+        return [base + funct3 for funct3 in range(8) if funct3 & fixed == value]
+
+
+def parse(path):
+    insts, encodings, formats = {}, [], []
+    comment = None
+    with open(path) as spec:
+        for number, line in enumerate(spec, 1):
+            if line.startswith("## "):
+                comment = line[3:].strip()
+                continue
+            line = line.split("#")[0].strip()
+            if not line:
+                continue
+            try:
+                name, match, mask, fmt, flags = line.split()
+            except ValueError:
+                sys.exit("{}:{}: expected name, match, mask, format and flags".format(path, number))
+            flags = [] if flags == "-" else flags.split(",")
+            for flag in flags:
+                if flag not in ("rd", "cont"):
+                    sys.exit("{}:{}: unknown flag {}".format(path, number, flag))
+
+            if name not in insts:
+                insts[name] = Inst(name, comment)
+                comment = None
+            inst = insts[name]
+            inst.rd = inst.rd or "rd" in flags
+            if match == "-":
+                continue
+
+            encoding = Encoding(inst, int(match, 16), int(mask, 16), fmt, "cont" in flags, number)
+            if encoding.match & ~encoding.mask:
+                sys.exit("{}:{}: match has bits outside of the mask".format(path, number))
+            try:
+                encoding.keys()
+            except ValueError as error:
+                sys.exit("{}:{}: {}".format(path, number, error))
+            if fmt not in formats:
+                formats.append(fmt)
+            encodings.append(encoding)
+    return list(insts.values()), encodings, formats
+
+
+def split(bucket, fixed):
+    # pick the bits of the second level: the window of at most MAX_WINDOW
+    # bits leaving the fewest candidates per slot, the narrowest on ties
+    best = None
+    for width in range(MAX_WINDOW + 1):
+        for shift in range(32 - width) if width else [0]:
+            window = ((1 << width) - 1) << shift
+            if window & fixed:
+                continue
+            slots = []
+            for value in range(1 << width):
+                value <<= shift
+                slot = [encoding for encoding in bucket
+                        if encoding.match & window == value & encoding.mask]
+                slots.append(slot)
+            worst = max(len(slot) for slot in slots)
+            if best is None or worst < best[0]:
+                best = (worst, shift, width, slots)
+        if best[0] <= 1:
+            break
+    return best[1:]
+
+
+def build_tables(path, encodings):
+    buckets = [[] for _ in range(NUM_KEYS)]
+    for encoding in encodings:
+        for key in encoding.keys():
+            for other in buckets[key]:
+                if other.mask == encoding.mask and other.match == encoding.match:
+                    sys.exit("{}:{}: same encoding as line {}".format(path, encoding.line, other.line))
+            buckets[key].append(encoding)
+
+    # a slot holds its first candidate, the others are chained in the overflow
+    # list whose first element is unused, next == 0 ends the chain
+    keys, slots, overflow = [], [], [None]
+    for key, bucket in enumerate(buckets):
+        # most specific mask first, c.nop goes before c.addi
+        bucket.sort(key=lambda encoding: -bin(encoding.mask).count("1"))
+        fixed = 0x7F | 0x7000 if key >= 32 else 0x3 | 0xE000
+        shift, width, candidates = split(bucket, fixed)
+        keys.append((len(slots), shift, (1 << width) - 1))
+        for slot in candidates:
+            chain = []
+            for encoding in reversed(slot[1:]):
+                overflow.append((encoding, chain[-1] if chain else 0))
+                chain.append(len(overflow) - 1)
+            slots.append((slot[0] if slot else None, chain[-1] if chain else 0))
+    return keys, slots, overflow
+
+
+def write(outdir, name, text):
+    with open(os.path.join(outdir, name), "w") as out:
+        out.write(text)
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit("usage: gen_insts.py spec outdir")
+    path, outdir = sys.argv[1], sys.argv[2]
+    insts, encodings, formats = parse(path)
+    keys, slots, overflow = build_tables(path, encodings)
+    header = HEADER.format(os.path.basename(path))
+    os.makedirs(outdir, exist_ok=True)
+
+    lines = []
+    for inst in insts:
+        entry = "inst_{},".format(inst.name)
+        if inst.comment:
+            entry = "{:<16}// {}".format(entry, inst.comment)
+        lines.append(entry + "\n")
+    lines.append("{:<16}// Numbered Instructions\n".format("num_insts,"))
+    write(outdir, "inst_type_t.h", header + "".join(lines))
+
+    write(outdir, "funcs.h", header + "".join("exec_{},\n".format(inst.name) for inst in insts))
+
+    write(outdir, "ops.h", header
+          + "// instruction handlers in the form OP(name), expands to inst_##name / exec_##name\n"
+          + "".join("OP({})\n".format(inst.name) for inst in insts))
+
+    text = header + "\n"
+    text += "// operand formats, one field extractor each\n"
+    text += "typedef enum {\n" + "".join("    fmt_{},\n".format(fmt) for fmt in formats)
+    text += "    num_formats,\n} inst_format_t;\n\n"
+    text += "// an encoding and the next candidate of its slot in decode_overflow,\n"
+    text += "// inst holds the fields known from the encoding: type, rvc and cont\n"
+    text += "typedef struct {\n    u32 mask;\n    u32 match;\n    inst_t inst;\n    u8 format;\n    u16 next;\n} decode_entry_t;\n\n"
+    text += "// second level of a key, decode_slots[base + ((raw >> shift) & mask)]\n"
+    text += "typedef struct {\n    u16 base;\n    u8 shift;\n    u8 mask;\n} decode_key_t;\n\n"
+    text += "// first level of the decoder, the bits every encoding fixes\n"
+    text += DECODE_KEY + "\n"
+    text += "static const decode_key_t decode_keys[{}] = {{\n".format(NUM_KEYS)
+    for base, shift, mask in keys:
+        text += "    {{{}, {}, 0x{:x}}},\n".format(base, shift, mask)
+    text += "};\n\n"
+
+    def entry(encoding, next):
+        if encoding is None:
+            # matches nothing, an invalid instruction
+            return "    {0x00000000, 0x00000001, {0}, 0, 0},\n"
+        return "    {{0x{:08x}, 0x{:08x}, {{.type = inst_{}, .rvc = {}, .cont = {}}}, fmt_{}, {}}},\n".format(
+            encoding.mask, encoding.match, encoding.inst.name,
+            "false" if encoding.match & 0x3 == 0x3 else "true",
+            "true" if encoding.cont else "false", encoding.fmt, next)
+
+    text += "static const decode_entry_t decode_slots[{}] = {{\n".format(len(slots))
+    text += "".join(entry(encoding, next) for encoding, next in slots)
+    text += "};\n\n"
+    text += "static const decode_entry_t decode_overflow[{}] = {{\n".format(len(overflow))
+    text += "".join(entry(*candidate) if candidate else entry(None, 0) for candidate in overflow)
+    text += "};\n\n"
+    text += "// instructions writing the integer register rd\n"
+    text += "static const bool writes_rd[num_insts] = {\n"
+    text += "".join("    [inst_{}] = true,\n".format(inst.name) for inst in insts if inst.rd)
+    text += "};\n"
+    write(outdir, "decode_table.h", text)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,1839 @@
+// Generated by gen_insts.py from insts.spec, do not edit.
+
+// operand formats, one field extractor each
+typedef enum {
+    fmt_u,
+    fmt_j,
+    fmt_i,
+    fmt_b,
+    fmt_s,
+    fmt_r,
+    fmt_none,
+    fmt_csr,
+    fmt_ci_lwsp,
+    fmt_ci_ldsp,
+    fmt_css_w,
+    fmt_css_d,
+    fmt_cl_w,
+    fmt_cl_d,
+    fmt_cs_w,
+    fmt_cs_d,
+    fmt_cj,
+    fmt_cr,
+    fmt_cb,
+    fmt_ci,
+    fmt_ci_lui,
+    fmt_ci_16sp,
+    fmt_ciw,
+    fmt_ci_sh,
+    fmt_cb_sh,
+    fmt_cb_imm,
+    fmt_ca,
+    fmt_r4,
+    num_formats,
+} inst_format_t;
+
+// an encoding and the next candidate of its slot in decode_overflow,
+// inst holds the fields known from the encoding: type, rvc and cont
+typedef struct {
+    u32 mask;
+    u32 match;
+    inst_t inst;
+    u8 format;
+    u16 next;
+} decode_entry_t;
+
+// second level of a key, decode_slots[base + ((raw >> shift) & mask)]
+typedef struct {
+    u16 base;
+    u8 shift;
+    u8 mask;
+} decode_key_t;
+
+// first level of the decoder, the bits every encoding fixes
+#define DECODE_KEY(raw) (((raw) & 0x3) == 0x3 \
+    ? 32 + ((((raw) >> 2) & 0x1F) << 3 | (((raw) >> 12) & 0x7)) \
+    : (((raw) & 0x3) << 3 | (((raw) >> 13) & 0x7)))
+
+static const decode_key_t decode_keys[288] = {
+    {0, 0, 0x0},
+    {1, 0, 0x0},
+    {2, 0, 0x0},
+    {3, 0, 0x0},
+    {4, 0, 0x0},
+    {5, 0, 0x0},
+    {6, 0, 0x0},
+    {7, 0, 0x0},
+    {8, 0, 0x0},
+    {9, 0, 0x0},
+    {10, 0, 0x0},
+    {11, 0, 0x0},
+    {12, 5, 0xff},
+    {268, 0, 0x0},
+    {269, 0, 0x0},
+    {270, 0, 0x0},
+    {271, 0, 0x0},
+    {272, 0, 0x0},
+    {273, 0, 0x0},
+    {274, 0, 0x0},
+    {275, 12, 0x1},
+    {277, 0, 0x0},
+    {278, 0, 0x0},
+    {279, 0, 0x0},
+    {280, 0, 0x0},
+    {281, 0, 0x0},
+    {282, 0, 0x0},
+    {283, 0, 0x0},
+    {284, 0, 0x0},
+    {285, 0, 0x0},
+    {286, 0, 0x0},
+    {287, 0, 0x0},
+    {288, 0, 0x0},
+    {289, 0, 0x0},
+    {290, 0, 0x0},
+    {291, 0, 0x0},
+    {292, 0, 0x0},
+    {293, 0, 0x0},
+    {294, 0, 0x0},
+    {295, 0, 0x0},
+    {296, 0, 0x0},
+    {297, 0, 0x0},
+    {298, 0, 0x0},
+    {299, 0, 0x0},
+    {300, 0, 0x0},
+    {301, 0, 0x0},
+    {302, 0, 0x0},
+    {303, 0, 0x0},
+    {304, 0, 0x0},
+    {305, 0, 0x0},
+    {306, 0, 0x0},
+    {307, 0, 0x0},
+    {308, 0, 0x0},
+    {309, 0, 0x0},
+    {310, 0, 0x0},
+    {311, 0, 0x0},
+    {312, 0, 0x0},
+    {313, 0, 0x0},
+    {314, 0, 0x0},
+    {315, 0, 0x0},
+    {316, 0, 0x0},
+    {317, 0, 0x0},
+    {318, 0, 0x0},
+    {319, 0, 0x0},
+    {320, 0, 0x0},
+    {321, 0, 0x0},
+    {322, 0, 0x0},
+    {323, 0, 0x0},
+    {324, 0, 0x0},
+    {325, 30, 0x1},
+    {327, 0, 0x0},
+    {328, 0, 0x0},
+    {329, 0, 0x0},
+    {330, 0, 0x0},
+    {331, 0, 0x0},
+    {332, 0, 0x0},
+    {333, 0, 0x0},
+    {334, 0, 0x0},
+    {335, 0, 0x0},
+    {336, 0, 0x0},
+    {337, 0, 0x0},
+    {338, 0, 0x0},
+    {339, 0, 0x0},
+    {340, 0, 0x0},
+    {341, 0, 0x0},
+    {342, 30, 0x1},
+    {344, 0, 0x0},
+    {345, 0, 0x0},
+    {346, 0, 0x0},
+    {347, 0, 0x0},
+    {348, 0, 0x0},
+    {349, 0, 0x0},
+    {350, 0, 0x0},
+    {351, 0, 0x0},
+    {352, 0, 0x0},
+    {353, 0, 0x0},
+    {354, 0, 0x0},
+    {355, 0, 0x0},
+    {356, 0, 0x0},
+    {357, 0, 0x0},
+    {358, 0, 0x0},
+    {359, 0, 0x0},
+    {360, 0, 0x0},
+    {361, 0, 0x0},
+    {362, 0, 0x0},
+    {363, 0, 0x0},
+    {364, 0, 0x0},
+    {365, 0, 0x0},
+    {366, 0, 0x0},
+    {367, 0, 0x0},
+    {368, 0, 0x0},
+    {369, 0, 0x0},
+    {370, 0, 0x0},
+    {371, 0, 0x0},
+    {372, 0, 0x0},
+    {373, 0, 0x0},
+    {374, 0, 0x0},
+    {375, 0, 0x0},
+    {376, 0, 0x0},
+    {377, 0, 0x0},
+    {378, 0, 0x0},
+    {379, 0, 0x0},
+    {380, 0, 0x0},
+    {381, 0, 0x0},
+    {382, 0, 0x0},
+    {383, 0, 0x0},
+    {384, 0, 0x0},
+    {385, 0, 0x0},
+    {386, 25, 0x3f},
+    {450, 25, 0x1},
+    {452, 25, 0x1},
+    {454, 25, 0x1},
+    {456, 25, 0x1},
+    {458, 25, 0x3f},
+    {522, 25, 0x1},
+    {524, 25, 0x1},
+    {526, 0, 0x0},
+    {527, 0, 0x0},
+    {528, 0, 0x0},
+    {529, 0, 0x0},
+    {530, 0, 0x0},
+    {531, 0, 0x0},
+    {532, 0, 0x0},
+    {533, 0, 0x0},
+    {534, 25, 0x3f},
+    {598, 0, 0x0},
+    {599, 0, 0x0},
+    {600, 0, 0x0},
+    {601, 0, 0x0},
+    {602, 25, 0x3f},
+    {666, 0, 0x0},
+    {667, 0, 0x0},
+    {668, 0, 0x0},
+    {669, 0, 0x0},
+    {670, 0, 0x0},
+    {671, 0, 0x0},
+    {672, 0, 0x0},
+    {673, 0, 0x0},
+    {674, 0, 0x0},
+    {675, 0, 0x0},
+    {676, 25, 0x1},
+    {678, 25, 0x1},
+    {680, 25, 0x1},
+    {682, 25, 0x1},
+    {684, 25, 0x1},
+    {686, 25, 0x1},
+    {688, 25, 0x1},
+    {690, 25, 0x1},
+    {692, 25, 0x1},
+    {694, 25, 0x1},
+    {696, 25, 0x1},
+    {698, 25, 0x1},
+    {700, 25, 0x1},
+    {702, 25, 0x1},
+    {704, 25, 0x1},
+    {706, 25, 0x1},
+    {708, 25, 0x1},
+    {710, 25, 0x1},
+    {712, 25, 0x1},
+    {714, 25, 0x1},
+    {716, 25, 0x1},
+    {718, 25, 0x1},
+    {720, 25, 0x1},
+    {722, 25, 0x1},
+    {724, 25, 0x1},
+    {726, 25, 0x1},
+    {728, 25, 0x1},
+    {730, 25, 0x1},
+    {732, 25, 0x1},
+    {734, 25, 0x1},
+    {736, 25, 0x1},
+    {738, 25, 0x1},
+    {740, 25, 0x3f},
+    {804, 25, 0x3f},
+    {868, 25, 0x3f},
+    {932, 25, 0x3f},
+    {996, 25, 0x3f},
+    {1060, 25, 0x3f},
+    {1124, 25, 0x3f},
+    {1188, 25, 0x3f},
+    {1252, 0, 0x0},
+    {1253, 0, 0x0},
+    {1254, 0, 0x0},
+    {1255, 0, 0x0},
+    {1256, 0, 0x0},
+    {1257, 0, 0x0},
+    {1258, 0, 0x0},
+    {1259, 0, 0x0},
+    {1260, 0, 0x0},
+    {1261, 0, 0x0},
+    {1262, 0, 0x0},
+    {1263, 0, 0x0},
+    {1264, 0, 0x0},
+    {1265, 0, 0x0},
+    {1266, 0, 0x0},
+    {1267, 0, 0x0},
+    {1268, 0, 0x0},
+    {1269, 0, 0x0},
+    {1270, 0, 0x0},
+    {1271, 0, 0x0},
+    {1272, 0, 0x0},
+    {1273, 0, 0x0},
+    {1274, 0, 0x0},
+    {1275, 0, 0x0},
+    {1276, 0, 0x0},
+    {1277, 0, 0x0},
+    {1278, 0, 0x0},
+    {1279, 0, 0x0},
+    {1280, 0, 0x0},
+    {1281, 0, 0x0},
+    {1282, 0, 0x0},
+    {1283, 0, 0x0},
+    {1284, 0, 0x0},
+    {1285, 0, 0x0},
+    {1286, 0, 0x0},
+    {1287, 0, 0x0},
+    {1288, 0, 0x0},
+    {1289, 0, 0x0},
+    {1290, 0, 0x0},
+    {1291, 0, 0x0},
+    {1292, 0, 0x0},
+    {1293, 0, 0x0},
+    {1294, 0, 0x0},
+    {1295, 0, 0x0},
+    {1296, 0, 0x0},
+    {1297, 0, 0x0},
+    {1298, 0, 0x0},
+    {1299, 0, 0x0},
+    {1300, 0, 0x0},
+    {1301, 0, 0x0},
+    {1302, 0, 0x0},
+    {1303, 0, 0x0},
+    {1304, 0, 0x0},
+    {1305, 0, 0x0},
+    {1306, 0, 0x0},
+    {1307, 0, 0x0},
+    {1308, 20, 0x3f},
+    {1372, 0, 0x0},
+    {1373, 0, 0x0},
+    {1374, 0, 0x0},
+    {1375, 0, 0x0},
+    {1376, 0, 0x0},
+    {1377, 0, 0x0},
+    {1378, 0, 0x0},
+    {1379, 0, 0x0},
+    {1380, 0, 0x0},
+    {1381, 0, 0x0},
+    {1382, 0, 0x0},
+    {1383, 0, 0x0},
+    {1384, 0, 0x0},
+    {1385, 0, 0x0},
+    {1386, 0, 0x0},
+    {1387, 0, 0x0},
+    {1388, 0, 0x0},
+    {1389, 0, 0x0},
+    {1390, 0, 0x0},
+    {1391, 0, 0x0},
+    {1392, 0, 0x0},
+    {1393, 0, 0x0},
+    {1394, 0, 0x0},
+    {1395, 0, 0x0},
+    {1396, 0, 0x0},
+    {1397, 0, 0x0},
+    {1398, 0, 0x0},
+    {1399, 0, 0x0},
+    {1400, 0, 0x0},
+    {1401, 0, 0x0},
+    {1402, 0, 0x0},
+};
+
+static const decode_entry_t decode_slots[1403] = {
+    {0x0000e003, 0x00000000, {.type = inst_caddi4spn, .rvc = true, .cont = false}, fmt_ciw, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x0000e003, 0x00004000, {.type = inst_clw, .rvc = true, .cont = false}, fmt_cl_w, 0},
+    {0x0000e003, 0x00006000, {.type = inst_cld, .rvc = true, .cont = false}, fmt_cl_d, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x0000e003, 0x0000c000, {.type = inst_csw, .rvc = true, .cont = false}, fmt_cs_w, 0},
+    {0x0000e003, 0x0000e000, {.type = inst_csd, .rvc = true, .cont = false}, fmt_cs_d, 0},
+    {0x0000ef83, 0x00000001, {.type = inst_cnop, .rvc = true, .cont = false}, fmt_none, 1},
+    {0x0000e003, 0x00002001, {.type = inst_caddiw, .rvc = true, .cont = false}, fmt_ci, 0},
+    {0x0000e003, 0x00004001, {.type = inst_cli, .rvc = true, .cont = false}, fmt_ci, 0},
+    {0x0000ef83, 0x00006101, {.type = inst_caddi16sp, .rvc = true, .cont = false}, fmt_ci_16sp, 2},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000fc63, 0x00008c01, {.type = inst_csub, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x0000fc63, 0x00008c21, {.type = inst_cxor, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x0000fc63, 0x00008c41, {.type = inst_cor, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x0000fc63, 0x00008c61, {.type = inst_cand, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x0000fc63, 0x00008c01, {.type = inst_csub, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x0000fc63, 0x00008c21, {.type = inst_cxor, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x0000fc63, 0x00008c41, {.type = inst_cor, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x0000fc63, 0x00008c61, {.type = inst_cand, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x0000fc63, 0x00008c01, {.type = inst_csub, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x0000fc63, 0x00008c21, {.type = inst_cxor, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x0000fc63, 0x00008c41, {.type = inst_cor, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x0000fc63, 0x00008c61, {.type = inst_cand, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x0000fc63, 0x00008c01, {.type = inst_csub, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x0000fc63, 0x00008c21, {.type = inst_cxor, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x0000fc63, 0x00008c41, {.type = inst_cor, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x0000fc63, 0x00008c61, {.type = inst_cand, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x0000fc63, 0x00008c01, {.type = inst_csub, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x0000fc63, 0x00008c21, {.type = inst_cxor, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x0000fc63, 0x00008c41, {.type = inst_cor, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x0000fc63, 0x00008c61, {.type = inst_cand, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x0000fc63, 0x00008c01, {.type = inst_csub, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x0000fc63, 0x00008c21, {.type = inst_cxor, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x0000fc63, 0x00008c41, {.type = inst_cor, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x0000fc63, 0x00008c61, {.type = inst_cand, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x0000fc63, 0x00008c01, {.type = inst_csub, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x0000fc63, 0x00008c21, {.type = inst_cxor, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x0000fc63, 0x00008c41, {.type = inst_cor, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x0000fc63, 0x00008c61, {.type = inst_cand, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x0000fc63, 0x00008c01, {.type = inst_csub, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x0000fc63, 0x00008c21, {.type = inst_cxor, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x0000fc63, 0x00008c41, {.type = inst_cor, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x0000fc63, 0x00008c61, {.type = inst_cand, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008001, {.type = inst_csrli, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008401, {.type = inst_csrai, .rvc = true, .cont = false}, fmt_cb_sh, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000ec03, 0x00008801, {.type = inst_candi, .rvc = true, .cont = false}, fmt_cb_imm, 0},
+    {0x0000fc63, 0x00009c01, {.type = inst_csubw, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x0000fc63, 0x00009c21, {.type = inst_caddw, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x0000fc63, 0x00009c01, {.type = inst_csubw, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x0000fc63, 0x00009c21, {.type = inst_caddw, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x0000fc63, 0x00009c01, {.type = inst_csubw, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x0000fc63, 0x00009c21, {.type = inst_caddw, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x0000fc63, 0x00009c01, {.type = inst_csubw, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x0000fc63, 0x00009c21, {.type = inst_caddw, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x0000fc63, 0x00009c01, {.type = inst_csubw, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x0000fc63, 0x00009c21, {.type = inst_caddw, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x0000fc63, 0x00009c01, {.type = inst_csubw, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x0000fc63, 0x00009c21, {.type = inst_caddw, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x0000fc63, 0x00009c01, {.type = inst_csubw, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x0000fc63, 0x00009c21, {.type = inst_caddw, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x0000fc63, 0x00009c01, {.type = inst_csubw, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x0000fc63, 0x00009c21, {.type = inst_caddw, .rvc = true, .cont = false}, fmt_ca, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x0000e003, 0x0000a001, {.type = inst_cj, .rvc = true, .cont = true}, fmt_cj, 0},
+    {0x0000e003, 0x0000c001, {.type = inst_cbeqz, .rvc = true, .cont = true}, fmt_cb, 0},
+    {0x0000e003, 0x0000e001, {.type = inst_cbnez, .rvc = true, .cont = true}, fmt_cb, 0},
+    {0x0000e003, 0x00000002, {.type = inst_cslli, .rvc = true, .cont = false}, fmt_ci_sh, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x0000e003, 0x00004002, {.type = inst_clwsp, .rvc = true, .cont = false}, fmt_ci_lwsp, 0},
+    {0x0000e003, 0x00006002, {.type = inst_cldsp, .rvc = true, .cont = false}, fmt_ci_ldsp, 0},
+    {0x0000f07f, 0x00008002, {.type = inst_cjr, .rvc = true, .cont = true}, fmt_cr, 3},
+    {0x0000ffff, 0x00009002, {.type = inst_ebreak, .rvc = true, .cont = true}, fmt_none, 5},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x0000e003, 0x0000c002, {.type = inst_cswsp, .rvc = true, .cont = false}, fmt_css_w, 0},
+    {0x0000e003, 0x0000e002, {.type = inst_csdsp, .rvc = true, .cont = false}, fmt_css_d, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x0000707f, 0x00000003, {.type = inst_lb, .rvc = false, .cont = false}, fmt_i, 0},
+    {0x0000707f, 0x00001003, {.type = inst_lh, .rvc = false, .cont = false}, fmt_i, 0},
+    {0x0000707f, 0x00002003, {.type = inst_lw, .rvc = false, .cont = false}, fmt_i, 0},
+    {0x0000707f, 0x00003003, {.type = inst_ld, .rvc = false, .cont = false}, fmt_i, 0},
+    {0x0000707f, 0x00004003, {.type = inst_lbu, .rvc = false, .cont = false}, fmt_i, 0},
+    {0x0000707f, 0x00005003, {.type = inst_lhu, .rvc = false, .cont = false}, fmt_i, 0},
+    {0x0000707f, 0x00006003, {.type = inst_lwu, .rvc = false, .cont = false}, fmt_i, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x0000707f, 0x00002007, {.type = inst_flw, .rvc = false, .cont = false}, fmt_i, 0},
+    {0x0000707f, 0x00003007, {.type = inst_fld, .rvc = false, .cont = false}, fmt_i, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x0000707f, 0x0000000f, {.type = inst_fence, .rvc = false, .cont = false}, fmt_none, 0},
+    {0x0000707f, 0x0000100f, {.type = inst_fence_i, .rvc = false, .cont = true}, fmt_none, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x0000707f, 0x00000013, {.type = inst_addi, .rvc = false, .cont = false}, fmt_i, 0},
+    {0xfc00707f, 0x00001013, {.type = inst_slli, .rvc = false, .cont = false}, fmt_i, 0},
+    {0x0000707f, 0x00002013, {.type = inst_slti, .rvc = false, .cont = false}, fmt_i, 0},
+    {0x0000707f, 0x00003013, {.type = inst_sltiu, .rvc = false, .cont = false}, fmt_i, 0},
+    {0x0000707f, 0x00004013, {.type = inst_xori, .rvc = false, .cont = false}, fmt_i, 0},
+    {0xfc00707f, 0x00005013, {.type = inst_srli, .rvc = false, .cont = false}, fmt_i, 0},
+    {0xfc00707f, 0x40005013, {.type = inst_srai, .rvc = false, .cont = false}, fmt_i, 0},
+    {0x0000707f, 0x00006013, {.type = inst_ori, .rvc = false, .cont = false}, fmt_i, 0},
+    {0x0000707f, 0x00007013, {.type = inst_andi, .rvc = false, .cont = false}, fmt_i, 0},
+    {0x0000007f, 0x00000017, {.type = inst_auipc, .rvc = false, .cont = false}, fmt_u, 0},
+    {0x0000007f, 0x00000017, {.type = inst_auipc, .rvc = false, .cont = false}, fmt_u, 0},
+    {0x0000007f, 0x00000017, {.type = inst_auipc, .rvc = false, .cont = false}, fmt_u, 0},
+    {0x0000007f, 0x00000017, {.type = inst_auipc, .rvc = false, .cont = false}, fmt_u, 0},
+    {0x0000007f, 0x00000017, {.type = inst_auipc, .rvc = false, .cont = false}, fmt_u, 0},
+    {0x0000007f, 0x00000017, {.type = inst_auipc, .rvc = false, .cont = false}, fmt_u, 0},
+    {0x0000007f, 0x00000017, {.type = inst_auipc, .rvc = false, .cont = false}, fmt_u, 0},
+    {0x0000007f, 0x00000017, {.type = inst_auipc, .rvc = false, .cont = false}, fmt_u, 0},
+    {0x0000707f, 0x0000001b, {.type = inst_addiw, .rvc = false, .cont = false}, fmt_i, 0},
+    {0xfe00707f, 0x0000101b, {.type = inst_slliw, .rvc = false, .cont = false}, fmt_i, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00707f, 0x0000501b, {.type = inst_srliw, .rvc = false, .cont = false}, fmt_i, 0},
+    {0xfe00707f, 0x4000501b, {.type = inst_sraiw, .rvc = false, .cont = false}, fmt_i, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x0000707f, 0x00000023, {.type = inst_sb, .rvc = false, .cont = false}, fmt_s, 0},
+    {0x0000707f, 0x00001023, {.type = inst_sh, .rvc = false, .cont = false}, fmt_s, 0},
+    {0x0000707f, 0x00002023, {.type = inst_sw, .rvc = false, .cont = false}, fmt_s, 0},
+    {0x0000707f, 0x00003023, {.type = inst_sd, .rvc = false, .cont = false}, fmt_s, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x0000707f, 0x00002027, {.type = inst_fsw, .rvc = false, .cont = false}, fmt_s, 0},
+    {0x0000707f, 0x00003027, {.type = inst_fsd, .rvc = false, .cont = false}, fmt_s, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00707f, 0x00000033, {.type = inst_add, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00707f, 0x02000033, {.type = inst_mul, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00707f, 0x40000033, {.type = inst_sub, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00707f, 0x00001033, {.type = inst_sll, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00707f, 0x02001033, {.type = inst_mulh, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00707f, 0x00002033, {.type = inst_slt, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00707f, 0x02002033, {.type = inst_mulhsu, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00707f, 0x00003033, {.type = inst_sltu, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00707f, 0x02003033, {.type = inst_mulhu, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00707f, 0x00004033, {.type = inst_xor, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00707f, 0x02004033, {.type = inst_div, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00707f, 0x00005033, {.type = inst_srl, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00707f, 0x02005033, {.type = inst_divu, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00707f, 0x40005033, {.type = inst_sra, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00707f, 0x00006033, {.type = inst_or, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00707f, 0x02006033, {.type = inst_rem, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00707f, 0x00007033, {.type = inst_and, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00707f, 0x02007033, {.type = inst_remu, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x0000007f, 0x00000037, {.type = inst_lui, .rvc = false, .cont = false}, fmt_u, 0},
+    {0x0000007f, 0x00000037, {.type = inst_lui, .rvc = false, .cont = false}, fmt_u, 0},
+    {0x0000007f, 0x00000037, {.type = inst_lui, .rvc = false, .cont = false}, fmt_u, 0},
+    {0x0000007f, 0x00000037, {.type = inst_lui, .rvc = false, .cont = false}, fmt_u, 0},
+    {0x0000007f, 0x00000037, {.type = inst_lui, .rvc = false, .cont = false}, fmt_u, 0},
+    {0x0000007f, 0x00000037, {.type = inst_lui, .rvc = false, .cont = false}, fmt_u, 0},
+    {0x0000007f, 0x00000037, {.type = inst_lui, .rvc = false, .cont = false}, fmt_u, 0},
+    {0x0000007f, 0x00000037, {.type = inst_lui, .rvc = false, .cont = false}, fmt_u, 0},
+    {0xfe00707f, 0x0000003b, {.type = inst_addw, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00707f, 0x0200003b, {.type = inst_mulw, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00707f, 0x4000003b, {.type = inst_subw, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00707f, 0x0000103b, {.type = inst_sllw, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00707f, 0x0200403b, {.type = inst_divw, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00707f, 0x0000503b, {.type = inst_srlw, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00707f, 0x0200503b, {.type = inst_divuw, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00707f, 0x4000503b, {.type = inst_sraw, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00707f, 0x0200603b, {.type = inst_remw, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00707f, 0x0200703b, {.type = inst_remuw, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x0600007f, 0x00000043, {.type = inst_fmadd_s, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x02000043, {.type = inst_fmadd_d, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x00000043, {.type = inst_fmadd_s, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x02000043, {.type = inst_fmadd_d, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x00000043, {.type = inst_fmadd_s, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x02000043, {.type = inst_fmadd_d, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x00000043, {.type = inst_fmadd_s, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x02000043, {.type = inst_fmadd_d, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x00000043, {.type = inst_fmadd_s, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x02000043, {.type = inst_fmadd_d, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x00000043, {.type = inst_fmadd_s, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x02000043, {.type = inst_fmadd_d, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x00000043, {.type = inst_fmadd_s, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x02000043, {.type = inst_fmadd_d, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x00000043, {.type = inst_fmadd_s, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x02000043, {.type = inst_fmadd_d, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x00000047, {.type = inst_fmsub_s, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x02000047, {.type = inst_fmsub_d, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x00000047, {.type = inst_fmsub_s, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x02000047, {.type = inst_fmsub_d, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x00000047, {.type = inst_fmsub_s, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x02000047, {.type = inst_fmsub_d, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x00000047, {.type = inst_fmsub_s, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x02000047, {.type = inst_fmsub_d, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x00000047, {.type = inst_fmsub_s, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x02000047, {.type = inst_fmsub_d, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x00000047, {.type = inst_fmsub_s, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x02000047, {.type = inst_fmsub_d, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x00000047, {.type = inst_fmsub_s, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x02000047, {.type = inst_fmsub_d, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x00000047, {.type = inst_fmsub_s, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x02000047, {.type = inst_fmsub_d, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x0000004b, {.type = inst_fnmsub_s, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x0200004b, {.type = inst_fnmsub_d, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x0000004b, {.type = inst_fnmsub_s, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x0200004b, {.type = inst_fnmsub_d, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x0000004b, {.type = inst_fnmsub_s, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x0200004b, {.type = inst_fnmsub_d, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x0000004b, {.type = inst_fnmsub_s, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x0200004b, {.type = inst_fnmsub_d, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x0000004b, {.type = inst_fnmsub_s, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x0200004b, {.type = inst_fnmsub_d, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x0000004b, {.type = inst_fnmsub_s, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x0200004b, {.type = inst_fnmsub_d, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x0000004b, {.type = inst_fnmsub_s, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x0200004b, {.type = inst_fnmsub_d, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x0000004b, {.type = inst_fnmsub_s, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x0200004b, {.type = inst_fnmsub_d, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x0000004f, {.type = inst_fnmadd_s, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x0200004f, {.type = inst_fnmadd_d, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x0000004f, {.type = inst_fnmadd_s, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x0200004f, {.type = inst_fnmadd_d, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x0000004f, {.type = inst_fnmadd_s, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x0200004f, {.type = inst_fnmadd_d, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x0000004f, {.type = inst_fnmadd_s, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x0200004f, {.type = inst_fnmadd_d, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x0000004f, {.type = inst_fnmadd_s, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x0200004f, {.type = inst_fnmadd_d, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x0000004f, {.type = inst_fnmadd_s, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x0200004f, {.type = inst_fnmadd_d, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x0000004f, {.type = inst_fnmadd_s, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x0200004f, {.type = inst_fnmadd_d, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x0000004f, {.type = inst_fnmadd_s, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0x0600007f, 0x0200004f, {.type = inst_fnmadd_d, .rvc = false, .cont = false}, fmt_r4, 0},
+    {0xfe00007f, 0x00000053, {.type = inst_fadd_s, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00007f, 0x02000053, {.type = inst_fadd_d, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00007f, 0x08000053, {.type = inst_fsub_s, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00007f, 0x0a000053, {.type = inst_fsub_d, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00007f, 0x10000053, {.type = inst_fmul_s, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00007f, 0x12000053, {.type = inst_fmul_d, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00007f, 0x18000053, {.type = inst_fdiv_s, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00007f, 0x1a000053, {.type = inst_fdiv_d, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00707f, 0x28000053, {.type = inst_fmin_s, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00707f, 0x2a000053, {.type = inst_fmin_d, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfff0007f, 0x58000053, {.type = inst_fsqrt_s, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfff0007f, 0x5a000053, {.type = inst_fsqrt_d, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00007f, 0x00000053, {.type = inst_fadd_s, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00007f, 0x02000053, {.type = inst_fadd_d, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00007f, 0x08000053, {.type = inst_fsub_s, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00007f, 0x0a000053, {.type = inst_fsub_d, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00007f, 0x10000053, {.type = inst_fmul_s, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00007f, 0x12000053, {.type = inst_fmul_d, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00007f, 0x18000053, {.type = inst_fdiv_s, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00007f, 0x1a000053, {.type = inst_fdiv_d, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00707f, 0x28001053, {.type = inst_fmax_s, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00707f, 0x2a001053, {.type = inst_fmax_d, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfff0007f, 0x58000053, {.type = inst_fsqrt_s, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfff0007f, 0x5a000053, {.type = inst_fsqrt_d, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00007f, 0x00000053, {.type = inst_fadd_s, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00007f, 0x02000053, {.type = inst_fadd_d, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00007f, 0x08000053, {.type = inst_fsub_s, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00007f, 0x0a000053, {.type = inst_fsub_d, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00007f, 0x10000053, {.type = inst_fmul_s, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00007f, 0x12000053, {.type = inst_fmul_d, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00007f, 0x18000053, {.type = inst_fdiv_s, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00007f, 0x1a000053, {.type = inst_fdiv_d, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfff0007f, 0x58000053, {.type = inst_fsqrt_s, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfff0007f, 0x5a000053, {.type = inst_fsqrt_d, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00007f, 0x00000053, {.type = inst_fadd_s, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00007f, 0x02000053, {.type = inst_fadd_d, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00007f, 0x08000053, {.type = inst_fsub_s, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00007f, 0x0a000053, {.type = inst_fsub_d, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00007f, 0x10000053, {.type = inst_fmul_s, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00007f, 0x12000053, {.type = inst_fmul_d, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00007f, 0x18000053, {.type = inst_fdiv_s, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00007f, 0x1a000053, {.type = inst_fdiv_d, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfff0007f, 0x58000053, {.type = inst_fsqrt_s, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfff0007f, 0x5a000053, {.type = inst_fsqrt_d, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00007f, 0x00000053, {.type = inst_fadd_s, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00007f, 0x02000053, {.type = inst_fadd_d, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00007f, 0x08000053, {.type = inst_fsub_s, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00007f, 0x0a000053, {.type = inst_fsub_d, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00007f, 0x10000053, {.type = inst_fmul_s, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00007f, 0x12000053, {.type = inst_fmul_d, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00007f, 0x18000053, {.type = inst_fdiv_s, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00007f, 0x1a000053, {.type = inst_fdiv_d, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfff0007f, 0x58000053, {.type = inst_fsqrt_s, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfff0007f, 0x5a000053, {.type = inst_fsqrt_d, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00007f, 0x00000053, {.type = inst_fadd_s, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00007f, 0x02000053, {.type = inst_fadd_d, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00007f, 0x08000053, {.type = inst_fsub_s, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00007f, 0x0a000053, {.type = inst_fsub_d, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00007f, 0x10000053, {.type = inst_fmul_s, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00007f, 0x12000053, {.type = inst_fmul_d, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00007f, 0x18000053, {.type = inst_fdiv_s, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00007f, 0x1a000053, {.type = inst_fdiv_d, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfff0007f, 0x58000053, {.type = inst_fsqrt_s, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfff0007f, 0x5a000053, {.type = inst_fsqrt_d, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00007f, 0x00000053, {.type = inst_fadd_s, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00007f, 0x02000053, {.type = inst_fadd_d, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00007f, 0x08000053, {.type = inst_fsub_s, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00007f, 0x0a000053, {.type = inst_fsub_d, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00007f, 0x10000053, {.type = inst_fmul_s, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00007f, 0x12000053, {.type = inst_fmul_d, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00007f, 0x18000053, {.type = inst_fdiv_s, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00007f, 0x1a000053, {.type = inst_fdiv_d, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfff0007f, 0x58000053, {.type = inst_fsqrt_s, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfff0007f, 0x5a000053, {.type = inst_fsqrt_d, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00007f, 0x00000053, {.type = inst_fadd_s, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00007f, 0x02000053, {.type = inst_fadd_d, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00007f, 0x08000053, {.type = inst_fsub_s, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00007f, 0x0a000053, {.type = inst_fsub_d, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00007f, 0x10000053, {.type = inst_fmul_s, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00007f, 0x12000053, {.type = inst_fmul_d, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe00007f, 0x18000053, {.type = inst_fdiv_s, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfe00007f, 0x1a000053, {.type = inst_fdiv_d, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfff0007f, 0x58000053, {.type = inst_fsqrt_s, .rvc = false, .cont = false}, fmt_r, 0},
+    {0xfff0007f, 0x5a000053, {.type = inst_fsqrt_d, .rvc = false, .cont = false}, fmt_r, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x0000707f, 0x00000063, {.type = inst_beq, .rvc = false, .cont = true}, fmt_b, 0},
+    {0x0000707f, 0x00001063, {.type = inst_bne, .rvc = false, .cont = true}, fmt_b, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x0000707f, 0x00004063, {.type = inst_blt, .rvc = false, .cont = true}, fmt_b, 0},
+    {0x0000707f, 0x00005063, {.type = inst_bge, .rvc = false, .cont = true}, fmt_b, 0},
+    {0x0000707f, 0x00006063, {.type = inst_bltu, .rvc = false, .cont = true}, fmt_b, 0},
+    {0x0000707f, 0x00007063, {.type = inst_bgeu, .rvc = false, .cont = true}, fmt_b, 0},
+    {0x0000707f, 0x00000067, {.type = inst_jalr, .rvc = false, .cont = true}, fmt_i, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x0000007f, 0x0000006f, {.type = inst_jal, .rvc = false, .cont = true}, fmt_j, 0},
+    {0x0000007f, 0x0000006f, {.type = inst_jal, .rvc = false, .cont = true}, fmt_j, 0},
+    {0x0000007f, 0x0000006f, {.type = inst_jal, .rvc = false, .cont = true}, fmt_j, 0},
+    {0x0000007f, 0x0000006f, {.type = inst_jal, .rvc = false, .cont = true}, fmt_j, 0},
+    {0x0000007f, 0x0000006f, {.type = inst_jal, .rvc = false, .cont = true}, fmt_j, 0},
+    {0x0000007f, 0x0000006f, {.type = inst_jal, .rvc = false, .cont = true}, fmt_j, 0},
+    {0x0000007f, 0x0000006f, {.type = inst_jal, .rvc = false, .cont = true}, fmt_j, 0},
+    {0x0000007f, 0x0000006f, {.type = inst_jal, .rvc = false, .cont = true}, fmt_j, 0},
+    {0xffffffff, 0x00000073, {.type = inst_ecall, .rvc = false, .cont = true}, fmt_none, 0},
+    {0xffffffff, 0x00100073, {.type = inst_ebreak, .rvc = false, .cont = true}, fmt_none, 0},
+    {0xffffffff, 0x30200073, {.type = inst_mret, .rvc = false, .cont = true}, fmt_none, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0xfe007fff, 0x12000073, {.type = inst_sfence_vma, .rvc = false, .cont = true}, fmt_r, 0},
+    {0xfe007fff, 0x12000073, {.type = inst_sfence_vma, .rvc = false, .cont = true}, fmt_r, 0},
+    {0xfe007fff, 0x12000073, {.type = inst_sfence_vma, .rvc = false, .cont = true}, fmt_r, 0},
+    {0xfe007fff, 0x12000073, {.type = inst_sfence_vma, .rvc = false, .cont = true}, fmt_r, 0},
+    {0xfe007fff, 0x12000073, {.type = inst_sfence_vma, .rvc = false, .cont = true}, fmt_r, 0},
+    {0xfe007fff, 0x12000073, {.type = inst_sfence_vma, .rvc = false, .cont = true}, fmt_r, 0},
+    {0xfe007fff, 0x12000073, {.type = inst_sfence_vma, .rvc = false, .cont = true}, fmt_r, 0},
+    {0xfe007fff, 0x12000073, {.type = inst_sfence_vma, .rvc = false, .cont = true}, fmt_r, 0},
+    {0xfe007fff, 0x12000073, {.type = inst_sfence_vma, .rvc = false, .cont = true}, fmt_r, 0},
+    {0xfe007fff, 0x12000073, {.type = inst_sfence_vma, .rvc = false, .cont = true}, fmt_r, 0},
+    {0xfe007fff, 0x12000073, {.type = inst_sfence_vma, .rvc = false, .cont = true}, fmt_r, 0},
+    {0xfe007fff, 0x12000073, {.type = inst_sfence_vma, .rvc = false, .cont = true}, fmt_r, 0},
+    {0xfe007fff, 0x12000073, {.type = inst_sfence_vma, .rvc = false, .cont = true}, fmt_r, 0},
+    {0xfe007fff, 0x12000073, {.type = inst_sfence_vma, .rvc = false, .cont = true}, fmt_r, 0},
+    {0xfe007fff, 0x12000073, {.type = inst_sfence_vma, .rvc = false, .cont = true}, fmt_r, 0},
+    {0xfe007fff, 0x12000073, {.type = inst_sfence_vma, .rvc = false, .cont = true}, fmt_r, 0},
+    {0xfe007fff, 0x12000073, {.type = inst_sfence_vma, .rvc = false, .cont = true}, fmt_r, 0},
+    {0xfe007fff, 0x12000073, {.type = inst_sfence_vma, .rvc = false, .cont = true}, fmt_r, 0},
+    {0xfe007fff, 0x12000073, {.type = inst_sfence_vma, .rvc = false, .cont = true}, fmt_r, 0},
+    {0xfe007fff, 0x12000073, {.type = inst_sfence_vma, .rvc = false, .cont = true}, fmt_r, 0},
+    {0xfe007fff, 0x12000073, {.type = inst_sfence_vma, .rvc = false, .cont = true}, fmt_r, 0},
+    {0xfe007fff, 0x12000073, {.type = inst_sfence_vma, .rvc = false, .cont = true}, fmt_r, 0},
+    {0xfe007fff, 0x12000073, {.type = inst_sfence_vma, .rvc = false, .cont = true}, fmt_r, 0},
+    {0xfe007fff, 0x12000073, {.type = inst_sfence_vma, .rvc = false, .cont = true}, fmt_r, 0},
+    {0xfe007fff, 0x12000073, {.type = inst_sfence_vma, .rvc = false, .cont = true}, fmt_r, 0},
+    {0xfe007fff, 0x12000073, {.type = inst_sfence_vma, .rvc = false, .cont = true}, fmt_r, 0},
+    {0xfe007fff, 0x12000073, {.type = inst_sfence_vma, .rvc = false, .cont = true}, fmt_r, 0},
+    {0xfe007fff, 0x12000073, {.type = inst_sfence_vma, .rvc = false, .cont = true}, fmt_r, 0},
+    {0xfe007fff, 0x12000073, {.type = inst_sfence_vma, .rvc = false, .cont = true}, fmt_r, 0},
+    {0xfe007fff, 0x12000073, {.type = inst_sfence_vma, .rvc = false, .cont = true}, fmt_r, 0},
+    {0xfe007fff, 0x12000073, {.type = inst_sfence_vma, .rvc = false, .cont = true}, fmt_r, 0},
+    {0xfe007fff, 0x12000073, {.type = inst_sfence_vma, .rvc = false, .cont = true}, fmt_r, 0},
+    {0x0000707f, 0x00001073, {.type = inst_csrrw, .rvc = false, .cont = true}, fmt_csr, 0},
+    {0x0000707f, 0x00002073, {.type = inst_csrrs, .rvc = false, .cont = true}, fmt_csr, 0},
+    {0x0000707f, 0x00003073, {.type = inst_csrrc, .rvc = false, .cont = true}, fmt_csr, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x0000707f, 0x00005073, {.type = inst_csrrwi, .rvc = false, .cont = true}, fmt_csr, 0},
+    {0x0000707f, 0x00006073, {.type = inst_csrrsi, .rvc = false, .cont = true}, fmt_csr, 0},
+    {0x0000707f, 0x00007073, {.type = inst_csrrci, .rvc = false, .cont = true}, fmt_csr, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x00000000, 0x00000001, {0}, 0, 0},
+};
+
+static const decode_entry_t decode_overflow[6] = {
+    {0x00000000, 0x00000001, {0}, 0, 0},
+    {0x0000e003, 0x00000001, {.type = inst_caddi, .rvc = true, .cont = false}, fmt_ci, 0},
+    {0x0000e003, 0x00006001, {.type = inst_clui, .rvc = true, .cont = false}, fmt_ci_lui, 0},
+    {0x0000f003, 0x00008002, {.type = inst_cmv, .rvc = true, .cont = false}, fmt_cr, 0},
+    {0x0000f003, 0x00009002, {.type = inst_cadd, .rvc = true, .cont = false}, fmt_cr, 0},
+    {0x0000f07f, 0x00009002, {.type = inst_cjalr, .rvc = true, .cont = true}, fmt_cr, 4},
+};
+
+// instructions writing the integer register rd
+static const bool writes_rd[num_insts] = {
+    [inst_lui] = true,
+    [inst_auipc] = true,
+    [inst_jal] = true,
+    [inst_jalr] = true,
+    [inst_lb] = true,
+    [inst_lh] = true,
+    [inst_lw] = true,
+    [inst_lbu] = true,
+    [inst_lhu] = true,
+    [inst_addi] = true,
+    [inst_slti] = true,
+    [inst_sltiu] = true,
+    [inst_xori] = true,
+    [inst_ori] = true,
+    [inst_andi] = true,
+    [inst_slli] = true,
+    [inst_srli] = true,
+    [inst_srai] = true,
+    [inst_add] = true,
+    [inst_sub] = true,
+    [inst_sll] = true,
+    [inst_slt] = true,
+    [inst_sltu] = true,
+    [inst_xor] = true,
+    [inst_srl] = true,
+    [inst_sra] = true,
+    [inst_or] = true,
+    [inst_and] = true,
+    [inst_lwu] = true,
+    [inst_ld] = true,
+    [inst_addiw] = true,
+    [inst_slliw] = true,
+    [inst_srliw] = true,
+    [inst_sraiw] = true,
+    [inst_addw] = true,
+    [inst_subw] = true,
+    [inst_sllw] = true,
+    [inst_srlw] = true,
+    [inst_sraw] = true,
+    [inst_mul] = true,
+    [inst_mulh] = true,
+    [inst_mulhsu] = true,
+    [inst_mulhu] = true,
+    [inst_div] = true,
+    [inst_divu] = true,
+    [inst_rem] = true,
+    [inst_remu] = true,
+    [inst_mulw] = true,
+    [inst_divw] = true,
+    [inst_divuw] = true,
+    [inst_remw] = true,
+    [inst_remuw] = true,
+    [inst_clwsp] = true,
+    [inst_cldsp] = true,
+    [inst_clw] = true,
+    [inst_cld] = true,
+    [inst_cli] = true,
+    [inst_clui] = true,
+    [inst_caddi] = true,
+    [inst_caddiw] = true,
+    [inst_caddi4spn] = true,
+    [inst_cslli] = true,
+    [inst_csrli] = true,
+    [inst_csrai] = true,
+    [inst_candi] = true,
+    [inst_cmv] = true,
+    [inst_cadd] = true,
+    [inst_cand] = true,
+    [inst_cor] = true,
+    [inst_cxor] = true,
+    [inst_csub] = true,
+    [inst_caddw] = true,
+    [inst_csubw] = true,
+};
@@ -1,3 +1,4 @@
+// Generated by gen_insts.py from insts.spec, do not edit.
 exec_lui,
 exec_auipc,
 exec_jal,
@@ -102,6 +103,7 @@ exec_caddw,
 exec_csubw,
 exec_cnop,
 exec_mret,
+exec_sfence_vma,
 exec_flw,
 exec_fsw,
 exec_fadd_s,
@@ -127,4 +129,20 @@ exec_fmax_d,
 exec_fmadd_d,
 exec_fmsub_d,
 exec_fnmsub_d,
-exec_fnmadd_d,
\ No newline at end of file
+exec_fnmadd_d,
+exec_fence_i,
+exec_lui_addi,
+exec_auipc_jalr,
+exec_auipc_jr,
+exec_auipc_ld,
+exec_slli_srli,
+exec_addi_bne,
+exec_nop,
+exec_li,
+exec_mv,
+exec_j,
+exec_jr,
+exec_lb_x0,
+exec_lh_x0,
+exec_lw_x0,
+exec_ld_x0,
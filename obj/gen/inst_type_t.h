@@ -1,3 +1,4 @@
+// Generated by gen_insts.py from insts.spec, do not edit.
 inst_lui,       // RV32I/RV64I Base Instruction Set
 inst_auipc,
 inst_jal,
@@ -102,6 +103,7 @@ inst_caddw,
 inst_csubw,
 inst_cnop,
 inst_mret,      // Trap-Return Instructions
+inst_sfence_vma,// Supervisor Memory-Management Instructions
 inst_flw,       // RV32F Instructions
 inst_fsw,
 inst_fadd_s,
@@ -128,5 +130,20 @@ inst_fmadd_d,
 inst_fmsub_d,
 inst_fnmsub_d,
 inst_fnmadd_d,
+inst_fence_i,   // Zifencei
+inst_lui_addi,  // Fused instruction pairs
+inst_auipc_jalr,
+inst_auipc_jr,
+inst_auipc_ld,
+inst_slli_srli,
+inst_addi_bne,
+inst_nop,       // Specialised variants picked by the decoder
+inst_li,
+inst_mv,
+inst_j,
+inst_jr,
+inst_lb_x0,
+inst_lh_x0,
+inst_lw_x0,
+inst_ld_x0,
 num_insts,      // Numbered Instructions
-
@@ -0,0 +1,149 @@
+// Generated by gen_insts.py from insts.spec, do not edit.
+// instruction handlers in the form OP(name), expands to inst_##name / exec_##name
+OP(lui)
+OP(auipc)
+OP(jal)
+OP(jalr)
+OP(beq)
+OP(bne)
+OP(blt)
+OP(bge)
+OP(bltu)
+OP(bgeu)
+OP(lb)
+OP(lh)
+OP(lw)
+OP(lbu)
+OP(lhu)
+OP(sb)
+OP(sh)
+OP(sw)
+OP(addi)
+OP(slti)
+OP(sltiu)
+OP(xori)
+OP(ori)
+OP(andi)
+OP(slli)
+OP(srli)
+OP(srai)
+OP(add)
+OP(sub)
+OP(sll)
+OP(slt)
+OP(sltu)
+OP(xor)
+OP(srl)
+OP(sra)
+OP(or)
+OP(and)
+OP(fence)
+OP(ecall)
+OP(ebreak)
+OP(lwu)
+OP(ld)
+OP(sd)
+OP(addiw)
+OP(slliw)
+OP(srliw)
+OP(sraiw)
+OP(addw)
+OP(subw)
+OP(sllw)
+OP(srlw)
+OP(sraw)
+OP(mul)
+OP(mulh)
+OP(mulhsu)
+OP(mulhu)
+OP(div)
+OP(divu)
+OP(rem)
+OP(remu)
+OP(mulw)
+OP(divw)
+OP(divuw)
+OP(remw)
+OP(remuw)
+OP(csrrw)
+OP(csrrs)
+OP(csrrc)
+OP(csrrwi)
+OP(csrrsi)
+OP(csrrci)
+OP(clwsp)
+OP(cldsp)
+OP(cswsp)
+OP(csdsp)
+OP(clw)
+OP(cld)
+OP(csw)
+OP(csd)
+OP(cj)
+OP(cjr)
+OP(cjalr)
+OP(cbeqz)
+OP(cbnez)
+OP(cli)
+OP(clui)
+OP(caddi)
+OP(caddiw)
+OP(caddi16sp)
+OP(caddi4spn)
+OP(cslli)
+OP(csrli)
+OP(csrai)
+OP(candi)
+OP(cmv)
+OP(cadd)
+OP(cand)
+OP(cor)
+OP(cxor)
+OP(csub)
+OP(caddw)
+OP(csubw)
+OP(cnop)
+OP(mret)
+OP(sfence_vma)
+OP(flw)
+OP(fsw)
+OP(fadd_s)
+OP(fsub_s)
+OP(fmul_s)
+OP(fdiv_s)
+OP(fsqrt_s)
+OP(fmin_s)
+OP(fmax_s)
+OP(fmadd_s)
+OP(fmsub_s)
+OP(fnmsub_s)
+OP(fnmadd_s)
+OP(fld)
+OP(fsd)
+OP(fadd_d)
+OP(fsub_d)
+OP(fmul_d)
+OP(fdiv_d)
+OP(fsqrt_d)
+OP(fmin_d)
+OP(fmax_d)
+OP(fmadd_d)
+OP(fmsub_d)
+OP(fnmsub_d)
+OP(fnmadd_d)
+OP(fence_i)
+OP(lui_addi)
+OP(auipc_jalr)
+OP(auipc_jr)
+OP(auipc_ld)
+OP(slli_srli)
+OP(addi_bne)
+OP(nop)
+OP(li)
+OP(mv)
+OP(j)
+OP(jr)
+OP(lb_x0)
+OP(lh_x0)
+OP(lw_x0)
+OP(ld_x0)
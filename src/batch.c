@@ -0,0 +1,294 @@
+#define _GNU_SOURCE
+#include <pthread.h>
+#include "rvemu.h"
+
+/**
+ * Batch mode
+ *
+ * rvemu --batch list -j N runs the guest programs of a list, one per line with
+ * its arguments, on N host threads of one process. Each job is a machine of
+ * its own (see the guest window in mmu.c), its stdout and stderr are captured
+ * in memory files and written out in list order once every job is done,
+ * followed by a table of the exit status and the wall time of each job.
+ *
+ * Jobs are dealt round robin to per thread deques. A thread runs the jobs of
+ * its own deque from the back, and once it is empty steals from the front of
+ * the others, so a thread stuck with a long job leaves its other jobs to the
+ * idle threads.
+ *
+ * Every distinct program is opened once, its jobs load it from the same fd,
+ * and the segments of all of them are private mappings of the same page
+ * cache pages. Jobs have no stdin.
+ *
+ * A fatal error while a job runs (a trap without handler, an unimplemented
+ * syscall, a bad ELF) stops the job, not the batch: fatal_exit jumps back to
+ * the worker.
+ */
+
+// lines of the list starting with it are comments
+#define BATCH_COMMENT '#'
+
+typedef struct {
+    char **argv;        // argv[0] is a placeholder for the emulator, then the program and its arguments
+    int argc;
+    int elf;            // shared fd of the program, -1 if it could not be opened
+    int out;            // captured stdout and stderr
+    int err;
+    int status;         // exit status, -1 when the job was stopped by a fatal error
+    u64 instret;        // guest instructions retired
+    f64 time;           // wall time in seconds
+} batch_job_t;
+
+// deque of job indices, the owner takes from the back, thieves from the front
+typedef struct {
+    pthread_mutex_t lock;
+    u64 *jobs;
+    u64 head;
+    u64 tail;
+} batch_deque_t;
+
+typedef struct {
+    batch_job_t *jobs;
+    u64 num_jobs;
+    batch_deque_t *deques;
+    int threads;
+    const machine_t *config;    // options of the command line
+    bool uring;
+} batch_t;
+
+typedef struct {
+    batch_t *batch;
+    int id;
+} batch_worker_t;
+
+// worker jumps back here when its job hits a fatal error, NULL outside of jobs
+static __thread sigjmp_buf *batch_jmp;
+
+/**
+ * @brief end the process after a fatal error, or the job only in batch mode
+ *
+ */
+void fatal_exit() {
+    replay_abort();
+    if (batch_jmp) siglongjmp(*batch_jmp, 1);
+    exit(1);
+}
+
+static f64 batch_now() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief read the list of jobs
+ *
+ * @param batch batch to fill
+ * @param list  path of the list
+ */
+static void batch_parse(batch_t *batch, const char *list) {
+    FILE *file = fopen(list, "r");
+    if (!file) fatalf("%s: %s", list, strerror(errno));
+
+    u64 size = 0;
+    char *line = NULL;
+    size_t line_size = 0;
+    while (getline(&line, &line_size, file) != -1) {
+        char *save, *word = strtok_r(line, " \t\r\n", &save);
+        if (!word || word[0] == BATCH_COMMENT) continue;
+
+        if (batch->num_jobs == size) {
+            size = size ? size * 2 : 64;
+            batch->jobs = realloc(batch->jobs, size * sizeof(batch_job_t));
+            if (!batch->jobs) fatal("realloc failed.");
+        }
+        batch_job_t *job = &batch->jobs[batch->num_jobs++];
+        *job = (batch_job_t) {.elf = -1};
+
+        // one slot per word at most, and the placeholder
+        job->argv = calloc(strlen(word) + strlen(save ? save : "") + 3, sizeof(char *));
+        if (!job->argv) fatal("calloc failed.");
+        job->argv[job->argc++] = "rvemu";
+        for (; word; word = strtok_r(NULL, " \t\r\n", &save)) {
+            job->argv[job->argc++] = strdup(word);
+        }
+    }
+    free(line);
+    fclose(file);
+}
+
+/**
+ * @brief open every distinct program once, and the capture files of each job
+ *
+ * @param batch batch with the jobs parsed
+ */
+static void batch_open(batch_t *batch) {
+    for (u64 i = 0; i < batch->num_jobs; i++) {
+        batch_job_t *job = &batch->jobs[i];
+        for (u64 j = 0; j < i && job->elf < 0; j++) {
+            if (!strcmp(batch->jobs[j].argv[1], job->argv[1])) job->elf = batch->jobs[j].elf;
+        }
+        if (job->elf < 0) job->elf = open(job->argv[1], O_RDONLY | O_CLOEXEC);
+
+        job->out = memfd_create("stdout", MFD_CLOEXEC);
+        job->err = memfd_create("stderr", MFD_CLOEXEC);
+        if (job->out < 0 || job->err < 0) fatal(strerror(errno));
+        if (job->elf < 0) dprintf(job->err, "%s: %s\n", job->argv[1], strerror(errno));
+    }
+}
+
+/**
+ * @brief run a job on a machine of its own
+ *
+ * @param batch batch of the job
+ * @param job   job to run
+ */
+static void batch_run_job(batch_t *batch, batch_job_t *job) {
+    job->status = -1;
+    if (job->elf < 0) return;
+
+    machine_t *m = aligned_alloc(64, ROUNDUP(sizeof(machine_t), 64));
+    if (!m) fatal("aligned_alloc failed.");
+    memset(m, 0, sizeof(machine_t));
+    const machine_t *config = batch->config;
+    m->use_jit = config->use_jit;
+    m->cache.fuse = config->cache.fuse;
+    m->console.unbuffered = config->console.unbuffered;
+    m->console.out[STDOUT_FILENO] = job->out;
+    m->console.out[STDERR_FILENO] = job->err;
+    m->mmu.thp = config->mmu.thp;
+    m->mmu.hugetlb = config->mmu.hugetlb;
+    m->mmu.populate = config->mmu.populate;
+    m->mmu.nodes = config->mmu.nodes;
+    m->state.mhz = config->state.mhz;
+    m->jit.icount = config->jit.icount;
+
+    f64 start = batch_now();
+    sigjmp_buf jmp;
+    if (!sigsetjmp(jmp, 0)) {
+        batch_jmp = &jmp;
+        if (m->use_jit) jit_init(&m->jit);
+        if (batch->uring) uring_init(&m->uring);
+        machine_load_elf(m, job->elf);
+        machine_setup(m, job->argc, job->argv);
+        m->fds[STDIN_FILENO] = -1;
+        job->status = machine_run(m) & 0xff;
+    } else {
+        trap_detach();
+    }
+    batch_jmp = NULL;
+    job->time = batch_now() - start;
+    job->instret = m->state.instret;
+
+    machine_free(m);
+    free(m);
+}
+
+// next job of a worker, its own or stolen, -1 when every deque is empty
+static i64 batch_next(batch_t *batch, int id) {
+    for (int i = 0; i < batch->threads; i++) {
+        batch_deque_t *deque = &batch->deques[(id + i) % batch->threads];
+        i64 job = -1;
+        pthread_mutex_lock(&deque->lock);
+        if (deque->head < deque->tail) job = i ? deque->jobs[deque->head++] : deque->jobs[--deque->tail];
+        pthread_mutex_unlock(&deque->lock);
+        if (job >= 0) return job;
+    }
+    return -1;
+}
+
+static void *batch_worker(void *arg) {
+    batch_worker_t *worker = arg;
+    i64 job;
+    while ((job = batch_next(worker->batch, worker->id)) >= 0) {
+        batch_run_job(worker->batch, &worker->batch->jobs[job]);
+    }
+    return NULL;
+}
+
+// copy a capture file to a host fd
+static void batch_copy(int from, int to) {
+    u8 buf[65536];
+    ssize_t n;
+    lseek(from, 0, SEEK_SET);
+    while ((n = read(from, buf, sizeof(buf))) > 0) {
+        for (ssize_t done = 0, w; done < n; done += w) {
+            w = write(to, buf + done, n - done);
+            if (w < 0) return;
+        }
+    }
+}
+
+// write the captured output of a job under a header naming it, if there is any
+static void batch_output(batch_job_t *job, u64 i, int from, FILE *to) {
+    if (!lseek(from, 0, SEEK_END)) return;
+    fprintf(to, "==> [%lu]", i);
+    for (int a = 1; a < job->argc; a++) fprintf(to, " %s", job->argv[a]);
+    fprintf(to, " <==\n");
+    fflush(to);
+    batch_copy(from, fileno(to));
+}
+
+/**
+ * @brief run the jobs of a list on a pool of host threads
+ *
+ * @param list    path of the list, a program and its arguments per line
+ * @param threads host threads
+ * @param config  machine with the options of the command line
+ * @param uring   jobs use the io_uring backend
+ * @return int 0 if every job exited with status 0, 1 otherwise
+ */
+int batch_run(const char *list, int threads, const machine_t *config, bool uring) {
+    batch_t batch = {.threads = threads, .config = config, .uring = uring};
+    batch_parse(&batch, list);
+    batch_open(&batch);
+    if (!batch.num_jobs) return 0;
+    trap_init();
+
+    batch.deques = calloc(threads, sizeof(batch_deque_t));
+    if (!batch.deques) fatal("calloc failed.");
+    for (int i = 0; i < threads; i++) {
+        batch_deque_t *deque = &batch.deques[i];
+        pthread_mutex_init(&deque->lock, NULL);
+        deque->jobs = malloc((batch.num_jobs / threads + 1) * sizeof(u64));
+        if (!deque->jobs) fatal("malloc failed.");
+    }
+    // the first jobs of the list at the back, they are run first
+    for (u64 i = batch.num_jobs; i > 0; i--) {
+        batch_deque_t *deque = &batch.deques[(i - 1) % threads];
+        deque->jobs[deque->tail++] = i - 1;
+    }
+
+    f64 start = batch_now();
+    pthread_t *tids = calloc(threads, sizeof(pthread_t));
+    batch_worker_t *workers = calloc(threads, sizeof(batch_worker_t));
+    if (!tids || !workers) fatal("calloc failed.");
+    for (int i = 0; i < threads; i++) {
+        workers[i] = (batch_worker_t) {.batch = &batch, .id = i};
+        if (pthread_create(&tids[i], NULL, batch_worker, &workers[i])) fatal("pthread_create failed.");
+    }
+    for (int i = 0; i < threads; i++) pthread_join(tids[i], NULL);
+    f64 elapsed = batch_now() - start;
+
+    // outputs in list order, then the table
+    int failed = 0;
+    u64 instret = 0;
+    for (u64 i = 0; i < batch.num_jobs; i++) {
+        batch_job_t *job = &batch.jobs[i];
+        batch_output(job, i, job->out, stdout);
+        batch_output(job, i, job->err, stderr);
+        if (job->status) failed++;
+        instret += job->instret;
+    }
+
+    printf("%6s %6s %10s %10s  %s\n", "job", "status", "time (s)", "MIPS", "program");
+    for (u64 i = 0; i < batch.num_jobs; i++) {
+        batch_job_t *job = &batch.jobs[i];
+        printf("%6lu %6d %10.3f %10.2f ", i, job->status, job->time, job->time > 0 ? job->instret / job->time * 1e-6 : 0.0);
+        for (int a = 1; a < job->argc; a++) printf(" %s", job->argv[a]);
+        printf("\n");
+    }
+    printf("batch: %lu jobs (%d failed) on %d threads in %.3f s, %.2f jobs/s, %.2f MIPS\n",
+           batch.num_jobs, failed, threads, elapsed, batch.num_jobs / elapsed, instret / elapsed * 1e-6);
+    return failed ? 1 : 0;
+}
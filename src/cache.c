@@ -0,0 +1,273 @@
+#include "rvemu.h"
+
+/**
+ * Block cache
+ *
+ * Decoding an instruction is much more expensive than executing it, and hot
+ * code is executed over and over. The first time a pc is visited, we decode
+ * the instructions starting at this pc up to (and including) the next control
+ * flow instruction and store the result as a block in a hash table keyed by
+ * the guest pc. Later visits of the same pc simply replay the decoded block.
+ *
+ * The table uses open addressing with linear probing and is doubled whenever
+ * it becomes half full.
+ *
+ * Indirect jumps (jalr, c.jr, c.jalr) can not be linked statically. Their
+ * targets are remembered in a small direct mapped jump cache, and returns are
+ * predicted by a shadow return-address stack fed by the calls, so most of them
+ * find the next block without probing the hash table.
+ */
+
+#define CACHE_INIT_SIZE 1024
+
+// Fibonacci hashing of the guest pc. Instructions are at least 2 bytes aligned.
+#define CACHE_HASH(pc, size) ((((pc) >> 1) * 0x9E3779B97F4A7C15ULL) >> (64 - __builtin_ctzll(size)))
+
+/**
+ * @brief insert a block into the table, the table must have a free slot
+ *
+ * @param table hash table
+ * @param size  number of slots in the table
+ * @param block block to be inserted
+ */
+static void cache_insert(block_t **table, u64 size, block_t *block) {
+    u64 i = CACHE_HASH(block->pc, size);
+    while (table[i]) i = (i + 1) & (size - 1);
+    table[i] = block;
+}
+
+/**
+ * @brief double the size of the hash table
+ *
+ * @param cache pointer to the block cache
+ */
+static void cache_grow(cache_t *cache) {
+    u64 size = cache->size ? cache->size * 2 : CACHE_INIT_SIZE;
+    block_t **table = calloc(size, sizeof(block_t *));
+    if (!table) fatal("calloc failed.");
+
+    for (u64 i = 0; i < cache->size; i++) {
+        if (cache->table[i]) cache_insert(table, size, cache->table[i]);
+    }
+
+    free(cache->table);
+    cache->table = table;
+    cache->size = size;
+}
+
+/**
+ * @brief find the decoded block starting at pc
+ *
+ * @param cache pointer to the block cache
+ * @param pc    guest pc
+ * @return block_t* the decoded block or NULL if pc has not been decoded yet
+ */
+block_t *cache_lookup(cache_t *cache, u64 pc) {
+    if (cache->size) {
+        u64 i = CACHE_HASH(pc, cache->size);
+        for (block_t *block; (block = cache->table[i]); i = (i + 1) & (cache->size - 1)) {
+            if (block->pc == pc) {
+                cache->hits++;
+                return block;
+            }
+        }
+    }
+    cache->misses++;
+    return NULL;
+}
+
+/**
+ * @brief find the statically known successors of a block and classify its last jump
+ *
+ * @param block   decoded block
+ * @param last_pc guest pc of the last instruction of the block
+ */
+static void block_set_links(block_t *block, u64 last_pc) {
+    inst_t *last = &block->insts[block->len - 1];
+    u64 next_pc = last_pc + INST_LEN(last);
+
+    memset(block->links, 0, sizeof(block->links));
+    block->jump = jump_static;
+    block->call = false;
+    switch (last->type) {
+        case inst_jalr:
+            block->jump = jump_indirect;
+            block->call = last->rd == ra;
+            break;
+        case inst_jr:
+        case inst_cjr:
+            block->jump = last->rs1 == ra ? jump_return : jump_indirect;
+            break;
+        case inst_cjalr:
+            block->jump = jump_indirect;
+            block->call = true;
+            break;
+        case inst_auipc_jalr:
+            block->jump = jump_indirect;
+            block->call = last->rd == ra;
+            break;
+        case inst_auipc_jr:
+            block->jump = jump_indirect;
+            break;
+        case inst_addi_bne:
+            block->links[link_taken] = (link_t) {.valid = true, .pc = last_pc + FUSED_HI(last->imm)};
+            block->links[link_next] = (link_t) {.valid = true, .pc = next_pc};
+            break;
+        case inst_beq: case inst_bne: case inst_blt: case inst_bge: case inst_bltu: case inst_bgeu:
+        case inst_cbeqz: case inst_cbnez:
+            block->links[link_taken] = (link_t) {.valid = true, .pc = last_pc + (i64) last->imm};
+            block->links[link_next] = (link_t) {.valid = true, .pc = next_pc};
+            break;
+        case inst_jal: case inst_j: case inst_cj:
+            block->links[link_taken] = (link_t) {.valid = true, .pc = last_pc + (i64) last->imm};
+            block->call = last->type == inst_jal && last->rd == ra;
+            break;
+        case inst_csrrw: case inst_csrrs: case inst_csrrc:
+        case inst_csrrwi: case inst_csrrsi: case inst_csrrci:
+            // the block goes on at the next instruction unless satp was written
+            block->links[link_next] = (link_t) {.valid = true, .pc = next_pc};
+            break;
+        default:
+            // block cut at BLOCK_MAX_INSTS or at a page boundary
+            if (!last->cont) block->links[link_next] = (link_t) {.valid = true, .pc = next_pc};
+            break;
+    }
+    if (block->call) block->links[link_return] = (link_t) {.valid = true, .pc = next_pc};
+}
+
+/**
+ * @brief decode the block starting at pc and add it to the cache
+ *
+ * The code is fetched through the current address translation, the blocks
+ * of the cache must all have been decoded with the same one.
+ *
+ * @param cache pointer to the block cache
+ * @param state CPU state
+ * @param pc    guest pc
+ * @return block_t* the decoded block
+ */
+block_t *cache_add(cache_t *cache, state_t *state, u64 pc) {
+    inst_t insts[BLOCK_MAX_INSTS];
+    u32 len = 0, icount = 0;
+    u64 addr = pc;
+    u64 last_pc = pc;   // guest pc of the last decoded instruction
+
+    // decode till the first control flow instruction
+    while (true) {
+        inst_t *inst = &insts[len++];
+        inst_decode(inst, mmu_fetch(state, addr));
+        icount++;
+        u64 next = addr + (inst->rvc ? 2 : 4);
+
+        if (cache->fuse && len > 1 && inst_fuse(&insts[len - 2], inst)) {
+            inst = &insts[--len - 1];
+            cache->fused++;
+        } else {
+            last_pc = addr;
+        }
+
+        if (inst->cont || len == BLOCK_MAX_INSTS) break;
+        addr = next;
+
+        // stay on the page of pc, only the first instruction of a block may fault on fetch
+        if (ROUNDDOWN(addr, GUEST_PAGE_SIZE) != ROUNDDOWN(pc, GUEST_PAGE_SIZE)) break;
+        if ((addr & (GUEST_PAGE_SIZE - 1)) == GUEST_PAGE_SIZE - 2 && (*(u16 *) mmu_host(state, addr, 2, access_fetch) & 0x3) == 0x3) break;
+    }
+
+    block_t *block = malloc(sizeof(block_t) + len * sizeof(inst_t));
+    if (!block) fatal("malloc failed.");
+    block->pc = pc;
+    block->len = len;
+    block->icount = icount;
+    block->code = NULL;
+    block->translate = state->translate;
+    memcpy(block->insts, insts, len * sizeof(inst_t));
+    block_set_links(block, last_pc);
+
+    // the last instruction ends before addr + 4
+    cache->code_start = cache->count ? MIN(cache->code_start, pc) : pc;
+    cache->code_end = cache->count ? MAX(cache->code_end, addr + 4) : addr + 4;
+
+    if ((cache->count + 1) * 2 > cache->size) cache_grow(cache);
+    cache_insert(cache->table, cache->size, block);
+    cache->count++;
+
+    return block;
+}
+
+/**
+ * @brief drop all the decoded blocks, used when the guest code is modified
+ *
+ * @param cache pointer to the block cache
+ */
+void cache_flush(cache_t *cache) {
+    for (u64 i = 0; i < cache->size; i++) {
+        free(cache->table[i]);
+        cache->table[i] = NULL;
+    }
+    cache->count = 0;
+    memset(cache->jump_cache, 0, sizeof(cache->jump_cache));
+    cache->ras_count = 0;
+}
+
+/**
+ * @brief drop the decoded blocks and release the table
+ *
+ * @param cache pointer to the block cache
+ */
+void cache_free(cache_t *cache) {
+    cache_flush(cache);
+    free(cache->table);
+}
+
+/**
+ * @brief find the jump cache entry of an indirect jump target
+ *
+ * On a miss the entry is taken over by pc, its block is filled in once the
+ * target block has been looked up.
+ *
+ * @param cache pointer to the block cache
+ * @param pc    guest pc of the jump target
+ * @return link_t* the jump cache entry of pc
+ */
+link_t *cache_jump_lookup(cache_t *cache, u64 pc) {
+    link_t *link = &cache->jump_cache[(pc >> 1) & (JUMP_CACHE_SIZE - 1)];
+    if (link->valid && link->pc == pc && link->block) {
+        cache->jump_hits++;
+        return link;
+    }
+    cache->jump_misses++;
+    *link = (link_t) {.valid = true, .pc = pc};
+    return link;
+}
+
+/**
+ * @brief push the return link of a call on the return-address stack
+ *
+ * @param cache pointer to the block cache
+ * @param link  return link of the calling block
+ */
+void cache_ras_push(cache_t *cache, link_t *link) {
+    cache->ras[cache->ras_top++ & (RAS_SIZE - 1)] = link;
+    if (cache->ras_count < RAS_SIZE) cache->ras_count++;
+}
+
+/**
+ * @brief pop the return-address stack and check the prediction
+ *
+ * @param cache pointer to the block cache
+ * @param pc    guest pc the return jumps to
+ * @return link_t* the return link of the matching call, NULL if mispredicted
+ */
+link_t *cache_ras_pop(cache_t *cache, u64 pc) {
+    if (cache->ras_count) {
+        cache->ras_count--;
+        link_t *link = cache->ras[--cache->ras_top & (RAS_SIZE - 1)];
+        if (link->pc == pc) {
+            cache->ras_hits++;
+            return link;
+        }
+    }
+    cache->ras_misses++;
+    return NULL;
+}
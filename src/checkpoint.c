@@ -0,0 +1,656 @@
+#define _GNU_SOURCE
+#include <limits.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include "rvemu.h"
+
+/**
+ * Checkpoints
+ *
+ * With --checkpoint-every N, the machine is saved to the checkpoint file at
+ * the first syscall after every N guest instructions, and --restore starts a
+ * machine again from the last checkpoint of a file.
+ *
+ * The file is a sequence of records. Each one holds the machine (state_t,
+ * mmu_t, the free ranges, the CSR pages and the open guest files), the
+ * mapped regions of the guest window with their protection, and guest pages.
+ * The first record is full, it has every page which is not zero. The next
+ * ones are appended and only have the pages written since the record before:
+ * after a checkpoint the writable guest memory is write protected, and the
+ * first write to each CHECKPOINT_CHUNK of it, by the guest or by the
+ * emulator, faults into checkpoint_fault which marks the chunk dirty and
+ * unprotects it. The host kernel writing to a guest buffer does not fault but
+ * fails, the syscalls unprotect the buffers they pass to it first, and the
+ * changes of mappings unprotect and mark the range they change (see
+ * checkpoint_touch).
+ *
+ * The guest is only stopped to copy the pages of a record to a buffer and to
+ * protect the dirty chunks again, the clean ones stay protected, and a
+ * background thread writes the record to the file. A full record skips the
+ * anonymous pages the host never mapped, as told by /proc/self/pagemap. The first checkpoint of a run
+ * writes its record to a new file renamed over the old one once complete, so
+ * the file always holds a checkpoint to restore, and a record cut short by a
+ * crash is left out by --restore.
+ *
+ * Shared file mappings are restored as private copies of their contents, and
+ * the files open by the guest are opened again by path, at the same offset.
+ */
+
+#define CHECKPOINT_MAGIC    0x4b435652  // "RVCK"
+#define CHECKPOINT_VERSION  2
+#define CHUNK_PAGES         (CHECKPOINT_CHUNK / GUEST_PAGE_SIZE)
+#define NUM_CHUNKS          (GUEST_MEMORY_SIZE / CHECKPOINT_CHUNK)
+#define NUM_PAGES           (GUEST_MEMORY_SIZE / GUEST_PAGE_SIZE)
+
+// record header, followed by the machine, the regions and the pages
+typedef struct {
+    u32 magic;
+    u32 version;
+    u32 state_size;     // sizeof(state_t) and sizeof(mmu_t), a checkpoint is restored by the same build
+    u32 mmu_size;
+    u32 full;           // every page of the regions, zero pages aside, otherwise the dirty chunks only
+    u32 pad;
+    u64 instret;
+    u64 machine_size;   // bytes of the machine
+    u64 nregions;
+    u64 npages;         // pages, each a u64 guest address and GUEST_PAGE_SIZE bytes
+} checkpoint_header_t;
+
+// mapped range of the guest window
+typedef struct {
+    u64 start;
+    u64 end;
+    u32 prot;           // host protection
+    u32 anon;           // anonymous memory, the pages the host never mapped are zero
+} checkpoint_region_t;
+
+// open guest fd, followed by path_len bytes of the path of the file
+typedef struct {
+    i32 fd;
+    i32 host_fd;        // the standard streams of the emulator are kept as they are
+    i32 flags;          // file status flags
+    u32 path_len;
+    i64 offset;         // file position, -1 for pipes and the like
+} checkpoint_fd_t;
+
+typedef struct {
+    u8 *data;
+    u64 len;
+    u64 size;
+} checkpoint_buf_t;
+
+struct checkpoint_writer_t {
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    checkpoint_buf_t job;   // record to write, data is NULL when there is none
+    bool full;
+    bool done;              // no more records, the thread exits
+    int error;              // errno of a failed write
+    int fd;                 // checkpoint file, -1 before the first record
+    const char *path;
+    char *tmp;              // the first record is written here, then renamed to path
+};
+
+// mmu tracked on this thread, for the fault handler
+static __thread mmu_t *checkpoint_mmu;
+
+// append len bytes to a buffer
+static void checkpoint_put(checkpoint_buf_t *b, const void *data, u64 len) {
+    if (b->len + len > b->size) {
+        b->size = MAX(b->size * 2, b->len + len);
+        b->data = realloc(b->data, b->size);
+        if (!b->data) fatal("realloc failed.");
+    }
+    memcpy(b->data + b->len, data, len);
+    b->len += len;
+}
+
+// give back their protection to the tracked pages of [first, first + count), async-signal safe
+static void checkpoint_release(mmu_t *mmu, u64 first, u64 count) {
+    u8 *prot = mmu->track_prot;
+    for (u64 page = first, end = first + count; page < end;) {
+        if (!prot[page]) {
+            page++;
+            continue;
+        }
+        u64 run = page + 1;
+        while (run < end && prot[run] == prot[page]) run++;
+        if (mprotect((void *) TO_HOST(mmu, page * GUEST_PAGE_SIZE), (run - page) * GUEST_PAGE_SIZE, prot[page]) < 0) {
+            abort();
+        }
+        memset(&prot[page], 0, run - page);
+        page = run;
+    }
+}
+
+/**
+ * @brief the host is about to write or remap guest memory, unprotect it and mark it dirty
+ *
+ * Called before host syscalls writing to guest buffers and before the
+ * mappings of the guest window change, a no-op without --checkpoint-every.
+ *
+ * @param mmu  pointer to the mmu
+ * @param addr guest address
+ * @param len  length in bytes
+ */
+void checkpoint_touch(mmu_t *mmu, u64 addr, u64 len) {
+    if (!mmu->track_prot || !len || addr >= GUEST_MEMORY_SIZE) return;
+    u64 last = MIN(len, GUEST_MEMORY_SIZE - addr) + addr - 1;
+    for (u64 chunk = addr / CHECKPOINT_CHUNK; chunk <= last / CHECKPOINT_CHUNK; chunk++) {
+        checkpoint_release(mmu, chunk * CHUNK_PAGES, CHUNK_PAGES);
+        mmu->track_dirty[chunk] = 1;
+    }
+}
+
+/**
+ * @brief a host fault, a write to guest memory write protected by the tracker is let through
+ *
+ * Called by the signal handler, before anything else.
+ *
+ * @param host faulting host address
+ * @return true the fault was a tracked write, the access is done again
+ */
+bool checkpoint_fault(u64 host) {
+    mmu_t *mmu = checkpoint_mmu;
+    if (!mmu || host < mmu->mem || host >= GUEST_END(mmu)) return false;
+    if (!mmu->track_prot[TO_GUEST(mmu, host) / GUEST_PAGE_SIZE]) return false;
+    checkpoint_touch(mmu, TO_GUEST(mmu, host), 1);
+    return true;
+}
+
+// write all of a buffer
+static int checkpoint_write_all(int fd, checkpoint_buf_t *b) {
+    for (u64 done = 0; done < b->len;) {
+        ssize_t n = write(fd, b->data + done, b->len - done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) return errno;
+        done += n;
+    }
+    return 0;
+}
+
+// write a record to the file, 0 or the errno of the failure
+static int checkpoint_write(checkpoint_writer_t *w, checkpoint_buf_t *b, bool full) {
+    if (!full) return checkpoint_write_all(w->fd, b);
+
+    int fd = open(w->tmp, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return errno;
+    int error = checkpoint_write_all(fd, b);
+    if (!error && rename(w->tmp, w->path) < 0) error = errno;
+    if (error) {
+        close(fd);
+        return error;
+    }
+    if (w->fd >= 0) close(w->fd);
+    w->fd = fd;
+    return 0;
+}
+
+// the background writer
+static void *checkpoint_writer(void *arg) {
+    checkpoint_writer_t *w = arg;
+    pthread_mutex_lock(&w->lock);
+    while (true) {
+        while (!w->job.data && !w->done) pthread_cond_wait(&w->cond, &w->lock);
+        if (!w->job.data) break;
+        checkpoint_buf_t job = w->job;
+        bool full = w->full;
+        pthread_mutex_unlock(&w->lock);
+
+        int error = w->error ? 0 : checkpoint_write(w, &job, full);
+        free(job.data);
+
+        pthread_mutex_lock(&w->lock);
+        w->job.data = NULL;
+        if (error) w->error = error;
+        pthread_cond_broadcast(&w->cond);
+    }
+    pthread_mutex_unlock(&w->lock);
+    return NULL;
+}
+
+// wait for the record being written
+static void checkpoint_wait(checkpoint_writer_t *w) {
+    pthread_mutex_lock(&w->lock);
+    while (w->job.data) pthread_cond_wait(&w->cond, &w->lock);
+    int error = w->error;
+    pthread_mutex_unlock(&w->lock);
+    if (error) fatalf("checkpoint %s: %s", w->path, strerror(error));
+}
+
+/**
+ * @brief start taking checkpoints, the first one after every instructions
+ *
+ * @param m     pointer to machine, loaded and set up or restored
+ * @param every guest instructions between checkpoints
+ * @param path  checkpoint file
+ */
+void checkpoint_init(machine_t *m, u64 every, const char *path) {
+    checkpoint_t *c = &m->checkpoint;
+    c->every = every;
+    c->next = m->state.instret + every;
+    c->path = path;
+
+    mmu_t *mmu = &m->mmu;
+    mmu->track_prot = calloc(NUM_PAGES, 1);
+    mmu->track_dirty = calloc(NUM_CHUNKS, 1);
+    if (!mmu->track_prot || !mmu->track_dirty) fatal("calloc failed.");
+    checkpoint_mmu = mmu;
+
+    checkpoint_writer_t *w = calloc(1, sizeof(checkpoint_writer_t));
+    if (!w || asprintf(&w->tmp, "%s.new", path) < 0) fatal("malloc failed.");
+    w->fd = -1;
+    w->path = path;
+    pthread_mutex_init(&w->lock, NULL);
+    pthread_cond_init(&w->cond, NULL);
+    if (pthread_create(&w->thread, NULL, checkpoint_writer, w)) fatal("pthread_create failed.");
+    c->writer = w;
+}
+
+// mapped regions of the guest window, from the host mappings, with the
+// protection of the guest where the tracker write protected them
+static checkpoint_region_t *checkpoint_regions(mmu_t *mmu, u64 *n) {
+    FILE *maps = fopen("/proc/self/maps", "re");
+    if (!maps) fatal(strerror(errno));
+
+    checkpoint_buf_t regions = {0};
+    u8 *tracked = mmu->track_prot;
+    char *line = NULL;
+    size_t size = 0;
+    while (getline(&line, &size, maps) > 0) {
+        u64 start, end, inode;
+        char perms[5];
+        if (sscanf(line, "%lx-%lx %4s %*x %*x:%*x %lu", &start, &end, perms, &inode) != 4) continue;
+        start = MAX(start, TO_HOST(mmu, 0));
+        end = MIN(end, GUEST_END(mmu));
+        u8 prot = (perms[0] == 'r' ? PROT_READ : 0) | (perms[1] == 'w' ? PROT_WRITE : 0) |
+                  (perms[2] == 'x' ? PROT_EXEC : 0);
+        // the reservation around the mappings is PROT_NONE
+        if (start >= end || !prot) continue;
+
+        u64 last = TO_GUEST(mmu, end) / GUEST_PAGE_SIZE;
+        for (u64 page = TO_GUEST(mmu, start) / GUEST_PAGE_SIZE; page < last;) {
+            u8 guest = tracked[page] ? tracked[page] : prot;
+            u64 run = page + 1;
+            while (run < last && (tracked[run] ? tracked[run] : prot) == guest) run++;
+            checkpoint_region_t region = {page * GUEST_PAGE_SIZE, run * GUEST_PAGE_SIZE, guest, inode == 0};
+            checkpoint_put(&regions, &region, sizeof(region));
+            page = run;
+        }
+    }
+    free(line);
+    fclose(maps);
+    *n = regions.len / sizeof(checkpoint_region_t);
+    return (checkpoint_region_t *) regions.data;
+}
+
+// pagemap entries of the pages of a region, NULL if the host does not tell
+static u64 *checkpoint_pagemap(mmu_t *mmu, checkpoint_region_t *region) {
+    int fd = open("/proc/self/pagemap", O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return NULL;
+    u64 len = (region->end - region->start) / GUEST_PAGE_SIZE * sizeof(u64);
+    u64 *entries = malloc(len);
+    if (entries && pread(fd, entries, len, TO_HOST(mmu, region->start) / GUEST_PAGE_SIZE * sizeof(u64)) != (ssize_t) len) {
+        free(entries);
+        entries = NULL;
+    }
+    close(fd);
+    return entries;
+}
+
+// the machine section of a record
+static void checkpoint_machine(machine_t *m, checkpoint_buf_t *b) {
+    checkpoint_put(b, &m->state, sizeof(state_t));
+    checkpoint_put(b, &m->mmu, sizeof(mmu_t));
+    checkpoint_put(b, m->mmu.ranges, m->mmu.nranges * sizeof(range_t));
+
+    u64 ncsr = 0;
+    for (u32 i = 0; i < CSR_NUM_PAGES; i++) ncsr += m->state.csr.pages[i] != NULL;
+    checkpoint_put(b, &ncsr, sizeof(ncsr));
+    for (u64 i = 0; i < CSR_NUM_PAGES; i++) {
+        if (!m->state.csr.pages[i]) continue;
+        checkpoint_put(b, &i, sizeof(i));
+        checkpoint_put(b, m->state.csr.pages[i], CSR_PAGE_SIZE * sizeof(u64));
+    }
+
+    u64 nfds = 0;
+    for (int fd = 0; fd < GUEST_MAX_FDS; fd++) nfds += m->fds[fd] >= 0;
+    checkpoint_put(b, &nfds, sizeof(nfds));
+    for (int fd = 0; fd < GUEST_MAX_FDS; fd++) {
+        int host_fd = m->fds[fd];
+        if (host_fd < 0) continue;
+        checkpoint_fd_t entry = {.fd = fd, .host_fd = host_fd, .offset = -1};
+        char path[PATH_MAX];
+        if (host_fd > STDERR_FILENO) {
+            char link[64];
+            snprintf(link, sizeof(link), "/proc/self/fd/%d", host_fd);
+            ssize_t len = readlink(link, path, sizeof(path));
+            entry.path_len = len > 0 ? len : 0;
+            entry.flags = fcntl(host_fd, F_GETFL);
+            entry.offset = lseek(host_fd, 0, SEEK_CUR);
+        }
+        checkpoint_put(b, &entry, sizeof(entry));
+        checkpoint_put(b, path, entry.path_len);
+    }
+}
+
+static bool checkpoint_zero(const u8 *page) {
+    const u64 *words = (const u64 *) page;
+    for (u64 i = 0; i < GUEST_PAGE_SIZE / sizeof(u64); i++) {
+        if (words[i]) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief take a checkpoint, the guest is stopped at a syscall
+ *
+ * The pages are copied and the writable memory protected again before the
+ * guest goes on, the record is written in the background.
+ *
+ * @param m pointer to machine, after the syscall
+ */
+void checkpoint_take(machine_t *m) {
+    checkpoint_t *c = &m->checkpoint;
+    mmu_t *mmu = &m->mmu;
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    // a single record in flight, the one before must be out first
+    checkpoint_wait(c->writer);
+    console_flush(&m->console);
+    bool full = !c->taken;
+
+    u64 nregions;
+    checkpoint_region_t *regions = checkpoint_regions(mmu, &nregions);
+
+    checkpoint_header_t header = {
+        .magic = CHECKPOINT_MAGIC,
+        .version = CHECKPOINT_VERSION,
+        .state_size = sizeof(state_t),
+        .mmu_size = sizeof(mmu_t),
+        .full = full,
+        .instret = m->state.instret,
+        .nregions = nregions,
+    };
+    checkpoint_buf_t b = {0};
+    checkpoint_put(&b, &header, sizeof(header));
+    checkpoint_machine(m, &b);
+    header.machine_size = b.len - sizeof(header);
+    checkpoint_put(&b, regions, nregions * sizeof(checkpoint_region_t));
+
+    for (u64 i = 0; i < nregions; i++) {
+        // a full record skips the anonymous pages never touched without reading them
+        u64 *pagemap = full && regions[i].anon ? checkpoint_pagemap(mmu, &regions[i]) : NULL;
+        for (u64 addr = regions[i].start; addr < regions[i].end; addr += GUEST_PAGE_SIZE) {
+            if (!full && !mmu->track_dirty[addr / CHECKPOINT_CHUNK]) continue;
+            // neither present nor swapped
+            if (pagemap && !(pagemap[(addr - regions[i].start) / GUEST_PAGE_SIZE] >> 62)) continue;
+            u8 *page = (u8 *) TO_HOST(mmu, addr);
+            if (full && checkpoint_zero(page)) continue;
+            checkpoint_put(&b, &addr, sizeof(addr));
+            checkpoint_put(&b, page, GUEST_PAGE_SIZE);
+            header.npages++;
+        }
+        free(pagemap);
+    }
+    memcpy(b.data, &header, sizeof(header));
+
+    // write protect the writable memory written since the last checkpoint or
+    // mapped since, the first write to a chunk of it marks the chunk dirty
+    memset(mmu->track_dirty, 0, NUM_CHUNKS);
+    u8 *tracked = mmu->track_prot;
+    for (u64 i = 0; i < nregions; i++) {
+        checkpoint_region_t *region = &regions[i];
+        if (!(region->prot & PROT_WRITE)) continue;
+        u64 last = region->end / GUEST_PAGE_SIZE;
+        for (u64 page = region->start / GUEST_PAGE_SIZE; page < last;) {
+            if (tracked[page]) {
+                page++;
+                continue;
+            }
+            u64 run = page + 1;
+            while (run < last && !tracked[run]) run++;
+            if (mprotect((void *) TO_HOST(mmu, page * GUEST_PAGE_SIZE), (run - page) * GUEST_PAGE_SIZE,
+                         region->prot & ~PROT_WRITE) < 0) {
+                fatal(strerror(errno));
+            }
+            memset(&tracked[page], region->prot, run - page);
+            page = run;
+        }
+    }
+    free(regions);
+
+    checkpoint_writer_t *w = c->writer;
+    pthread_mutex_lock(&w->lock);
+    w->job = b;
+    w->full = full;
+    pthread_cond_broadcast(&w->cond);
+    pthread_mutex_unlock(&w->lock);
+
+    c->taken++;
+    c->pages += header.npages;
+    c->bytes += b.len;
+    c->next = m->state.instret + c->every;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    c->pause += (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+}
+
+/**
+ * @brief wait for the last record to be written and stop the writer
+ *
+ * @param m pointer to machine
+ */
+void checkpoint_finish(machine_t *m) {
+    checkpoint_writer_t *w = m->checkpoint.writer;
+    if (!w) return;
+    checkpoint_wait(w);
+    pthread_mutex_lock(&w->lock);
+    w->done = true;
+    pthread_cond_broadcast(&w->cond);
+    pthread_mutex_unlock(&w->lock);
+    pthread_join(w->thread, NULL);
+    if (w->fd >= 0) close(w->fd);
+    free(w->tmp);
+    free(w);
+    m->checkpoint.writer = NULL;
+}
+
+// read exactly len bytes at offset
+static void checkpoint_read(int fd, void *buf, u64 len, u64 offset) {
+    for (u64 done = 0; done < len;) {
+        ssize_t n = pread(fd, (u8 *) buf + done, len - done, offset + done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) fatal("truncated checkpoint");
+        done += n;
+    }
+}
+
+// take len bytes of the machine section
+static void checkpoint_get(const u8 **at, const u8 *end, void *data, u64 len) {
+    if (len > (u64) (end - *at)) fatal("bad checkpoint");
+    memcpy(data, *at, len);
+    *at += len;
+}
+
+// bytes of a record, 0 if it does not fit in limit bytes
+static u64 checkpoint_record_size(checkpoint_header_t *header, u64 limit) {
+    u64 page_size = sizeof(u64) + GUEST_PAGE_SIZE;
+    if (header->machine_size > limit || header->nregions > limit / sizeof(checkpoint_region_t) ||
+        header->npages > limit / page_size) {
+        return 0;
+    }
+    u64 size = sizeof(checkpoint_header_t) + header->machine_size + header->nregions * sizeof(checkpoint_region_t) +
+               header->npages * page_size;
+    return size <= limit ? size : 0;
+}
+
+// the machine of the last record, in a new guest window
+static void checkpoint_load_machine(machine_t *m, const u8 *at, const u8 *end) {
+    // host pointers of the state are the ones of this machine
+    u8 *cov_map = m->state.cov_map;
+    checkpoint_get(&at, end, &m->state, sizeof(state_t));
+    m->state.cov_map = cov_map;
+    m->state.block = NULL;
+    memset(&m->state.csr, 0, sizeof(csr_file_t));
+
+    mmu_t saved;
+    checkpoint_get(&at, end, &saved, sizeof(mmu_t));
+
+    // the memory policy is the one of the command line
+    mmu_t *mmu = &m->mmu;
+    mmu_init(mmu);
+    mmu->entry = saved.entry;
+    mmu->host_alloc = mmu->mem + TO_GUEST(&saved, saved.host_alloc);
+    mmu->base = saved.base;
+    mmu->alloc = saved.alloc;
+    mmu->heap = saved.heap;
+    mmu->heap_limit = saved.heap_limit;
+    mmu->mmap_base = saved.mmap_base;
+    mmu->dirty = saved.dirty;
+    mmu->brks = saved.brks;
+    mmu->maps = saved.maps;
+    mmu->unmaps = saved.unmaps;
+    mmu->page_maps = saved.page_maps;
+    mmu->page_unmaps = saved.page_unmaps;
+    mmu->huge_fallbacks = saved.huge_fallbacks;
+    if (saved.nranges > mmu->ranges_size) {
+        mmu->ranges_size = saved.nranges;
+        mmu->ranges = realloc(mmu->ranges, mmu->ranges_size * sizeof(range_t));
+        if (!mmu->ranges) fatal("realloc failed.");
+    }
+    mmu->nranges = saved.nranges;
+    checkpoint_get(&at, end, mmu->ranges, mmu->nranges * sizeof(range_t));
+
+    m->state.mem = mmu->mem;
+    u64 ncsr;
+    checkpoint_get(&at, end, &ncsr, sizeof(ncsr));
+    for (u64 i = 0, page; i < ncsr; i++) {
+        checkpoint_get(&at, end, &page, sizeof(page));
+        if (page >= CSR_NUM_PAGES) fatal("bad checkpoint");
+        m->state.csr.pages[page] = malloc(CSR_PAGE_SIZE * sizeof(u64));
+        if (!m->state.csr.pages[page]) fatal("malloc failed.");
+        checkpoint_get(&at, end, m->state.csr.pages[page], CSR_PAGE_SIZE * sizeof(u64));
+    }
+    mmu_sfence(&m->state, 0, 0, true, true);
+
+    syscall_init(m);
+    for (int fd = 0; fd < GUEST_MAX_FDS; fd++) m->fds[fd] = -1;
+    u64 nfds;
+    checkpoint_get(&at, end, &nfds, sizeof(nfds));
+    for (u64 i = 0; i < nfds; i++) {
+        checkpoint_fd_t entry;
+        char path[PATH_MAX];
+        checkpoint_get(&at, end, &entry, sizeof(entry));
+        if (entry.fd < 0 || entry.fd >= GUEST_MAX_FDS || entry.path_len >= sizeof(path)) fatal("bad checkpoint");
+        checkpoint_get(&at, end, path, entry.path_len);
+        path[entry.path_len] = '\0';
+        if (entry.host_fd <= STDERR_FILENO) {
+            m->fds[entry.fd] = entry.host_fd;
+            continue;
+        }
+
+        // the file is opened again as it is, never created nor truncated
+        int flags = (entry.flags & (O_ACCMODE | O_APPEND | O_NONBLOCK | O_SYNC)) | O_CLOEXEC;
+        int host_fd = open(path, flags);
+        if (host_fd < 0 || (entry.offset >= 0 && lseek(host_fd, entry.offset, SEEK_SET) < 0)) {
+            fprintf(stderr, "warning: guest fd %d not restored, %s: %s\n", entry.fd, path, strerror(errno));
+            if (host_fd >= 0) close(host_fd);
+            continue;
+        }
+        m->fds[entry.fd] = host_fd;
+    }
+}
+
+/**
+ * @brief restore a machine from the last checkpoint of a file
+ *
+ * Takes the place of the loading and the setup of the guest.
+ *
+ * @param m    pointer to machine, with the options of the command line
+ * @param path checkpoint file
+ */
+void checkpoint_restore(machine_t *m, const char *path) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) < 0) fatalf("%s: %s", path, strerror(errno));
+
+    // the full record and the ones after it, the last one may be cut short
+    checkpoint_header_t header;
+    u64 last = 0, records = 0;
+    for (u64 offset = 0, size; offset + sizeof(header) <= (u64) st.st_size; offset += size) {
+        checkpoint_read(fd, &header, sizeof(header), offset);
+        if (header.magic != CHECKPOINT_MAGIC || header.version != CHECKPOINT_VERSION ||
+            header.state_size != sizeof(state_t) || header.mmu_size != sizeof(mmu_t)) {
+            fatalf("%s: not a checkpoint of this rvemu", path);
+        }
+        if (header.full != !offset) fatalf("%s: bad checkpoint", path);
+        size = checkpoint_record_size(&header, st.st_size - offset);
+        if (!size) break;
+        last = offset;
+        records++;
+    }
+    if (!records) fatalf("%s: no complete checkpoint", path);
+
+    checkpoint_read(fd, &header, sizeof(header), last);
+    u8 *machine = malloc(header.machine_size);
+    checkpoint_region_t *regions = malloc(header.nregions * sizeof(checkpoint_region_t) + 1);
+    if (!machine || !regions) fatal("malloc failed.");
+    checkpoint_read(fd, machine, header.machine_size, last + sizeof(header));
+    checkpoint_read(fd, regions, header.nregions * sizeof(checkpoint_region_t), last + sizeof(header) + header.machine_size);
+    u64 nregions = header.nregions;
+    checkpoint_load_machine(m, machine, machine + header.machine_size);
+    free(machine);
+
+    mmu_t *mmu = &m->mmu;
+    for (u64 i = 0; i < nregions; i++) {
+        u64 start = regions[i].start, len = regions[i].end - start;
+        if (regions[i].end <= start || regions[i].end > GUEST_MEMORY_SIZE || start % GUEST_PAGE_SIZE) {
+            fatalf("%s: bad checkpoint", path);
+        }
+        if (mmap((void *) TO_HOST(mmu, start), len, PROT_READ | PROT_WRITE,
+                 MAP_ANONYMOUS | MAP_PRIVATE | MAP_FIXED, -1, 0) == MAP_FAILED) {
+            fatal(strerror(errno));
+        }
+        mmu_bind(mmu, start, len);
+    }
+
+    // the pages of every record in order, a later one over an earlier one,
+    // the pages outside of the last regions were unmapped since
+    u64 batch = 256, page_size = sizeof(u64) + GUEST_PAGE_SIZE;
+    u8 *pages = malloc(batch * page_size);
+    if (!pages) fatal("malloc failed.");
+    for (u64 offset = 0, n = 0; n < records; n++) {
+        checkpoint_read(fd, &header, sizeof(header), offset);
+        u64 at = offset + sizeof(header) + header.machine_size + header.nregions * sizeof(checkpoint_region_t);
+        for (u64 done = 0; done < header.npages;) {
+            u64 count = MIN(batch, header.npages - done);
+            checkpoint_read(fd, pages, count * page_size, at + done * page_size);
+            for (u64 j = 0; j < count; j++) {
+                u64 addr = *(u64 *) (pages + j * page_size);
+                for (u64 i = 0; i < nregions; i++) {
+                    if (addr < regions[i].start || addr >= regions[i].end) continue;
+                    memcpy((void *) TO_HOST(mmu, addr), pages + j * page_size + sizeof(u64), GUEST_PAGE_SIZE);
+                    break;
+                }
+            }
+            done += count;
+        }
+        offset += checkpoint_record_size(&header, st.st_size - offset);
+    }
+    free(pages);
+    close(fd);
+
+    for (u64 i = 0; i < nregions; i++) {
+        if (mprotect((void *) TO_HOST(mmu, regions[i].start), regions[i].end - regions[i].start, regions[i].prot) < 0) {
+            fatal(strerror(errno));
+        }
+    }
+    free(regions);
+
+    trap_init();
+    machine_flush(m);
+    if (m->stats) perf_open(&m->perf);
+    clock_gettime(CLOCK_MONOTONIC, &m->start);
+}
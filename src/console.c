@@ -0,0 +1,91 @@
+#include "rvemu.h"
+
+/**
+ * Guest console
+ *
+ * Guest writes to stdout and stderr are gathered in one buffer instead of
+ * making a host write each. Both streams share the buffer, so their output
+ * keeps its order when they go to the same place. The buffer is written out
+ * when it is full, when the guest writes to the other stream, at a newline if
+ * the stream is a terminal, before the guest reads stdin, and when the guest
+ * exits or is stopped.
+ *
+ * The streams are the host fds STDOUT_FILENO and STDERR_FILENO in m->fds,
+ * written to the emulator's own stdout and stderr, or to the fds in out
+ * when the output of the guest is captured (see batch.c).
+ */
+
+/**
+ * @brief set up the buffer, unless the console is unbuffered
+ *
+ * @param console guest console
+ */
+void console_init(console_t *console) {
+    for (int fd = STDOUT_FILENO; fd <= STDERR_FILENO; fd++) {
+        if (!console->out[fd]) console->out[fd] = fd;
+        console->tty[fd] = isatty(console->out[fd]);
+    }
+    console->fd = STDOUT_FILENO;
+    if (console->unbuffered) return;
+    console->buf = malloc(CONSOLE_BUFFER_SIZE);
+    if (!console->buf) fatal("malloc failed.");
+}
+
+// write all of buf to a stream
+static i64 console_put(console_t *console, int fd, u8 *buf, u64 len) {
+    u64 done = 0;
+    while (done < len) {
+        ssize_t n = write(console->out[fd], buf + done, len - done);
+        console->host_writes++;
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -errno;
+        }
+        done += n;
+    }
+    return len;
+}
+
+/**
+ * @brief write the buffered output to the host
+ *
+ * @param console guest console
+ * @return i64 0 or -errno, the buffered output is dropped on errors
+ */
+i64 console_flush(console_t *console) {
+    if (!console->len) return 0;
+    i64 ret = console_put(console, console->fd, console->buf, console->len);
+    console->len = 0;
+    return ret < 0 ? ret : 0;
+}
+
+/**
+ * @brief guest write to stdout or stderr
+ *
+ * @param console guest console
+ * @param fd      stream, STDOUT_FILENO or STDERR_FILENO
+ * @param buf     guest data
+ * @param len     bytes to write
+ * @return i64    len or -errno
+ */
+i64 console_write(console_t *console, int fd, void *buf, u64 len) {
+    console->writes++;
+    if (!console->buf) return console_put(console, fd, buf, len);
+
+    i64 ret = 0;
+    if (console->fd != fd || console->len + len > CONSOLE_BUFFER_SIZE) {
+        ret = console_flush(console);
+        console->fd = fd;
+    }
+    if (ret < 0) return ret;
+
+    // output larger than the buffer is not worth a copy
+    if (len >= CONSOLE_BUFFER_SIZE) return console_put(console, fd, buf, len);
+
+    // the guest may pass memory it has not mapped, like write(2) it gets EFAULT
+    u8 *out = console->buf + console->len;
+    if (trap_copy(out, buf, len) < 0) return -EFAULT;
+    console->len += len;
+    if (console->tty[fd] && memchr(out, '\n', len)) ret = console_flush(console);
+    return ret < 0 ? ret : (i64) len;
+}
@@ -0,0 +1,52 @@
+#include <sys/shm.h>
+#include "rvemu.h"
+
+/**
+ * Edge coverage
+ *
+ * With --coverage every block entered counts the edge from the previous block
+ * in a map of COVERAGE_MAP_SIZE bytes, the way AFL instruments its targets:
+ *
+ *   map[loc(pc) ^ prev]++, prev = loc(pc) >> 1
+ *
+ * where loc hashes the pc of the block (see coverage_loc). The interpreter
+ * counts the edges in machine_step, the JIT in the code of each block, so
+ * that blocks chained to each other count theirs too. Without --coverage
+ * neither has any code for it.
+ *
+ * The map is the shared memory segment of afl-fuzz when __AFL_SHM_ID is set,
+ * so that afl-fuzz reads the edges of rvemu as those of an instrumented
+ * target, and runs its fork server with --fork-server (see snapshot.c).
+ */
+
+/**
+ * @brief attach the coverage map, the shared memory of afl-fuzz if there is one
+ *
+ * @param m pointer to machine, before its first block
+ */
+void coverage_init(machine_t *m) {
+    const char *id = getenv("__AFL_SHM_ID");
+    if (id) {
+        void *map = shmat(atoi(id), NULL, 0);
+        if (map == (void *) -1) fatalf("__AFL_SHM_ID %s: %s", id, strerror(errno));
+        m->state.cov_map = map;
+        // afl-fuzz waits for the fork server on its control pipe
+        m->snapshot.afl = fcntl(AFL_FORKSRV_FD + 1, F_GETFD) != -1;
+    } else {
+        m->state.cov_map = calloc(COVERAGE_MAP_SIZE, 1);
+        if (!m->state.cov_map) fatal("calloc failed.");
+    }
+    m->jit.coverage = true;
+}
+
+/**
+ * @brief number of edges hit, hashes colliding in the map count once
+ *
+ * @param m pointer to machine
+ * @return u64 entries of the map not zero
+ */
+u64 coverage_edges(machine_t *m) {
+    u64 edges = 0;
+    for (u64 i = 0; i < COVERAGE_MAP_SIZE; i++) edges += m->state.cov_map[i] != 0;
+    return edges;
+}
@@ -0,0 +1,93 @@
+#include "rvemu.h"
+
+/**
+ * @brief read a CSR register
+ *
+ * The counters read the retired instructions, one per cycle, and the time of
+ * csr_time. mip has the supervisor timer interrupt pending once time reaches
+ * stimecmp, if the guest has written it.
+ *
+ * @param state CPU state
+ * @param csr   CSR number
+ * @return u64  value of the register, zero if it has never been written
+ */
+u64 csr_read(state_t *state, u16 csr) {
+    switch (csr) {
+        case cycle_id: case instret_id: case mcycle_id: case minstret_id:
+            return state->instret;
+        case time_id:
+            return csr_time(state);
+    }
+
+    u64 *page = state->csr.pages[csr / CSR_PAGE_SIZE];
+    u64 value = page ? page[csr % CSR_PAGE_SIZE] : 0;
+    if (csr == mip_id && state->stimecmp_set && csr_time(state) >= csr_read(state, stimecmp_id)) value |= mip_stip_mask;
+    return value;
+}
+
+/**
+ * @brief write a CSR register, allocating its page on the first write
+ *
+ * Writes of satp selecting an unsupported translation mode have no effect.
+ *
+ * @param state CPU state
+ * @param csr   CSR number
+ * @param value new value of the register
+ */
+void csr_write(state_t *state, u16 csr, u64 value) {
+    if (csr == stimecmp_id) state->stimecmp_set = true;
+
+    // only the Bare and Sv39 modes are supported, other writes are ignored
+    if (csr == satp_id) {
+        u64 mode = csr_get(satp, mode, value);
+        if (mode != satp_mode_bare && mode != satp_mode_sv39) return;
+    }
+
+    u64 **page = &state->csr.pages[csr / CSR_PAGE_SIZE];
+    if (!*page) {
+        if (!value) return;
+        *page = calloc(CSR_PAGE_SIZE, sizeof(u64));
+        if (!*page) fatal("calloc failed.");
+    }
+    (*page)[csr % CSR_PAGE_SIZE] = value;
+}
+
+/**
+ * @brief the time CSR, ticking at TIMEBASE_MHZ
+ *
+ * With --icount the guest time is its retired instructions at mhz MHz.
+ * Instructions are counted by block (see machine_step), the time read in a
+ * block includes the whole block. Without --icount time is a plain register,
+ * zero unless the guest writes it: the host time would differ at each run,
+ * and --replay could not give it back as the instructions reading it are not
+ * syscalls.
+ *
+ * @param state CPU state
+ * @return u64  ticks since the guest started with --icount, the register otherwise
+ */
+u64 csr_time(state_t *state) {
+    if (state->mhz) return (unsigned __int128) state->instret * TIMEBASE_MHZ / state->mhz;
+    u64 *page = state->csr.pages[time_id / CSR_PAGE_SIZE];
+    return page ? page[time_id % CSR_PAGE_SIZE] : 0;
+}
+
+/**
+ * @brief recompute when the timer interrupt is taken, after a change of stimecmp, mie, mstatus or priv
+ *
+ * With --icount the supervisor timer interrupt is taken at the first block
+ * starting once time reaches stimecmp, if mie.STIE is set and interrupts are
+ * enabled: below machine mode, or with mstatus.MIE, and once the guest has
+ * written stimecmp. There is no delegation, it goes to the machine mode
+ * handler (see trap_interrupt). Without --icount the timer never fires.
+ *
+ * @param state CPU state
+ */
+void csr_timer_update(state_t *state) {
+    state->timer = UINT64_MAX;
+    if (!state->mhz || !state->stimecmp_set || !(csr_read(state, mie_id) & mip_stip_mask)) return;
+    if (state->priv == priv_m && !csr_get(mstatus, mie, csr_read(state, mstatus_id))) return;
+
+    // first count whose time, instret * TIMEBASE_MHZ / mhz, reaches stimecmp
+    unsigned __int128 at = ((unsigned __int128) csr_read(state, stimecmp_id) * state->mhz + TIMEBASE_MHZ - 1) / TIMEBASE_MHZ;
+    state->timer = at < UINT64_MAX ? at : UINT64_MAX;
+}
@@ -8,6 +8,21 @@
 #define  frm            0x002
 #define  fcsr           0x003
 
+// Supervisor Protection and Translation
+#define satp_id         0x180
+
+// Supervisor Timer Compare (Sstc)
+#define stimecmp_id     0x14D
+
+// Unprivileged Counter/Timers
+#define cycle_id        0xC00
+#define time_id         0xC01
+#define instret_id      0xC02
+
+// Machine Counter/Timers
+#define mcycle_id       0xB00
+#define minstret_id     0xB02
+
 // Machine Trap Setup
  #define mstatus_id     0x300
  #define misa_id        0x301
@@ -52,6 +67,12 @@
 #define mstatus_mpv_pos             39
 #define mstatus_mpv_mask            csr_gen_mask64(0x1, mstatus_mpv_pos)
 
+#define mstatus_mxr_pos             19
+#define mstatus_mxr_mask            csr_gen_mask64(0x1, mstatus_mxr_pos)
+
+#define mstatus_sum_pos             18
+#define mstatus_sum_mask            csr_gen_mask64(0x1, mstatus_sum_pos)
+
 #define mstatus_mpp_pos             11
 #define mstatus_mpp_mask            csr_gen_mask64(0x3, mstatus_mpp_pos)
 
@@ -62,3 +83,27 @@
 #define mstatus_mie_mask            csr_gen_mask64(0x1, mstatus_mie_pos)
 
 // - end of mstatus - //
+
+// - start of mip and mie - //
+#define mip_stip_pos                5
+#define mip_stip_mask               csr_gen_mask64(0x1, mip_stip_pos)
+// - end of mip and mie - //
+
+// - start of mcause - //
+#define mcause_interrupt_pos        63
+#define mcause_interrupt_mask       csr_gen_mask64(0x1, mcause_interrupt_pos)
+// - end of mcause - //
+
+// - start of satp - //
+#define satp_mode_pos               60
+#define satp_mode_mask              csr_gen_mask64(0xF, satp_mode_pos)
+
+#define satp_asid_pos               44
+#define satp_asid_mask              csr_gen_mask64(0xFFFF, satp_asid_pos)
+
+#define satp_ppn_pos                0
+#define satp_ppn_mask               csr_gen_mask64(0xFFFFFFFFFFF, satp_ppn_pos)
+
+#define satp_mode_bare              0
+#define satp_mode_sv39              8
+// - end of satp - //
@@ -1,32 +1,21 @@
 #include "rvemu.h"
-
-#define QUADRANT(data) (((data) >> 0) & 0x3)
+#include "decode_table.h"
 
 /////////////////////////////////////////
 // Macros to decode instructions
 /////////////////////////////////////////
 
-// ignored lower 2 bits for the opcode field
-#define OPCODE(data)        (((data) >> 2)  & 0x1F)
 #define RD(data)            (((data) >> 7)  & 0x1F)
 #define RS1(data)           (((data) >> 15) & 0x1F)
 #define RS2(data)           (((data) >> 20) & 0x1F)
 #define RS3(data)           (((data) >> 27) & 0x1F)
-#define FUNCT2(data)        (((data) >> 25) & 0x3)
-#define FUNCT3(data)        (((data) >> 12) & 0x7)
-#define FUNCT7(data)        (((data) >> 25) & 0x7F)
-#define IMM116(data)        (((data) >> 26) & 0x3F)
-#define INST31_20(data)     (((data) >> 20) & 0xFFF)
-#define C_FUNCT2(data)      (((data) >> 10) & 0x3)
-#define C_FUNCT3(data)      (((data) >> 13) & 0x7)
-#define C_FUNCT4(data)      (((data) >> 12) & 0xF)
 #define C_RS1(data)         (((data) >> 7) & 0x1F)
 #define C_RS2(data)         (((data) >> 2) & 0x1F)
 #define C_RD(data)          (((data) >> 7) & 0x1F)
-#define C_RS1_(data)        (((data) >> 7) & 0x7)
-#define C_RS2_(data)        (((data) >> 2) & 0x7)
-#define C_RD_(data)         (((data) >> 2) & 0x7)
-#define C_FUNCT_6_5(data)   (((data) >> 5) & 0x3)
+// 3 bits register fields of the RVC instructions, they name x8 to x15
+#define C_RS1_(data)        ((((data) >> 7) & 0x7) + 8)
+#define C_RS2_(data)        ((((data) >> 2) & 0x7) + 8)
+#define C_RD_(data)         ((((data) >> 2) & 0x7) + 8)
 
 
 
@@ -42,13 +31,13 @@
 // Extract immediate values from instruction and do an unsigned extension
 #define EXTRACT_IMM_UNSIGNED(inst, imm_h, imm_l, inst_l) \
     ((u32) (inst & IMM_MASK(imm_h, imm_l, inst_l)) >> (inst_l)) << (imm_l)
-// Extract immediate values from instruction and do a signed extension
+// Extract immediate values from instruction and do a signed extension, the
+// field is moved to the top bits first so that its high bit is the sign bit
 #define EXTRACT_IMM_SIGNED(inst, imm_h, imm_l, inst_l) \
-    ((i32) (inst & IMM_MASK(imm_h, imm_l, inst_l)) >> (inst_l)) << (imm_l)
+    (((i32) ((u32) (inst) << (31 - (inst_l) - ((imm_h) - (imm_l)))) >> (31 - ((imm_h) - (imm_l)))) << (imm_l))
 
 // Macros for invalid instructions
 #define invalid_instruction() fatalf("Invalid Instruction: %x", raw_inst)
-#define UNIMPL_INST() fatalf("unimplemented. Instruction = %x", raw_inst)
 
 
 
@@ -75,7 +64,6 @@ static inline inst_t inst_r4_type(u32 inst) {
 static inline inst_t inst_i_type(u32 inst) {
     i32 imm = 0;
     imm = imm | EXTRACT_IMM_SIGNED(inst, 11, 0, 20);   // imm[11:0] -> inst[31:20] - 12 bits
-    //printf("imm1 = %x\n", imm);
     return (inst_t) {
         .imm = imm,
         .rs1 = RS1(inst),
@@ -137,686 +125,452 @@ static inline inst_t inst_j_type(u32 inst) {
 
 
 // Zicsr type instructions
+// rs1 holds either the source register or the zimm
 static inline inst_t inst_csr_type(u32 inst) {
-    u32 imm = EXTRACT_IMM_UNSIGNED(inst, 4, 0, 15);
     return (inst_t) {
-        .imm = imm,
-        .csr = (inst >> 20) & 0xFFF,
+        .imm = (inst >> 20) & 0xFFF,
         .rs1 = RS1(inst),
         .rd = RD(inst),
     };
 }
 
+
+// RVC instructions
+// Refer to riscv-spec-20191213.pdf 16.8 RVC Instruction Set Listings
+// Register-immediate instructions keep rs1 == rd, the handlers use either.
+
+// CR type: c.jr, c.jalr, c.mv, c.add
+static inline inst_t inst_cr_type(u32 inst) {
+    return (inst_t) {
+        .rs1 = C_RS1(inst),
+        .rs2 = C_RS2(inst),
+        .rd = C_RD(inst),
+    };
+}
+
+// CI type with a signed 6 bits immediate: c.li, c.addi, c.addiw
+static inline inst_t inst_ci_type(u32 inst) {
+    i32 imm = 0;
+    imm = imm | EXTRACT_IMM_SIGNED(inst, 5, 5, 12);     // imm[5]    - inst[12]    - 1 bits
+    imm = imm | EXTRACT_IMM_UNSIGNED(inst, 4, 0, 2);    // imm[4:0]  - inst[6:2]   - 5 bits
+    return (inst_t) {
+        .imm = imm,
+        .rs1 = C_RS1(inst),
+        .rd = C_RD(inst),
+    };
+}
+
+// CI type with a shift amount: c.slli
+static inline inst_t inst_ci_sh_type(u32 inst) {
+    i32 imm = 0;
+    imm = imm | EXTRACT_IMM_UNSIGNED(inst, 5, 5, 12);   // shamt[5]   - inst[12]  - 1 bits
+    imm = imm | EXTRACT_IMM_UNSIGNED(inst, 4, 0, 2);    // shamt[4:0] - inst[6:2] - 5 bits
+    return (inst_t) {
+        .imm = imm,
+        .rs1 = C_RS1(inst),
+        .rd = C_RD(inst),
+    };
+}
+
+// CI type: c.lui
+static inline inst_t inst_ci_lui_type(u32 inst) {
+    i32 imm = 0;
+    imm = imm | EXTRACT_IMM_SIGNED(inst, 17, 17, 12);   // imm[17]    - inst[12]  - 1 bits
+    imm = imm | EXTRACT_IMM_UNSIGNED(inst, 16, 12, 2);  // imm[16:12] - inst[6:2] - 5 bits
+    return (inst_t) {
+        .imm = imm,
+        .rd = C_RD(inst),
+    };
+}
+
+// CI type: c.addi16sp, rd is always sp
+static inline inst_t inst_ci_16sp_type(u32 inst) {
+    i32 imm = 0;
+    imm = imm | EXTRACT_IMM_SIGNED(inst, 9, 9, 12);     // imm[9]   - inst[12]  - 1 bits
+    imm = imm | EXTRACT_IMM_UNSIGNED(inst, 4, 4, 6);    // imm[4]   - inst[6]   - 1 bits
+    imm = imm | EXTRACT_IMM_UNSIGNED(inst, 6, 6, 5);    // imm[6]   - inst[5]   - 1 bits
+    imm = imm | EXTRACT_IMM_UNSIGNED(inst, 8, 7, 3);    // imm[8:7] - inst[4:3] - 2 bits
+    imm = imm | EXTRACT_IMM_UNSIGNED(inst, 5, 5, 2);    // imm[5]   - inst[2]   - 1 bits
+    return (inst_t) {
+        .imm = imm,
+    };
+}
+
+// CI type: c.lwsp
+static inline inst_t inst_ci_lwsp_type(u32 inst) {
+    i32 imm = 0;
+    imm = imm | EXTRACT_IMM_UNSIGNED(inst, 4, 2, 4);    // imm[4:2] - inst[6:4] - 3 bits
+    imm = imm | EXTRACT_IMM_UNSIGNED(inst, 7, 6, 2);    // imm[7:6] - inst[3:2] - 2 bits
+    imm = imm | EXTRACT_IMM_UNSIGNED(inst, 5, 5, 12);   // imm[5]   - inst[12]  - 1 bits
+    return (inst_t) {
+        .imm = imm,
+        .rd = C_RD(inst),
+    };
+}
+
+// CI type: c.ldsp
+static inline inst_t inst_ci_ldsp_type(u32 inst) {
+    i32 imm = 0;
+    imm = imm | EXTRACT_IMM_UNSIGNED(inst, 4, 3, 5);    // imm[4:3] - inst[6:5] - 2 bits
+    imm = imm | EXTRACT_IMM_UNSIGNED(inst, 8, 6, 2);    // imm[8:6] - inst[4:2] - 3 bits
+    imm = imm | EXTRACT_IMM_UNSIGNED(inst, 5, 5, 12);   // imm[5]   - inst[12]  - 1 bits
+    return (inst_t) {
+        .imm = imm,
+        .rd = C_RD(inst),
+    };
+}
+
+// CSS type: c.swsp
+static inline inst_t inst_css_w_type(u32 inst) {
+    i32 imm = 0;
+    imm = imm | EXTRACT_IMM_UNSIGNED(inst, 5, 2, 9);    // imm[5:2] - inst[12:9] - 4 bits
+    imm = imm | EXTRACT_IMM_UNSIGNED(inst, 7, 6, 7);    // imm[7:6] - inst[8:7]  - 2 bits
+    return (inst_t) {
+        .imm = imm,
+        .rs2 = C_RS2(inst),
+    };
+}
+
+// CSS type: c.sdsp
+static inline inst_t inst_css_d_type(u32 inst) {
+    i32 imm = 0;
+    imm = imm | EXTRACT_IMM_UNSIGNED(inst, 5, 3, 10);   // imm[5:3] - inst[12:10] - 3 bits
+    imm = imm | EXTRACT_IMM_UNSIGNED(inst, 8, 6, 7);    // imm[8:6] - inst[9:7]   - 3 bits
+    return (inst_t) {
+        .imm = imm,
+        .rs2 = C_RS2(inst),
+    };
+}
+
+// CIW type: c.addi4spn
+static inline inst_t inst_ciw_type(u32 inst) {
+    i32 imm = 0;
+    imm = imm | EXTRACT_IMM_UNSIGNED(inst, 5, 4, 11);   // imm[5:4] - inst[12:11] - 2 bits
+    imm = imm | EXTRACT_IMM_UNSIGNED(inst, 9, 6, 7);    // imm[9:6] - inst[10:7]  - 4 bits
+    imm = imm | EXTRACT_IMM_UNSIGNED(inst, 2, 2, 6);    // imm[2]   - inst[6]     - 1 bits
+    imm = imm | EXTRACT_IMM_UNSIGNED(inst, 3, 3, 5);    // imm[3]   - inst[5]     - 1 bits
+    return (inst_t) {
+        .imm = imm,
+        .rd = C_RD_(inst),
+    };
+}
+
+// word offset of c.lw and c.sw
+static inline i32 inst_c_imm_w(u32 inst) {
+    i32 imm = 0;
+    imm = imm | EXTRACT_IMM_UNSIGNED(inst, 2, 2, 6);    // imm[2]   - inst[6]     - 1 bits
+    imm = imm | EXTRACT_IMM_UNSIGNED(inst, 5, 3, 10);   // imm[5:3] - inst[12:10] - 3 bits
+    imm = imm | EXTRACT_IMM_UNSIGNED(inst, 6, 6, 5);    // imm[6]   - inst[5]     - 1 bits
+    return imm;
+}
+
+// double word offset of c.ld and c.sd
+static inline i32 inst_c_imm_d(u32 inst) {
+    i32 imm = 0;
+    imm = imm | EXTRACT_IMM_UNSIGNED(inst, 5, 3, 10);   // imm[5:3] - inst[12:10] - 3 bits
+    imm = imm | EXTRACT_IMM_UNSIGNED(inst, 7, 6, 5);    // imm[7:6] - inst[6:5]   - 2 bits
+    return imm;
+}
+
+// CL type: c.lw, c.ld
+static inline inst_t inst_cl_type(u32 inst, i32 imm) {
+    return (inst_t) {
+        .imm = imm,
+        .rs1 = C_RS1_(inst),
+        .rd = C_RD_(inst),
+    };
+}
+
+// CS type: c.sw, c.sd
+static inline inst_t inst_cs_type(u32 inst, i32 imm) {
+    return (inst_t) {
+        .imm = imm,
+        .rs1 = C_RS1_(inst),
+        .rs2 = C_RS2_(inst),
+    };
+}
+
+// CA type: c.sub, c.xor, c.or, c.and, c.subw, c.addw
+static inline inst_t inst_ca_type(u32 inst) {
+    return (inst_t) {
+        .rs1 = C_RS1_(inst),
+        .rs2 = C_RS2_(inst),
+        .rd = C_RS1_(inst),
+    };
+}
+
+// CB type: c.beqz, c.bnez
+static inline inst_t inst_cb_type(u32 inst) {
+    i32 imm = 0;
+    imm = imm | EXTRACT_IMM_SIGNED(inst, 8, 8, 12);     // imm[8]   - inst[12]    - 1 bits
+    imm = imm | EXTRACT_IMM_UNSIGNED(inst, 4, 3, 10);   // imm[4:3] - inst[11:10] - 2 bits
+    imm = imm | EXTRACT_IMM_UNSIGNED(inst, 7, 6, 5);    // imm[7:6] - inst[6:5]   - 2 bits
+    imm = imm | EXTRACT_IMM_UNSIGNED(inst, 2, 1, 3);    // imm[2:1] - inst[4:3]   - 2 bits
+    imm = imm | EXTRACT_IMM_UNSIGNED(inst, 5, 5, 2);    // imm[5]   - inst[2]     - 1 bits
+    return (inst_t) {
+        .imm = imm,
+        .rs1 = C_RS1_(inst),
+    };
+}
+
+// CB type with a shift amount: c.srli, c.srai
+static inline inst_t inst_cb_sh_type(u32 inst) {
+    i32 imm = 0;
+    imm = imm | EXTRACT_IMM_UNSIGNED(inst, 5, 5, 12);   // shamt[5]   - inst[12]  - 1 bits
+    imm = imm | EXTRACT_IMM_UNSIGNED(inst, 4, 0, 2);    // shamt[4:0] - inst[6:2] - 5 bits
+    return (inst_t) {
+        .imm = imm,
+        .rs1 = C_RS1_(inst),
+        .rd = C_RS1_(inst),
+    };
+}
+
+// CB type with a signed immediate: c.andi
+static inline inst_t inst_cb_imm_type(u32 inst) {
+    i32 imm = 0;
+    imm = imm | EXTRACT_IMM_SIGNED(inst, 5, 5, 12);     // imm[5]   - inst[12]  - 1 bits
+    imm = imm | EXTRACT_IMM_UNSIGNED(inst, 4, 0, 2);    // imm[4:0] - inst[6:2] - 5 bits
+    return (inst_t) {
+        .imm = imm,
+        .rs1 = C_RS1_(inst),
+        .rd = C_RS1_(inst),
+    };
+}
+
+// CJ type: c.j
+static inline inst_t inst_cj_type(u32 inst) {
+    i32 imm = 0;
+    imm = imm | EXTRACT_IMM_SIGNED(inst, 11, 11, 12);   // imm[11]  - inst[12]    - 1 bits
+    imm = imm | EXTRACT_IMM_UNSIGNED(inst, 4, 4, 11);   // imm[4]   - inst[11]    - 1 bits
+    imm = imm | EXTRACT_IMM_UNSIGNED(inst, 9, 8, 9);    // imm[9:8] - inst[10:9]  - 2 bits
+    imm = imm | EXTRACT_IMM_UNSIGNED(inst, 10, 10, 8);  // imm[10]  - inst[8]     - 1 bits
+    imm = imm | EXTRACT_IMM_UNSIGNED(inst, 6, 6, 7);    // imm[6]   - inst[7]     - 1 bits
+    imm = imm | EXTRACT_IMM_UNSIGNED(inst, 7, 7, 6);    // imm[7]   - inst[6]     - 1 bits
+    imm = imm | EXTRACT_IMM_UNSIGNED(inst, 3, 1, 3);    // imm[3:1] - inst[5:3]   - 3 bits
+    imm = imm | EXTRACT_IMM_UNSIGNED(inst, 5, 5, 2);    // imm[5]   - inst[2]     - 1 bits
+    return (inst_t) {
+        .imm = imm,
+    };
+}
+
+// Fields of the 32 bits instructions kept by each format. The register
+// fields are at the same place in every format, only the immediate differs.
+static const inst_t format_fields[num_formats] = {
+    [fmt_r]   = {.rd = 0x1F, .rs1 = 0x1F, .rs2 = 0x1F},
+    [fmt_r4]  = {.rd = 0x1F, .rs1 = 0x1F, .rs2 = 0x1F, .rs3 = 0x1F},
+    [fmt_i]   = {.imm = -1, .rd = 0x1F, .rs1 = 0x1F},
+    [fmt_s]   = {.imm = -1, .rs1 = 0x1F, .rs2 = 0x1F},
+    [fmt_b]   = {.imm = -1, .rs1 = 0x1F, .rs2 = 0x1F},
+    [fmt_u]   = {.imm = -1, .rd = 0x1F},
+    [fmt_j]   = {.imm = -1, .rd = 0x1F},
+    [fmt_csr] = {.imm = -1, .rd = 0x1F, .rs1 = 0x1F},
+};
+
+// view of the instruction fields as a single word
+static inline u64 inst_bits(inst_t inst) {
+    u64 bits;
+    memcpy(&bits, &inst, sizeof(bits));
+    return bits;
+}
+
 /**
- * @brief decode the instruction
+ * @brief decode the fields of the instruction
+ *
+ * The tables come from insts.spec (see gen_insts.py). The first level is
+ * indexed by the quadrant or opcode and funct3 of the instruction, the second
+ * one by the few bits telling the encodings of that key apart. The slot holds
+ * the candidate to check, more specific ones are chained before the others.
+ *
+ * The operand format of the matching encoding selects the fields. For the 32
+ * bits formats every immediate is computed and the right one is picked
+ * without a branch, decoding a mix of instructions does not stall on an
+ * indirect jump per format. The RVC formats go through their extractor.
  *
  * @param inst      instruction struct
  * @param raw_inst  raw instruction from ELF file
  */
-void inst_decode(inst_t *inst, u32 raw_inst) {
-    // Quadrant 2'b11 mean non-compressed instruction
-    // Refer to riscv-spec-20191213.pdf 16.8 RVC Instruction Set Listings
-    u32 quadrant = QUADRANT(raw_inst);
-
-    // extract different field from instructions
-    u8 opcode = OPCODE(raw_inst);
-    u8 funct2 = FUNCT2(raw_inst);
-    u8 funct3 = FUNCT3(raw_inst);
-    u8 funct7 = FUNCT7(raw_inst);
-    u16 inst_31_20 = INST31_20(raw_inst);
-    u8 c_funct2 = C_FUNCT2(raw_inst);
-    u8 c_funct3 = C_FUNCT3(raw_inst);
-    u8 c_funct_6_5 = C_FUNCT_6_5(raw_inst);
-
-    // reset the cont to 0
-    inst->cont = 0;
-
-    switch(quadrant) {
-        case 0x0: {
-            inst->rvc = true;
-
-            switch(c_funct3) {
-
-                case 0x0: { // RVC - C.ADDI4SPN
-                    inst->type = inst_caddi4spn;
-                    inst->rd = C_RD_(raw_inst);
-                    inst->imm = 0;
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 5, 4, 11);
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 9, 6, 7);
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 2, 2, 6);
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 3, 3, 5);
-                    // only valid when imm != 0
-                    if (inst->imm == 0) invalid_instruction();
-                    break;
-                }
-
-                case 0x2: { // RVC - C.LW
-                    inst->type = inst_clw;
-                    inst->rd = C_RD_(raw_inst);
-                    inst->rs1 = C_RS1_(raw_inst);
-                    inst->imm = 0;
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 2, 2, 6);
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 5, 3, 10);
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 6, 6, 5);
-                    break;
-                }
-
-                case 0x3: { // RVC - C.LD
-                    inst->type = inst_cld;
-                    inst->rd = C_RD_(raw_inst);
-                    inst->rs1 = C_RS1_(raw_inst);
-                    inst->imm = 0;
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 5, 3, 10);
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 7, 6, 5);
-                    break;
-                }
-
-
-                case 0x6: { // RVC - C.SW
-                    inst->type = inst_csw;
-                    inst->rs1 = C_RS1_(raw_inst);
-                    inst->rs2 = C_RS2_(raw_inst);
-                    inst->imm = 0;
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 2, 2, 6);
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 5, 3, 10);
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 6, 6, 5);
-                    break;
-                }
-
-                case 0x7: { // RVC - C.SD
-                    inst->type = inst_csd;
-                    inst->rs1 = C_RS1_(raw_inst);
-                    inst->rs2 = C_RS2_(raw_inst);
-                    inst->imm = 0;
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 5, 3, 10);
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 7, 6, 5);
-                    break;
-                }
-
-                default: UNIMPL_INST();
-
-            }
+static void inst_decode_fields(inst_t *inst, u32 raw_inst) {
+    const decode_key_t *key = &decode_keys[DECODE_KEY(raw_inst)];
+    const decode_entry_t *entry = &decode_slots[key->base + ((raw_inst >> key->shift) & key->mask)];
+    while ((raw_inst & entry->mask) != entry->match) {
+        if (!entry->next) invalid_instruction();
+        entry = &decode_overflow[entry->next];
+    }
 
+    if (!entry->inst.rvc) {
+        // every immediate, the one of the format is picked below
+        i32 imm[num_formats];
+        imm[fmt_none] = imm[fmt_r] = imm[fmt_r4] = 0;
+        imm[fmt_i] = inst_i_type(raw_inst).imm;
+        imm[fmt_s] = inst_s_type(raw_inst).imm;
+        imm[fmt_b] = inst_b_type(raw_inst).imm;
+        imm[fmt_u] = inst_u_type(raw_inst).imm;
+        imm[fmt_j] = inst_j_type(raw_inst).imm;
+        imm[fmt_csr] = inst_csr_type(raw_inst).imm;
+        inst_t fields = inst_r4_type(raw_inst);
+        fields.imm = imm[entry->format];
+        u64 bits = (inst_bits(fields) & inst_bits(format_fields[entry->format])) | inst_bits(entry->inst);
+        memcpy(inst, &bits, sizeof(bits));
+        return;
+    }
+
+    inst_t fields;
+    switch ((inst_format_t) entry->format) {
+        case fmt_none:      fields = (inst_t) {0};                                   break;
+        case fmt_cr:        fields = inst_cr_type(raw_inst);                         break;
+        case fmt_ci:        fields = inst_ci_type(raw_inst);                         break;
+        case fmt_ci_sh:     fields = inst_ci_sh_type(raw_inst);                      break;
+        case fmt_ci_lui:    fields = inst_ci_lui_type(raw_inst);                     break;
+        case fmt_ci_16sp:   fields = inst_ci_16sp_type(raw_inst);                    break;
+        case fmt_ci_lwsp:   fields = inst_ci_lwsp_type(raw_inst);                    break;
+        case fmt_ci_ldsp:   fields = inst_ci_ldsp_type(raw_inst);                    break;
+        case fmt_css_w:     fields = inst_css_w_type(raw_inst);                      break;
+        case fmt_css_d:     fields = inst_css_d_type(raw_inst);                      break;
+        case fmt_cl_w:      fields = inst_cl_type(raw_inst, inst_c_imm_w(raw_inst)); break;
+        case fmt_cl_d:      fields = inst_cl_type(raw_inst, inst_c_imm_d(raw_inst)); break;
+        case fmt_cs_w:      fields = inst_cs_type(raw_inst, inst_c_imm_w(raw_inst)); break;
+        case fmt_cs_d:      fields = inst_cs_type(raw_inst, inst_c_imm_d(raw_inst)); break;
+        case fmt_ca:        fields = inst_ca_type(raw_inst);                         break;
+        case fmt_cb:        fields = inst_cb_type(raw_inst);                         break;
+        case fmt_cb_sh:     fields = inst_cb_sh_type(raw_inst);                      break;
+        case fmt_cb_imm:    fields = inst_cb_imm_type(raw_inst);                     break;
+        case fmt_cj:        fields = inst_cj_type(raw_inst);                         break;
+        case fmt_ciw: {
+            fields = inst_ciw_type(raw_inst);
+            // only valid when imm != 0, this also rejects the all zero instruction
+            if (fields.imm == 0) invalid_instruction();
             break;
         }
+        default: unreachable();
+    }
+    u64 bits = inst_bits(fields) | inst_bits(entry->inst);
+    memcpy(inst, &bits, sizeof(bits));
+}
 
-        case 0x1: {
-            inst->rvc = true;
-
-            switch(c_funct3) {
-
-                case 0x0: {
-                    inst->rs1 = C_RS1(raw_inst);
-                    inst->rd = C_RD(raw_inst);
-                    inst->imm = 0;
-                    inst->imm = inst->imm | EXTRACT_IMM_SIGNED(raw_inst, 5, 5, 12);
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 4, 0, 2);
-                    // only valid when rd != 0 and imm != 0
-                    if (inst->rd == 0)                          inst->type = inst_cnop;     // RVC - C.NOP
-                    else if (inst->rd != 0 && inst->imm != 0)   inst->type = inst_caddi;    // RVC - C.ADDI
-                    else                                        UNIMPL_INST();
-                    break;
-                }
-
-                case 0x1: { // RVC - C.ADDIW
-                    inst->type = inst_caddiw,
-                    inst->rs1 = C_RS1(raw_inst);
-                    inst->rd = C_RD(raw_inst);
-                    inst->imm = 0;
-                    inst->imm = inst->imm | EXTRACT_IMM_SIGNED(raw_inst, 5, 5, 12);
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 4, 0, 2);
-                    // only valid when rd != 0
-                    if (inst->rd == 0) invalid_instruction();
-                    break;
-                }
-
-                case 0x2: { // RVC - C.LI
-                    inst->type = inst_cli,
-                    inst->rd = C_RD(raw_inst);
-                    inst->imm = 0;
-                    inst->imm = inst->imm | EXTRACT_IMM_SIGNED(raw_inst, 5, 5, 12);
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 4, 0, 2);
-                    // only valid when rd != 0
-                    if (inst->rd == 0) UNIMPL_INST();
-                    break;
-                }
-
-                case 0x3: {
-                    inst->rd = C_RD(raw_inst);
-                    if (inst->rd != 0 && inst->rd != 2) { // RVC - C.LUI
-                        inst->type = inst_clui,
-                        inst->imm = 0;
-                        inst->imm = inst->imm | EXTRACT_IMM_SIGNED(raw_inst, 17, 17, 12);
-                        inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 16, 12, 2);
-                        // only valid when rd != 0, 2 and imm != 0
-                        if (inst->rd == 0 && inst->rd != 2 && inst->imm != 0) UNIMPL_INST();
-                    }
-                    else if (inst->rd == 2) { // RVC - C.ADDI16SP
-                        inst->type = inst_caddi16sp;
-                        inst->imm = 0;
-                        inst->imm = inst->imm | EXTRACT_IMM_SIGNED(raw_inst, 9, 9, 12);
-                        inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 4, 4, 6);
-                        inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 6, 6, 5);
-                        inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 8, 7, 3);
-                        inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 5, 5, 2);
-                        // only valid when imm != 0
-                        if (inst->imm == 0) invalid_instruction();
-                    }
-
-                    break;
-                }
-
-                case 0x4: {
-
-                    switch (c_funct2) {
-
-                        case 0x0: {
-                            // use imm as shamt
-                            inst->imm = 0;
-                            inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 5, 5, 12);
-                            inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 4, 0, 2);
-                            if (inst->imm != 0) {   // RVC - C.SRLI
-                                inst->type = inst_csrli,
-                                inst->rd = C_RD_(raw_inst);
-                                inst->rs1 = C_RS1_(raw_inst);
-                            }
-                            else {
-                                UNIMPL_INST();
-                            }
-                            break;
-                        }
-
-                        case 0x1: {
-                            // use imm as shamt
-                            inst->imm = 0;
-                            inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 5, 5, 12);
-                            inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 4, 0, 2);
-                            if (inst->imm != 0) {   // RVC - C.SRAI
-                                inst->type = inst_csrai,
-                                inst->rd = C_RD_(raw_inst);
-                                inst->rs1 = C_RS1_(raw_inst);
-                            }
-                            else {
-                                UNIMPL_INST();
-                            }
-                            break;
-                        }
-
-                        case 0x2: {
-                            inst->type = inst_candi,
-                            inst->imm = 0;
-                            inst->imm = inst->imm | EXTRACT_IMM_SIGNED(raw_inst, 5, 5, 12);
-                            inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 4, 0, 2);
-                            inst->rd = C_RD_(raw_inst);
-                            inst->rs1 = C_RS1_(raw_inst);
-                            break;
-                        }
-
-                        case 0x3: {
-                                inst->rs1 = C_RS1_(raw_inst);
-                                inst->rs2 = C_RS2_(raw_inst);
-                                inst->rd = C_RD_(raw_inst);
-                                u8 inst_12 = (raw_inst >> 12) & 0x1;
-
-                                if (inst_12 == 0) {
-
-                                    switch (c_funct_6_5) {
-                                        case 0x0: inst->type = inst_csub; break; // RVC - C.SUB
-                                        case 0x1: inst->type = inst_cxor; break; // RVC - C.XOR
-                                        case 0x2: inst->type = inst_cor;  break; // RVC - C.OR
-                                        case 0x3: inst->type = inst_cand; break; // RVC - C.AND
-                                    }
-
-                                }
-
-                                if (inst_12 == 1) {
-
-                                    switch (c_funct_6_5) {
-                                        case 0x0: inst->type = inst_csubw; break; // RVC - C.SUB
-                                        case 0x1: inst->type = inst_caddw; break; // RVC - C.XOR
-                                        default: invalid_instruction();
-                                    }
-
-                                }
-
-                            break;
-                        }
-
-                        default: {UNIMPL_INST();}
-                    }
-                    break;
-                }
-
-                case 0x5: { // RVC - C.J
-                    inst->type = inst_cj;
-                    inst->cont = true;
-                    inst->imm = 0;
-                    inst->imm = inst->imm | EXTRACT_IMM_SIGNED(raw_inst, 11, 11, 12);
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 4, 4, 11);
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 9, 8, 9);
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 10, 10, 8);
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 6, 6, 7);
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 7, 7, 6);
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 3, 1, 3);
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 5, 5, 2);
-                    break;
-                }
-
-                case 0x6: { // RVC - C.BEQZ
-                    inst->type = inst_cbeqz;
-                    inst->cont = true;
-                    inst->rs1 = C_RS1_(raw_inst);
-                    inst->imm = 0;
-                    inst->imm = inst->imm | EXTRACT_IMM_SIGNED(raw_inst, 8, 8, 12);
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 4, 3, 10);
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 7, 6, 5);
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 2, 1, 3);
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 5, 5, 2);
-                    break;
-                }
-
-                case 0x7: { // RVC - C.BNEZ
-                    inst->type = inst_cbnez;
-                    inst->cont = true;
-                    inst->rs1 = C_RS1_(raw_inst);
-                    inst->imm = 0;
-                    inst->imm = inst->imm | EXTRACT_IMM_SIGNED(raw_inst, 8, 8, 12);
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 4, 3, 10);
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 7, 6, 5);
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 2, 1, 3);
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 5, 5, 2);
-                    break;
-                }
-
-                default: UNIMPL_INST();
-            }
-
+/**
+ * @brief fuse a pair of consecutive instructions into one
+ *
+ * Compilers emit some pairs over and over: lui+addi (32 bits constants),
+ * auipc+jalr (far calls, and far tail calls which come specialised as jr),
+ * auipc+ld (GOT loads), slli+srli (zero extension) and addi+bne (loop
+ * tails). They are executed by a single handler. Pairs
+ * writing register zero are left alone, the handlers read their first result.
+ *
+ * @param first   first instruction, replaced by the fused instruction
+ * @param second  instruction following first
+ * @return true   the pair is fused into first
+ * @return false  the pair can not be fused
+ */
+bool inst_fuse(inst_t *first, inst_t *second) {
+    if (first->rvc || second->rvc || first->fused || second->fused) return false;
+    if (first->rd == zero) return false;
+
+    inst_t fused = {.rd = second->rd, .rs1 = first->rd, .fused = true, .cont = second->cont};
+    switch (first->type) {
+        case inst_lui: {
+            // lui rd, hi ; addi rd, rd, lo
+            if (second->type != inst_addi || second->rs1 != first->rd || second->rd != first->rd) return false;
+            fused.type = inst_lui_addi;
+            fused.imm = first->imm | (second->imm & 0xFFF);
             break;
         }
-
-        case 0x2: {
-            inst->rvc = true;
-
-            switch(c_funct3) {
-
-                case 0x0: { // RVC - C.SLLI
-                    inst->type = inst_cslli,
-                    inst->rs1 = C_RS1(raw_inst);
-                    inst->rd = C_RD(raw_inst);
-                    // use imm as shamt
-                    inst->imm = 0;
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 5, 5, 12);
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 4, 0, 2);
-                    // only valid when imm != 0 and rd != 0, else it is HINTs
-                    if (inst->imm == 0 || inst->rd == 0) UNIMPL_INST();
-                    break;
-                }
-
-                case 0x2: { // RVC - C.LWSP
-                    inst->type = inst_clwsp;
-                    inst->rd = RD(raw_inst);
-                    inst->imm = 0;
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 4, 2, 4);
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 7, 6, 2);
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 5, 5, 12);
-                    if (inst->rd == 0) invalid_instruction();
-                    break;
-                }
-
-                case 0x3: { // RVC - C.LDSP
-                    inst->type = inst_cldsp;
-                    inst->rd = RD(raw_inst);
-                    inst->imm = 0;
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 4, 3, 5);
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 8, 6, 2);
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 5, 5, 12);
-                    if (inst->rd == 0) invalid_instruction();
-                    break;
-                }
-
-                case 0x4: {
-                    u8 rs1 = C_RS1(raw_inst);
-                    u8 rs2 = C_RS2(raw_inst);
-                    u8 rd = C_RD(raw_inst);
-                    u8 inst_12 = (raw_inst >> 12) & 0x1;
-                    if (inst_12 == 0 && rs1 != 0 && rs2 == 0) { // RVC - C.JR
-                        inst->type = inst_cjr;
-                        inst->cont = true;
-                        inst->rs1 = rs1;
-                    }
-                    else if (inst_12 == 0 && rd != 0 && rs2 != 0) { // RVC - C.MV
-                        inst->type = inst_cmv;
-                        inst->rd = rd;
-                        inst->rs2 = rs2;
-                    }
-                    else if (inst_12 == 1 && rs1 != 0 && rs2 == 0) { // RVC - C.JALR
-                        inst->type = inst_cjalr;
-                        inst->cont = true;
-                        inst->rs1 = rs1;
-                    }
-                    else if (inst_12 == 1 && rd != 0 && rs2 != 0) { // RVC - C.ADD
-                        inst->type = inst_cadd;
-                        inst->rd = rd;
-                        inst->rs2 = rs2;
-                    }
-                    else if (inst_12 == 1 && rd == 0 && rs2 == 0) { // RVC - E.BREAK
-                        UNIMPL_INST();
-                    }
-                    else UNIMPL_INST();
-
-                    break;
-                }
-
-
-                case 0x6: { // RVC - C.SWSP
-                    inst->type = inst_cswsp;
-                    inst->rs2 = C_RS2(raw_inst);
-                    inst->imm = 0;
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 5, 2, 9);
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 7, 6, 7);
-                    break;
-                }
-
-                case 0x7: { // RVC - C.SDSP
-                    inst->type = inst_csdsp;
-                    inst->rs2 = C_RS2(raw_inst);
-                    inst->imm = 0;
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 5, 3, 10);
-                    inst->imm = inst->imm | EXTRACT_IMM_UNSIGNED(raw_inst, 8, 6, 7);
-                    break;
-                }
-
-                default: UNIMPL_INST();
-
-            }
-
+        case inst_auipc: {
+            // auipc rt, hi ; jalr rd, lo(rt)  or  auipc rt, hi ; ld rd, lo(rt), the
+            // jr form has its own handler as the link must not go to register zero
+            if (second->rs1 != first->rd) return false;
+            if (second->type == inst_jalr)      fused.type = inst_auipc_jalr;
+            else if (second->type == inst_jr)   fused.type = inst_auipc_jr;
+            else if (second->type == inst_ld)   fused.type = inst_auipc_ld;
+            else return false;
+            fused.imm = first->imm | (second->imm & 0xFFF);
+            break;
+        }
+        case inst_slli: {
+            // slli rd, rs1, a ; srli rd, rd, b
+            if (second->type != inst_srli || second->rs1 != first->rd || second->rd != first->rd) return false;
+            fused.type = inst_slli_srli;
+            fused.rs1 = first->rs1;
+            fused.imm = FUSED_IMM(first->imm & 0x3F, second->imm & 0x3F);
             break;
         }
+        case inst_addi: {
+            // addi rd, rs1, k ; bne rd, rs2, offset
+            if (second->type != inst_bne || second->rs1 != first->rd) return false;
+            fused.type = inst_addi_bne;
+            fused.rd = first->rd;
+            fused.rs1 = first->rs1;
+            fused.rs2 = second->rs2;
+            // the branch offset is relative to the first instruction
+            fused.imm = FUSED_IMM(second->imm + 4, first->imm);
+            break;
+        }
+        default: return false;
+    }
 
-        case 0x3: {
-
-            inst->rvc = false;  // not compressed instructions
-
-            switch(opcode) {
-
-                case 0x0: {
-                    *inst = inst_i_type(raw_inst);
-                    switch (funct3) {
-                        case 0x0: inst->type = inst_lb; return;     // RV32I - LB
-                        case 0x1: inst->type = inst_lh; return;     // RV32I - LH
-                        case 0x2: inst->type = inst_lw; return;     // RV32I - LW
-                        case 0x3: inst->type = inst_ld; return;     // RV64I - LD
-                        case 0x4: inst->type = inst_lbu; return;    // RV32I - LBU
-                        case 0x5: inst->type = inst_lhu; return;    // RV32I - LHU
-                        case 0x6: inst->type = inst_lwu; return;    // RV64I - LWU
-                        default: invalid_instruction();
-                    }
-                }
-
-
-                case 0x1: {
-                    *inst = inst_i_type(raw_inst);
-                    switch(funct3) {
-                        case 0x2: inst->type = inst_flw; return;    // RV32F - FLW
-                        case 0x3: inst->type = inst_fld; return;    // RV32D - FLD
-                    }
-                }
-
-                case 0x3: {
-                    inst->type = inst_fence; return;        // RV32I - FENCE
-                }
-
-                case 0x4: {
-                    *inst = inst_i_type(raw_inst);
-                    switch (funct3) {
-                        case 0x0: inst->type = inst_addi;  return; // RV32I - ADDI
-                        case 0x1: inst->type = inst_slli;  return; // RV64I - SLLI
-                        case 0x2: inst->type = inst_slti;  return; // RV32I - SLTI
-                        case 0x3: inst->type = inst_sltiu; return; // RV32I - SLTIU
-                        case 0x4: inst->type = inst_xori;  return; // RV32I - XORI
-                        case 0x6: inst->type = inst_ori;   return; // RV32I - ORI
-                        case 0x7: inst->type = inst_andi;  return; // RV32I - ANDI
-                        case 0x5: {
-                            if      (funct7 == 0x0)  {inst->type = inst_srli; return;} // RV64I - SRLI
-                            else if (funct7 == 0x20) {inst->type = inst_srai; return;} // RV64I - SRAI
-                            else                     {fatal("Not a valid itype instruction");}
-                        }
-                        default: invalid_instruction();
-                    }
-                }
-
-                case 0x5: { // RV32I - AUIPC
-                    *inst = inst_u_type(raw_inst);
-                    inst->type = inst_auipc;
-                    return;
-                }
-
-                case 0x6: {
-                    *inst = inst_i_type(raw_inst);
-                    switch (funct3) {
-                        case 0x0: inst->type = inst_addiw; return;  // RV64I - ADDIW
-                        case 0x1: inst->type = inst_slliw; return;  // RV64I - SLLIW
-                        case 0x5: {
-                            if      (funct7 == 0x0)  {inst->type = inst_srliw; return;} // RV64I - SRLIW
-                            else if (funct7 == 0x20) {inst->type = inst_sraiw; return;} // RV64I - SRAIW
-                            else                     {fatal("Not a valid itype instruction");}
-                        }
-                        default: invalid_instruction();
-                    }
-                }
-
-                case 0x8: {
-                    *inst = inst_s_type(raw_inst);
-                    switch (funct3) {
-                        case 0x0: inst->type = inst_sb; return;     // RV32I - SB
-                        case 0x1: inst->type = inst_sh; return;     // RV32I - SH
-                        case 0x2: inst->type = inst_sw; return;     // RV32I - SW
-                        case 0x3: inst->type = inst_sd; return;     // RV64I - SD
-                        default: invalid_instruction();
-                    }
-                }
-
-                case 0x9: {
-                    *inst = inst_s_type(raw_inst);
-                    switch(funct3) {
-                        case 0x2: inst->type = inst_fsw; return;    // RV32F - FSW
-                        case 0x3: inst->type = inst_fsd; return;    // RV32D - FSD
-                    }
-                }
-
-                case 0xC: {
-                    *inst = inst_r_type(raw_inst);
-                    switch (funct3) {
-                        case 0x0: {
-                            if      (funct7 == 0x0)  {inst->type = inst_add; return;} // RV32I - ADD
-                            else if (funct7 == 0x20) {inst->type = inst_sub; return;} // RV32I - SUB
-                            else if (funct7 == 0x1)  { // RV32M
-                                switch (funct3) {
-                                    case 0x0: {inst->type = inst_mul;    return;}    // RV32M - MUL
-                                    case 0x1: {inst->type = inst_mulh;   return;}    // RV32M - MULH
-                                    case 0x2: {inst->type = inst_mulhsu; return;}    // RV32M - MULHSU
-                                    case 0x3: {inst->type = inst_mulhu;  return;}    // RV32M - MULHU
-                                    case 0x4: {inst->type = inst_div;    return;}    // RV32M - DIV
-                                    case 0x5: {inst->type = inst_divu;   return;}    // RV32M - DIVU
-                                    case 0x6: {inst->type = inst_rem;    return;}    // RV32M - REM
-                                    case 0x7: {inst->type = inst_remu;   return;}    // RV32M - REMU
-                                    default: invalid_instruction();
-                                }
-                            }
-                            else                     {fatal("Not a valid arithmetic instruction");}
-                        }
-                        case 0x1: inst->type = inst_sll;  return; // RV32I - SLL
-                        case 0x2: inst->type = inst_slt;  return; // RV32I - SLT
-                        case 0x3: inst->type = inst_sltu; return; // RV32I - SLTU
-                        case 0x4: inst->type = inst_xor;  return; // RV32I - XOR
-                        case 0x5: {
-                            if      (funct7 == 0x0)  {inst->type = inst_srl; return;} // RV32I - SRL
-                            else if (funct7 == 0x20) {inst->type = inst_sra; return;} // RV32I - SRA
-                            else                     {fatal("Not a valid itype instruction");}
-                        }
-                        case 0x6: inst->type = inst_or;  return; // RV32I - OR
-                        case 0x7: inst->type = inst_and; return; // RV32I - AND
-                        default: invalid_instruction();
-                    }
-                }
-
-                case 0xD: { // RV32I - LUI
-                    *inst = inst_u_type(raw_inst);
-                    inst->type = inst_lui;
-                    return;
-                }
-
-                case 0xE: {
-                    *inst = inst_r_type(raw_inst);
-                    switch (funct3) {
-                        case 0x0: {
-                            if      (funct7 == 0x0)  {inst->type = inst_addw; return;} // RV64I - ADDW
-                            else if (funct7 == 0x20) {inst->type = inst_subw; return;} // RV64I - SUBW
-                            else if (funct7 == 0x1)  { // RV64M
-                                switch (funct3) {
-                                    case 0x0: {inst->type = inst_mulw;    return;}    // RV32M - MULW
-                                    case 0x4: {inst->type = inst_divw;    return;}    // RV32M - DIVW
-                                    case 0x5: {inst->type = inst_divuw;   return;}    // RV32M - DIVUW
-                                    case 0x6: {inst->type = inst_remw;    return;}    // RV32M - REMW
-                                    case 0x7: {inst->type = inst_remuw;   return;}    // RV32M - REMUW
-                                    default: invalid_instruction();
-                                }
-                            }
-                            else                     {invalid_instruction();}
-                        }
-                        case 0x1: inst->type = inst_sllw;  return; // RV64I - SLLW
-                        case 0x5: {
-                            if      (funct7 == 0x0)  {inst->type = inst_srlw; return;} // RV64I - SRLW
-                            else if (funct7 == 0x20) {inst->type = inst_sraw; return;} // RV64I - SRAW
-                            else                     {invalid_instruction();}
-                        }
-                        default: invalid_instruction();
-                    }
-                }
-
-                case 0x10: {
-                    *inst = inst_r4_type(raw_inst);
-                    switch(funct2) {
-                        case 0x0: inst->type = inst_fmadd_s; return;        // RV32F - FMADD.S
-                        case 0x1: inst->type = inst_fmadd_d; return;        // RV32D - FMADD.D
-                        default: invalid_instruction();
-                    }
-                }
-
-
-                case 0x11: {
-                    *inst = inst_r4_type(raw_inst);
-                    switch(funct2) {
-                        case 0x0: inst->type = inst_fmsub_s; return;        // RV32F - FMSUB.S
-                        case 0x1: inst->type = inst_fmsub_d; return;        // RV32D - FMSUB.D
-                        default: invalid_instruction();
-                    }
-                }
-
-                case 0x12: {
-                    *inst = inst_r4_type(raw_inst);
-                    switch(funct2) {
-                        case 0x0: inst->type = inst_fnmsub_s; return;        // RV32F - FNMSUB.S
-                        case 0x1: inst->type = inst_fnmsub_d; return;        // RV32D - FNMSUB.D
-                        default: invalid_instruction();
-                    }
-                }
-
-                case 0x13: {
-                    *inst = inst_r4_type(raw_inst);
-                    switch(funct2) {
-                        case 0x0: inst->type = inst_fnmadd_s; return;        // RV32F - FNMADD.S
-                        case 0x1: inst->type = inst_fnmadd_d; return;        // RV32D - FNMADD.D
-                        default: invalid_instruction();
-                    }
-                }
-
-                case 0x14: {
-                    *inst = inst_r_type(raw_inst);
-                    switch (funct7) {
-                        case 0x0: inst->type = inst_fadd_s; return; // RV32F - FADD.S
-                        case 0x1: inst->type = inst_fadd_d; return; // RV32F - FADD.D
-                        case 0x4: inst->type = inst_fsub_s; return; // RV32F - FSUB.S
-                        case 0x5: inst->type = inst_fsub_d; return; // RV32F - FSUB.D
-                        case 0x8: inst->type = inst_fmul_s; return; // RV32F - FMUL.S
-                        case 0x9: inst->type = inst_fmul_d; return; // RV32F - FMUL.D
-                        case 0xC: inst->type = inst_fdiv_s; return; // RV32F - FDIV.S
-                        case 0xD: inst->type = inst_fdiv_d; return; // RV32F - FDIV.D
-                        case 0x14: {
-                            switch (funct3) {
-                                case 0x0: inst->type = inst_fmin_s; return; // RV32F - FMIN.S
-                                case 0x1: inst->type = inst_fmax_s; return; // RV32F - FMAX.S
-                                default: invalid_instruction();
-                            }
-                        }
-                        case 0x15: {
-                            switch (funct3) {
-                                case 0x0: inst->type = inst_fmin_d; return; // RV32F - FMIN.D
-                                case 0x1: inst->type = inst_fmax_d; return; // RV32F - FMAX.D
-                                default: invalid_instruction();
-                            }
-                        }
-                        case 0x2C: inst->type = inst_fsqrt_s; return; // RV32F - FSQRT.S
-                        case 0x2D: inst->type = inst_fsqrt_d; return; // RV32F - FSQRT.D
-                        default: invalid_instruction();
-                    }
-                }
-
-                case 0x18: { // RV32I - Branch
-                    *inst = inst_b_type(raw_inst);
-                    switch (funct3) {
-                        case 0x0: inst->type = inst_beq; return;    // RV32I - BEQ
-                        case 0x1: inst->type = inst_bne; return;    // RV32I - BNE
-                        case 0x4: inst->type = inst_blt; return;    // RV32I - BLE
-                        case 0x5: inst->type = inst_bge; return;    // RV32I - BGE
-                        case 0x6: inst->type = inst_bltu; return;   // RV32I - BLTU
-                        case 0x7: inst->type = inst_bgeu; return;   // RV32I - BGEU
-                        default: invalid_instruction();
-                    }
-                }
-
-                case 0x19: { // RV32I - JALR
-                    *inst = inst_i_type(raw_inst);
-                    inst->type = inst_jalr;
-                    inst->cont = true;
-                    return;
-                }
-
-                case 0x1B: { // RV32I - JAL
-                    *inst = inst_j_type(raw_inst);
-                    inst->type = inst_jal;
-                    inst->cont = true;
-                    return;
-                }
-
-                case 0x1C: {
-
-                    switch (funct3) {
-                        case 0x0: {
-                            if      (inst_31_20 == 0x0)   {inst->type = inst_ecall;  inst->cont = true; return;} // RV32I - ECALL
-                            else if (inst_31_20 == 0x1)   {inst->type = inst_ebreak; inst->cont = true; return;} // RV32I - EBREAK
-                            else if (inst_31_20 == 0x302) {inst->type = inst_mret;   inst->cont = true; return;} // Trap - MRET
-                            else                        {UNIMPL_INST();}
-                        }
-                        case 0x1: {*inst = inst_csr_type(raw_inst); inst->type = inst_csrrw;  return;}  // Zicsr - CSRRW
-                        case 0x2: {*inst = inst_csr_type(raw_inst); inst->type = inst_csrrs;  return;}  // Zicsr - CSRRS
-                        case 0x3: {*inst = inst_csr_type(raw_inst); inst->type = inst_csrrc;  return;}  // Zicsr - CSRRC
-                        case 0x5: {*inst = inst_csr_type(raw_inst); inst->type = inst_csrrwi; return;}  // Zicsr - CSRRWI
-                        case 0x6: {*inst = inst_csr_type(raw_inst); inst->type = inst_csrrsi; return;}  // Zicsr - CSRRSI
-                        case 0x7: {*inst = inst_csr_type(raw_inst); inst->type = inst_csrrci; return;}  // Zicsr - CSRRCI
-                        default: invalid_instruction();
-                    }
-
-                }
-
-                default: UNIMPL_INST();
-            }
+    *first = fused;
+    return true;
+}
 
-        }
-        default: unreachable();
+/**
+ * @brief replace an instruction by a specialised variant for its operands
+ *
+ * Writes to register zero become nop (jal and jalr lose their link), and
+ * the common shapes of addi become li and mv. No handler ever writes
+ * register zero, so it does not have to be reset after each instruction.
+ * Loads to register zero keep their access, which may fault or set the
+ * accessed bit of a page, and only drop the result. The Zicsr handlers
+ * check rd themselves since they have side effects.
+ *
+ * @param inst decoded instruction
+ */
+static void inst_specialise(inst_t *inst) {
+    switch (inst->type) {
+        case inst_jal:
+            if (inst->rd == zero) inst->type = inst_j;
+            break;
+        case inst_jalr:
+            if (inst->rd == zero) inst->type = inst_jr;
+            break;
+        case inst_addi:
+            if (inst->rd == zero)       inst->type = inst_nop;  // addi x0, x0, 0 is the canonical nop
+            else if (inst->rs1 == zero) inst->type = inst_li;   // addi rd, x0, imm
+            else if (inst->imm == 0)    inst->type = inst_mv;   // addi rd, rs1, 0
+            break;
+        case inst_lb: case inst_lbu:
+            if (inst->rd == zero) inst->type = inst_lb_x0;
+            break;
+        case inst_lh: case inst_lhu:
+            if (inst->rd == zero) inst->type = inst_lh_x0;
+            break;
+        case inst_lw: case inst_lwu: case inst_clw:
+            if (inst->rd == zero) inst->type = inst_lw_x0;
+            break;
+        case inst_ld: case inst_cld:
+            if (inst->rd == zero) inst->type = inst_ld_x0;
+            break;
+        case inst_clwsp: case inst_cldsp:
+            // reserved with rd == 0, accessed like the other loads
+            if (inst->rd != zero) break;
+            inst->type = inst->type == inst_clwsp ? inst_lw_x0 : inst_ld_x0;
+            inst->rs1 = sp;
+            break;
+        default:
+            if (writes_rd[inst->type] && inst->rd == zero) inst->type = inst_nop;
+            break;
     }
 }
 
+/**
+ * @brief decode the instruction
+ *
+ * @param inst      instruction struct
+ * @param raw_inst  raw instruction from ELF file
+ */
+void inst_decode(inst_t *inst, u32 raw_inst) {
+    inst_decode_fields(inst, raw_inst);
+    inst_specialise(inst);
+}
+
 #undef IMM_MASK
 #undef EXTRACT_IMM_UNSIGNED
 #undef EXTRACT_IMM_SIGNED
@@ -0,0 +1,194 @@
+# Instruction specification
+#
+# gen_insts.py turns this file into inst_type_t.h, funcs.h, ops.h and the
+# decode tables of decode.c, so adding an instruction only takes a line here
+# and its exec_ handler.
+#
+# name      instruction name, inst_<name> / exec_<name>
+# match     value of the fixed bits of the encoding
+# mask      bits of the encoding fixed by match
+# format    operand format, picks the field extractor of inst_decode
+#           (a new format needs its extractor, or for 32 bits instructions
+#           its immediate and format_fields entry, in decode.c)
+# flags     rd:   writes the integer register rd (becomes nop for rd == 0,
+#                 loads keep their access, see inst_specialise)
+#           cont: ends the block
+#
+# A name may appear again with another encoding (c.ebreak is an ebreak).
+# Instructions without an encoding (-) are created by the decoder itself.
+# "## text" starts a group and comments its first instruction in the enum.
+#
+# name          match       mask        format      flags
+
+## RV32I/RV64I Base Instruction Set
+lui             0x00000037  0x0000007f  u           rd
+auipc           0x00000017  0x0000007f  u           rd
+jal             0x0000006f  0x0000007f  j           rd,cont
+jalr            0x00000067  0x0000707f  i           rd,cont
+beq             0x00000063  0x0000707f  b           cont
+bne             0x00001063  0x0000707f  b           cont
+blt             0x00004063  0x0000707f  b           cont
+bge             0x00005063  0x0000707f  b           cont
+bltu            0x00006063  0x0000707f  b           cont
+bgeu            0x00007063  0x0000707f  b           cont
+lb              0x00000003  0x0000707f  i           rd
+lh              0x00001003  0x0000707f  i           rd
+lw              0x00002003  0x0000707f  i           rd
+lbu             0x00004003  0x0000707f  i           rd
+lhu             0x00005003  0x0000707f  i           rd
+sb              0x00000023  0x0000707f  s           -
+sh              0x00001023  0x0000707f  s           -
+sw              0x00002023  0x0000707f  s           -
+addi            0x00000013  0x0000707f  i           rd
+slti            0x00002013  0x0000707f  i           rd
+sltiu           0x00003013  0x0000707f  i           rd
+xori            0x00004013  0x0000707f  i           rd
+ori             0x00006013  0x0000707f  i           rd
+andi            0x00007013  0x0000707f  i           rd
+slli            0x00001013  0xfc00707f  i           rd
+srli            0x00005013  0xfc00707f  i           rd
+srai            0x40005013  0xfc00707f  i           rd
+add             0x00000033  0xfe00707f  r           rd
+sub             0x40000033  0xfe00707f  r           rd
+sll             0x00001033  0xfe00707f  r           rd
+slt             0x00002033  0xfe00707f  r           rd
+sltu            0x00003033  0xfe00707f  r           rd
+xor             0x00004033  0xfe00707f  r           rd
+srl             0x00005033  0xfe00707f  r           rd
+sra             0x40005033  0xfe00707f  r           rd
+or              0x00006033  0xfe00707f  r           rd
+and             0x00007033  0xfe00707f  r           rd
+fence           0x0000000f  0x0000707f  none        -
+ecall           0x00000073  0xffffffff  none        cont
+ebreak          0x00100073  0xffffffff  none        cont
+lwu             0x00006003  0x0000707f  i           rd
+ld              0x00003003  0x0000707f  i           rd
+sd              0x00003023  0x0000707f  s           -
+addiw           0x0000001b  0x0000707f  i           rd
+slliw           0x0000101b  0xfe00707f  i           rd
+srliw           0x0000501b  0xfe00707f  i           rd
+sraiw           0x4000501b  0xfe00707f  i           rd
+addw            0x0000003b  0xfe00707f  r           rd
+subw            0x4000003b  0xfe00707f  r           rd
+sllw            0x0000103b  0xfe00707f  r           rd
+srlw            0x0000503b  0xfe00707f  r           rd
+sraw            0x4000503b  0xfe00707f  r           rd
+
+## RV32M/RV64M
+mul             0x02000033  0xfe00707f  r           rd
+mulh            0x02001033  0xfe00707f  r           rd
+mulhsu          0x02002033  0xfe00707f  r           rd
+mulhu           0x02003033  0xfe00707f  r           rd
+div             0x02004033  0xfe00707f  r           rd
+divu            0x02005033  0xfe00707f  r           rd
+rem             0x02006033  0xfe00707f  r           rd
+remu            0x02007033  0xfe00707f  r           rd
+mulw            0x0200003b  0xfe00707f  r           rd
+divw            0x0200403b  0xfe00707f  r           rd
+divuw           0x0200503b  0xfe00707f  r           rd
+remw            0x0200603b  0xfe00707f  r           rd
+remuw           0x0200703b  0xfe00707f  r           rd
+
+## "Zicsr"
+# rd is checked by the handlers, reading a CSR has side effects, and a write
+# of satp switches the address space of the following instructions
+csrrw           0x00001073  0x0000707f  csr         cont
+csrrs           0x00002073  0x0000707f  csr         cont
+csrrc           0x00003073  0x0000707f  csr         cont
+csrrwi          0x00005073  0x0000707f  csr         cont
+csrrsi          0x00006073  0x0000707f  csr         cont
+csrrci          0x00007073  0x0000707f  csr         cont
+
+## RVC instructions
+# HINTs (rd == 0) decode to nop through the rd flag
+clwsp           0x00004002  0x0000e003  ci_lwsp     rd
+cldsp           0x00006002  0x0000e003  ci_ldsp     rd
+cswsp           0x0000c002  0x0000e003  css_w       -
+csdsp           0x0000e002  0x0000e003  css_d       -
+clw             0x00004000  0x0000e003  cl_w        rd
+cld             0x00006000  0x0000e003  cl_d        rd
+csw             0x0000c000  0x0000e003  cs_w        -
+csd             0x0000e000  0x0000e003  cs_d        -
+cj              0x0000a001  0x0000e003  cj          cont
+cjr             0x00008002  0x0000f07f  cr          cont
+cjalr           0x00009002  0x0000f07f  cr          cont
+cbeqz           0x0000c001  0x0000e003  cb          cont
+cbnez           0x0000e001  0x0000e003  cb          cont
+cli             0x00004001  0x0000e003  ci          rd
+clui            0x00006001  0x0000e003  ci_lui      rd
+caddi           0x00000001  0x0000e003  ci          rd
+caddiw          0x00002001  0x0000e003  ci          rd
+caddi16sp       0x00006101  0x0000ef83  ci_16sp     -
+caddi4spn       0x00000000  0x0000e003  ciw         rd
+cslli           0x00000002  0x0000e003  ci_sh       rd
+csrli           0x00008001  0x0000ec03  cb_sh       rd
+csrai           0x00008401  0x0000ec03  cb_sh       rd
+candi           0x00008801  0x0000ec03  cb_imm      rd
+cmv             0x00008002  0x0000f003  cr          rd
+cadd            0x00009002  0x0000f003  cr          rd
+cand            0x00008c61  0x0000fc63  ca          rd
+cor             0x00008c41  0x0000fc63  ca          rd
+cxor            0x00008c21  0x0000fc63  ca          rd
+csub            0x00008c01  0x0000fc63  ca          rd
+caddw           0x00009c21  0x0000fc63  ca          rd
+csubw           0x00009c01  0x0000fc63  ca          rd
+cnop            0x00000001  0x0000ef83  none        -
+ebreak          0x00009002  0x0000ffff  none        cont
+
+## Trap-Return Instructions
+mret            0x30200073  0xffffffff  none        cont
+
+## Supervisor Memory-Management Instructions
+sfence_vma      0x12000073  0xfe007fff  r           cont
+
+## RV32F Instructions
+flw             0x00002007  0x0000707f  i           -
+fsw             0x00002027  0x0000707f  s           -
+fadd_s          0x00000053  0xfe00007f  r           -
+fsub_s          0x08000053  0xfe00007f  r           -
+fmul_s          0x10000053  0xfe00007f  r           -
+fdiv_s          0x18000053  0xfe00007f  r           -
+fsqrt_s         0x58000053  0xfff0007f  r           -
+fmin_s          0x28000053  0xfe00707f  r           -
+fmax_s          0x28001053  0xfe00707f  r           -
+fmadd_s         0x00000043  0x0600007f  r4          -
+fmsub_s         0x00000047  0x0600007f  r4          -
+fnmsub_s        0x0000004b  0x0600007f  r4          -
+fnmadd_s        0x0000004f  0x0600007f  r4          -
+
+## RV32D Instructions
+fld             0x00003007  0x0000707f  i           -
+fsd             0x00003027  0x0000707f  s           -
+fadd_d          0x02000053  0xfe00007f  r           -
+fsub_d          0x0a000053  0xfe00007f  r           -
+fmul_d          0x12000053  0xfe00007f  r           -
+fdiv_d          0x1a000053  0xfe00007f  r           -
+fsqrt_d         0x5a000053  0xfff0007f  r           -
+fmin_d          0x2a000053  0xfe00707f  r           -
+fmax_d          0x2a001053  0xfe00707f  r           -
+fmadd_d         0x02000043  0x0600007f  r4          -
+fmsub_d         0x02000047  0x0600007f  r4          -
+fnmsub_d        0x0200004b  0x0600007f  r4          -
+fnmadd_d        0x0200004f  0x0600007f  r4          -
+
+## Zifencei
+fence_i         0x0000100f  0x0000707f  none        cont
+
+## Fused instruction pairs
+lui_addi        -           -           -           -
+auipc_jalr      -           -           -           -
+auipc_jr        -           -           -           -
+auipc_ld        -           -           -           -
+slli_srli       -           -           -           -
+addi_bne        -           -           -           -
+
+## Specialised variants picked by the decoder
+nop             -           -           -           -
+li              -           -           -           -
+mv              -           -           -           -
+j               -           -           -           -
+jr              -           -           -           -
+lb_x0           -           -           -           -
+lh_x0           -           -           -           -
+lw_x0           -           -           -           -
+ld_x0           -           -           -           -
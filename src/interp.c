@@ -2,15 +2,13 @@
 #include "rvemu.h"
 
 
-typedef void (func_t)(state_t *, inst_t *);
-
 /////////////////////////////////////////
 // debug related helper macro/functions
 /////////////////////////////////////////
 #ifdef DEBUG
 
 #define _printreg(name, reg) printf("DEBUG: register %s = %lx\n", name, state->gp_regs[reg])
-#define _printimm() printf("DEBUG: imm = %x\n", inst.imm)
+#define _printimm() printf("DEBUG: imm = %x\n", inst->imm)
 
 const char *gp_reg_name[] = {
     "zero", "ra", "sp", "gp", "tp",
@@ -309,7 +307,6 @@ const char *gp_reg_name[] = {
         if (result) { \
             state->exit_reason = indirect_branch; \
             state->reenter_pc = state->pc + (i64) inst->imm; \
-            inst->cont = true; \
             if ((state->reenter_pc & 0x3) != 0) { \
                 state->raise_exception = true; \
                 state->exception_code = instruction_address_misaligned; \
@@ -350,7 +347,7 @@ const char *gp_reg_name[] = {
 
     #define FUNC(type) \
         u64 address = state->gp_regs[inst->rs1] + (i64) inst->imm; \
-        state->gp_regs[inst->rd] =  *((type *) TO_HOST(address)); \
+        state->gp_regs[inst->rd] = *((type *) mmu_host(state, address, sizeof(type), access_load)); \
 
 
     static void exec_lb(state_t *state, inst_t *inst) {
@@ -389,7 +386,7 @@ const char *gp_reg_name[] = {
 
     #define FUNC(type) \
         u64 address = state->gp_regs[inst->rs1] + (i64) inst->imm; \
-        *((type *) TO_HOST(address)) = state->gp_regs[inst->rs2]; \
+        *((type *) mmu_host(state, address, sizeof(type), access_store)) = state->gp_regs[inst->rs2]; \
 
 
     static void exec_sb(state_t *state, inst_t *inst) {
@@ -414,48 +411,72 @@ const char *gp_reg_name[] = {
     // Zicsr instructions
     /////////////////////////////////////////
 
+    // mstatus and satp select the translation, a new satp also invalidates
+    // the decoded blocks of the previous address space
+    static void csr_written(state_t *state, inst_t *inst) {
+        if (inst->imm == mstatus_id || inst->imm == mie_id || inst->imm == stimecmp_id) csr_timer_update(state);
+        if (inst->imm != mstatus_id && inst->imm != satp_id) return;
+        mmu_update(state);
+        if (inst->imm == satp_id) {
+            state->exit_reason = sfence_vma;
+            state->reenter_pc = state->pc + 4;
+        }
+    }
+
     static void exec_csrrw(state_t *state, inst_t *inst) {
         i64 rs1 = state->gp_regs[inst->rs1];
-        u64 csr = (u64) state->csr[inst->csr];
+        u64 csr = csr_read(state, inst->imm);
         if (inst->rd) state->gp_regs[inst->rd] = csr;
-        state->csr[inst->csr] = rs1;
+        csr_write(state, inst->imm, rs1);
+        csr_written(state, inst);
     }
 
     static void exec_csrrs(state_t *state, inst_t *inst) {
         i64 rs1 = state->gp_regs[inst->rs1];
-        u64 csr = (u64) state->csr[inst->csr];
-        state->gp_regs[inst->rd] = csr;
+        u64 csr = csr_read(state, inst->imm);
+        if (inst->rd) state->gp_regs[inst->rd] = csr;
         if (inst->rs1 != 0) {
-            state->csr[inst->csr] = csr | rs1;
+            csr_write(state, inst->imm, csr | rs1);
+            csr_written(state, inst);
         }
     }
 
     static void exec_csrrc(state_t *state, inst_t *inst) {
         i64 rs1 = state->gp_regs[inst->rs1];
-        u64 csr = (u64) state->csr[inst->csr];
-        state->gp_regs[inst->rd] = csr;
-        if (inst->rs1 != 0) state->csr[inst->csr] = csr & ~rs1;
+        u64 csr = csr_read(state, inst->imm);
+        if (inst->rd) state->gp_regs[inst->rd] = csr;
+        if (inst->rs1 != 0) {
+            csr_write(state, inst->imm, csr & ~rs1);
+            csr_written(state, inst);
+        }
     }
 
     static void exec_csrrwi(state_t *state, inst_t *inst) {
-        u64 csr = (u64) state->csr[inst->csr];
-        u32 imm = inst->imm;
+        u64 csr = csr_read(state, inst->imm);
+        u32 imm = inst->rs1;
         if (inst->rd != 0) state->gp_regs[inst->rd] = csr;
-        state->csr[inst->csr] = imm;
+        csr_write(state, inst->imm, imm);
+        csr_written(state, inst);
     }
 
     static void exec_csrrsi(state_t *state, inst_t *inst) {
-        u64 csr = (u64) state->csr[inst->csr];
-        u32 imm = inst->imm;
-        if (imm != 0) state->csr[inst->csr] = csr | imm;
-        state->gp_regs[inst->rd] = csr;
+        u64 csr = csr_read(state, inst->imm);
+        u32 imm = inst->rs1;
+        if (imm != 0) {
+            csr_write(state, inst->imm, csr | imm);
+            csr_written(state, inst);
+        }
+        if (inst->rd != 0) state->gp_regs[inst->rd] = csr;
     }
 
     static void exec_csrrci(state_t *state, inst_t *inst) {
-        u64 csr = (u64) state->csr[inst->csr];
-        u32 imm = inst->imm;
-        if (imm != 0) state->csr[inst->csr] = csr & ~imm;
-        state->gp_regs[inst->rd] = csr;
+        u64 csr = csr_read(state, inst->imm);
+        u32 imm = inst->rs1;
+        if (imm != 0) {
+            csr_write(state, inst->imm, csr & ~imm);
+            csr_written(state, inst);
+        }
+        if (inst->rd != 0) state->gp_regs[inst->rd] = csr;
     }
 
     /////////////////////////////////////////
@@ -466,7 +487,7 @@ const char *gp_reg_name[] = {
 
     #define FUNC(type) \
         u64 address = state->gp_regs[2] + (u64) inst->imm; \
-        state->gp_regs[inst->rd] =  *((type *) TO_HOST(address)); \
+        state->gp_regs[inst->rd] = *((type *) mmu_host(state, address, sizeof(type), access_load)); \
 
 
     static void exec_clwsp(state_t *state, inst_t *inst) {
@@ -483,7 +504,7 @@ const char *gp_reg_name[] = {
 
     #define FUNC(type) \
         u64 address = state->gp_regs[2] + (u64) inst->imm; \
-        *((type *) TO_HOST(address)) = state->gp_regs[inst->rs2]; \
+        *((type *) mmu_host(state, address, sizeof(type), access_store)) = state->gp_regs[inst->rs2]; \
 
 
     static void exec_cswsp(state_t *state, inst_t *inst) {
@@ -500,7 +521,7 @@ const char *gp_reg_name[] = {
 
     #define FUNC(type) \
         u64 address = state->gp_regs[inst->rs1] + (u64) inst->imm; \
-        state->gp_regs[inst->rd] =  *((type *) TO_HOST(address)); \
+        state->gp_regs[inst->rd] = *((type *) mmu_host(state, address, sizeof(type), access_load)); \
 
 
     static void exec_clw(state_t *state, inst_t *inst) {
@@ -517,7 +538,7 @@ const char *gp_reg_name[] = {
 
     #define FUNC(type) \
         u64 address = state->gp_regs[inst->rs1] + (u64) inst->imm; \
-        *((type *) TO_HOST(address)) = state->gp_regs[inst->rs2]; \
+        *((type *) mmu_host(state, address, sizeof(type), access_store)) = state->gp_regs[inst->rs2]; \
 
 
     static void exec_csw(state_t *state, inst_t *inst) {
@@ -539,12 +560,12 @@ const char *gp_reg_name[] = {
 
     static void exec_cjr(state_t *state, inst_t *inst) {
         state->exit_reason = direct_branch;
-        state->reenter_pc = state->pc + state->gp_regs[inst->rs1];
+        state->reenter_pc = state->gp_regs[inst->rs1] & ~(u64)1;
     }
 
     static void exec_cjalr(state_t *state, inst_t *inst) {
         state->exit_reason = direct_branch;
-        state->reenter_pc = state->pc + state->gp_regs[inst->rs1];
+        state->reenter_pc = state->gp_regs[inst->rs1] & ~(u64)1;
         state->gp_regs[1] = state->pc + 2;
     }
 
@@ -627,7 +648,7 @@ const char *gp_reg_name[] = {
     }
 
     static void exec_csub(state_t *state, inst_t *inst) {
-        state->gp_regs[inst->rd] = state->gp_regs[inst->rd] ^ state->gp_regs[inst->rs2];
+        state->gp_regs[inst->rd] = state->gp_regs[inst->rd] - state->gp_regs[inst->rs2];
     }
 
     static void exec_caddw(state_t *state, inst_t *inst) {
@@ -648,12 +669,17 @@ const char *gp_reg_name[] = {
 
     static void exec_mret(state_t *state, inst_t *inst) {
         state->exit_reason = mret;
-        state->reenter_pc = state->csr[mepc_id];
-        csr_set(mstatus, mpv, state->csr[mstatus_id], 0x0);
-        csr_set(mstatus, mpp, state->csr[mstatus_id], 0x0);
-        u8 mpie = csr_get(mstatus, mpie, state->csr[mstatus_id]);
-        csr_set(mstatus, mie, state->csr[mstatus_id], mpie);
-        csr_set(mstatus, mpie, state->csr[mstatus_id], 0x1);
+        state->reenter_pc = csr_read(state, mepc_id);
+        u64 mstatus = csr_read(state, mstatus_id);
+        u64 mpie = csr_get(mstatus, mpie, mstatus);
+        state->priv = csr_get(mstatus, mpp, mstatus);
+        mstatus = csr_set(mstatus, mpv, mstatus, 0x0);
+        mstatus = csr_set(mstatus, mpp, mstatus, 0x0);
+        mstatus = csr_set(mstatus, mie, mstatus, mpie << mstatus_mie_pos);
+        mstatus = csr_set(mstatus, mpie, mstatus, 1ULL << mstatus_mpie_pos);
+        csr_write(state, mstatus_id, mstatus);
+        mmu_update(state);
+        csr_timer_update(state);
     }
 
     /////////////////////////////////////////
@@ -662,13 +688,13 @@ const char *gp_reg_name[] = {
 
     static void exec_flw(state_t *state, inst_t *inst) {
         u64 addr = state->gp_regs[inst->rs1] + inst->imm;
-        state->fp_regs[inst->rd].w = *((u32 *) TO_HOST(addr));
+        state->fp_regs[inst->rd].w = *((u32 *) mmu_host(state, addr, sizeof(u32), access_load));
 
     }
 
     static void exec_fsw(state_t *state, inst_t *inst) {
         u64 addr = state->gp_regs[inst->rs1] + inst->imm;
-        *((u32 *) TO_HOST(addr)) = state->fp_regs[inst->rs2].w;
+        *((u32 *) mmu_host(state, addr, sizeof(u32), access_store)) = state->fp_regs[inst->rs2].w;
     }
 
     #define FUNC(expr) \
@@ -738,13 +764,13 @@ const char *gp_reg_name[] = {
 
     static void exec_fld(state_t *state, inst_t *inst) {
         u64 addr = state->gp_regs[inst->rs1] + inst->imm;
-        state->fp_regs[inst->rd].v = *((u64 *) TO_HOST(addr));
+        state->fp_regs[inst->rd].v = *((u64 *) mmu_host(state, addr, sizeof(u64), access_load));
 
     }
 
     static void exec_fsd(state_t *state, inst_t *inst) {
         u64 addr = state->gp_regs[inst->rs1] + inst->imm;
-        *((u64 *) TO_HOST(addr)) = state->fp_regs[inst->rs2].v;
+        *((u64 *) mmu_host(state, addr, sizeof(u64), access_store)) = state->fp_regs[inst->rs2].v;
     }
 
     #define FUNC(expr) \
@@ -823,69 +849,283 @@ const char *gp_reg_name[] = {
         fatal("unimplemented EBREAK instructions");
     }
 
+    // fence.i: instruction memory may have changed, decoded blocks must be dropped
+    static void exec_fence_i(state_t *state, inst_t *inst) {
+        state->exit_reason = fence_i;
+        state->reenter_pc = state->pc + 4;
+    }
+
+    /////////////////////////////////////////
+    // Supervisor Memory-Management instructions
+    /////////////////////////////////////////
+
+    // sfence.vma rs1, rs2: x0 stands for all the addresses / all the ASIDs
+    static void exec_sfence_vma(state_t *state, inst_t *inst) {
+        mmu_sfence(state, state->gp_regs[inst->rs1], state->gp_regs[inst->rs2] & 0xFFFF,
+                   inst->rs1 == zero, inst->rs2 == zero);
+        state->exit_reason = sfence_vma;
+        state->reenter_pc = state->pc + 4;
+    }
+
+    /////////////////////////////////////////
+    // Fused instruction pairs
+    /////////////////////////////////////////
+
+    // upper immediate of a fused auipc or lui
+    #define UIMM(inst) ((i64) ((inst)->imm & ~0xFFF))
+
+    // lui rd, hi ; addi rd, rd, lo
+    static void exec_lui_addi(state_t *state, inst_t *inst) {
+        state->gp_regs[inst->rd] = UIMM(inst) + FUSED_LO(inst->imm);
+    }
+
+    // auipc rs1, hi ; jalr rd, lo(rs1)
+    static void exec_auipc_jalr(state_t *state, inst_t *inst) {
+        u64 base = state->pc + UIMM(inst);
+        state->gp_regs[inst->rs1] = base;
+        state->gp_regs[inst->rd] = state->pc + 8;
+        state->exit_reason = direct_branch;
+        state->reenter_pc = (base + FUSED_LO(inst->imm)) & ~(u64)1;
+        if ((state->reenter_pc & 0x3) != 0) {
+            fatal("instruction_address_misaligned");
+        }
+    }
+
+    // auipc rs1, hi ; jalr zero, lo(rs1)
+    static void exec_auipc_jr(state_t *state, inst_t *inst) {
+        u64 base = state->pc + UIMM(inst);
+        state->gp_regs[inst->rs1] = base;
+        state->exit_reason = direct_branch;
+        state->reenter_pc = (base + FUSED_LO(inst->imm)) & ~(u64)1;
+        if ((state->reenter_pc & 0x3) != 0) {
+            fatal("instruction_address_misaligned");
+        }
+    }
+
+    // auipc rs1, hi ; ld rd, lo(rs1)
+    static void exec_auipc_ld(state_t *state, inst_t *inst) {
+        u64 base = state->pc + UIMM(inst);
+        state->gp_regs[inst->rs1] = base;
+        state->gp_regs[inst->rd] = *((i64 *) mmu_host(state, base + FUSED_LO(inst->imm), sizeof(i64), access_load));
+    }
+
+    // slli rd, rs1, a ; srli rd, rd, b
+    static void exec_slli_srli(state_t *state, inst_t *inst) {
+        state->gp_regs[inst->rd] = (state->gp_regs[inst->rs1] << FUSED_HI(inst->imm)) >> FUSED_LO(inst->imm);
+    }
+
+    // addi rd, rs1, k ; bne rd, rs2, offset
+    static void exec_addi_bne(state_t *state, inst_t *inst) {
+        state->gp_regs[inst->rd] = state->gp_regs[inst->rs1] + FUSED_LO(inst->imm);
+        if (state->gp_regs[inst->rd] != state->gp_regs[inst->rs2]) {
+            state->exit_reason = indirect_branch;
+            state->reenter_pc = state->pc + FUSED_HI(inst->imm);
+            if ((state->reenter_pc & 0x3) != 0) {
+                state->raise_exception = true;
+                state->exception_code = instruction_address_misaligned;
+                warning("Exception: instruction_address_misaligned");
+            }
+        }
+    }
+
+    #undef UIMM
+
+    /////////////////////////////////////////
+    // Specialised variants
+    /////////////////////////////////////////
+
+    // any instruction writing register zero
+    static void exec_nop(state_t *state, inst_t *inst) {
+    }
+
+    // loads to register zero, the access without its result
+    #define FUNC(type) \
+        u64 address = state->gp_regs[inst->rs1] + (i64) inst->imm; \
+        (void) *((volatile type *) mmu_host(state, address, sizeof(type), access_load)); \
+
+    static void exec_lb_x0(state_t *state, inst_t *inst) {
+        FUNC(i8);
+    }
+
+    static void exec_lh_x0(state_t *state, inst_t *inst) {
+        FUNC(i16);
+    }
+
+    static void exec_lw_x0(state_t *state, inst_t *inst) {
+        FUNC(i32);
+    }
+
+    static void exec_ld_x0(state_t *state, inst_t *inst) {
+        FUNC(i64);
+    }
+
+    #undef FUNC
+
+    // addi rd, zero, imm
+    static void exec_li(state_t *state, inst_t *inst) {
+        state->gp_regs[inst->rd] = (i64) inst->imm;
+    }
+
+    // addi rd, rs1, 0
+    static void exec_mv(state_t *state, inst_t *inst) {
+        state->gp_regs[inst->rd] = state->gp_regs[inst->rs1];
+    }
+
+    #define FUNC(expr) \
+        state->exit_reason = direct_branch; \
+        state->reenter_pc = (expr); \
+        if ((state->reenter_pc & 0x3) != 0) { \
+            fatal("instruction_address_misaligned"); \
+        } \
+
+    // jal zero, offset
+    static void exec_j(state_t *state, inst_t *inst) {
+        FUNC(state->pc + (i64) inst->imm);
+    }
+
+    // jalr zero, offset(rs1)
+    static void exec_jr(state_t *state, inst_t *inst) {
+        FUNC((state->gp_regs[inst->rs1] + (i64) inst->imm) & ~(u64)1);
+    }
+
+    #undef FUNC
 
 
 /////////////////////////////////////////
 // function pointers array
 /////////////////////////////////////////
 
-static func_t *funcs[] = {
+static func_t *const funcs[] = {
 #include "funcs.h"
 };
 
+/**
+ * @brief get the handler of an instruction
+ *
+ * Used by the JIT to call back into the interpreter for the instructions
+ * which are not translated to native code.
+ *
+ * @param type instruction type
+ * @return func_t* the handler
+ */
+func_t *interp_func(enum inst_type_t type) {
+    return funcs[type];
+}
+
 /////////////////////////////////////////
 // Execute the instruction
 /////////////////////////////////////////
 
 
+#ifdef DEBUG
 /**
- * @brief execute the code by interpretation
+ * @brief per instruction debug
  *
  * @param state CPU state
+ * @param inst  the instruction just executed
  */
-void exec_block_interp(state_t *state) {
-    static inst_t inst = {0};
-    while (true) {
-        // Get the instruction pointed by PC.
-        // We already mapped the ELF file to the host memory space
-        // so we can map the pc address to the host address and then
-        // use indirection operator (*) to get the data pointed by the pc
-        // in the host memory space which is the instruction pointed by the PC.
-        u64 raw_inst = *(u64 *) TO_HOST(state->pc);
-
-        // decode the instruction
-        inst_decode(&inst, raw_inst);
-
-
+static void debug_inst(state_t *state, inst_t *inst) {
+    printf("Current PC: %lx. ", state->pc);
+    printf("Decoded Instruction: %d.\n", inst->type);
+
+    // Add more debug code if needed
+    printreg(0x800001ac, ra);
+    printreg(0x800001b0, sp);
+    printreg(0x800001b4, ra);
+    printreg(0x800001b4, sp);
+    printreg(0x800001b4, a4);
+}
+#endif
 
+/**
+ * @brief execute a decoded block, calling the handler through the funcs table
+ *
+ * The block ends with its only control flow instruction, so the loop leaves
+ * either on the first exit_reason raised or after the last instruction. In the
+ * later case pc points to the instruction following the block.
+ *
+ * @param state CPU state
+ * @param block decoded block starting at state->pc
+ */
+static inline void exec_block_call(state_t *state, block_t *block) {
+    inst_t *inst = block->insts;
+    inst_t *end = inst + block->len;
+    for (; inst < end; inst++) {
         // execute the instruction
-        funcs[inst.type](state, &inst);
-        //funcs[0](state, &inst);
+        funcs[inst->type](state, inst);
 
-        // revert back register zero value.
-        state->gp_regs[zero] = 0;
-
-        // per instruction debug
         #ifdef DEBUG
-            printf("Current PC: %lx. ", state->pc);
-            printf("Current Instruction 64: %16lx. ", raw_inst);
-            printf("Current Instruction 32: %8x. ",(u32) raw_inst);
-            printf("Decoded Instruction: %d.\n", inst.type);
-
-            // Add more debug code if needed
-            printreg(0x800001ac, ra);
-            printreg(0x800001b0, sp);
-            printreg(0x800001b4, ra);
-            printreg(0x800001b4, sp);
-            printreg(0x800001b4, a4);
-
+        debug_inst(state, inst);
         #endif
 
-
-        if (inst.cont) break;
+        // taken branch, jump, ecall or mret
+        if (state->exit_reason != none) break;
 
         // advance pc
-        state->pc += inst.rvc ? 2 : 4;
-        //printf("Next PC is %lx\n", state->pc); // For debug only
+        state->pc += INST_LEN(inst);
     }
 }
+
+/**
+ * @brief execute a decoded block with threaded code (computed goto)
+ *
+ * Every handler is inlined under its own label and ends with its own indirect
+ * jump to the handler of the next instruction, so the host branch predictor
+ * sees one dispatch branch per handler instead of a single shared call site.
+ * Only the last instruction of a block can raise an exit_reason, so there is
+ * no exit check between the instructions.
+ *
+ * @param state CPU state
+ * @param block decoded block starting at state->pc
+ */
+static inline void exec_block_threaded(state_t *state, block_t *block) {
+    static void *const labels[] = {
+        #define OP(name) [inst_##name] = &&op_##name,
+        #include "ops.h"
+        #undef OP
+    };
+
+    inst_t *inst = block->insts;
+    inst_t *last = inst + block->len - 1;
+
+    goto *labels[inst->type];
+
+    #ifdef DEBUG
+    #define DEBUG_INST() debug_inst(state, inst)
+    #else
+    #define DEBUG_INST()
+    #endif
+
+    #define OP(name) \
+        op_##name: \
+            exec_##name(state, inst); \
+            DEBUG_INST(); \
+            if (inst == last) goto done; \
+            state->pc += INST_LEN(inst); \
+            inst++; \
+            goto *labels[inst->type];
+    #include "ops.h"
+    #undef OP
+    #undef DEBUG_INST
+
+done:
+    // not taken branch or end of a block without control flow instruction
+    if (state->exit_reason == none) state->pc += INST_LEN(inst);
+}
+
+/**
+ * @brief execute a decoded block by interpretation
+ *
+ * The dispatch engine is selected at build time: threaded code when
+ * THREADED_DISPATCH is defined, calls through the funcs table otherwise.
+ *
+ * @param state CPU state
+ * @param block decoded block starting at state->pc
+ */
+void exec_block_interp(state_t *state, block_t *block) {
+    #ifdef THREADED_DISPATCH
+    exec_block_threaded(state, block);
+    #else
+    exec_block_call(state, block);
+    #endif
+}
@@ -0,0 +1,756 @@
+#include <stddef.h>
+#include "rvemu.h"
+
+/**
+ * x86-64 template JIT
+ *
+ * Each decoded block is translated into host machine code which runs with the
+ * following host registers pinned:
+ *
+ *   rbx: pointer to state_t, guest registers are accessed as [rbx + offset]
+ *   r12: guest window of the machine, guest memory is accessed as [r12 + guest address]
+ *   r13: pointer to the chained jumps counter
+ *
+ * rax, rcx and rdx are used as scratch registers. Integer instructions have a
+ * native template; every other instruction (floating point, csr, division,
+ * indirect jumps...) calls the interpreter handler with the pc set up.
+ *
+ * A compiled block behaves exactly like exec_block_interp: on exit pc either
+ * points to the instruction which raised exit_reason, or to the instruction
+ * following the block. Native loads and stores do not set pc, the guest pc of
+ * a faulting access is found back in jit->accesses by the fault handler.
+ *
+ * Block chaining: every exit returns the block it belongs to, which may not be
+ * the block machine_step entered. Exits to a statically known successor
+ * (branch target, jal target, fall through) start with at least 5 bytes of
+ * code. Once the successor is compiled, jit_link patches the exit with a jump
+ * to the chain entry of the successor, so chained blocks run without going
+ * back to machine_step. A compiled block looks like this:
+ *
+ *   entry:       prologue
+ *                jmp body
+ *   chain entry: inc qword [r13]
+ *   body:        timer check, with --icount only
+ *                mov qword [rbx + block], block
+ *                add qword [rbx + instret], len
+ *                edge coverage, with --coverage only
+ *                ...
+ */
+
+#if defined(__x86_64__)
+
+#define JIT_CODE_SIZE       (64 * 1024 * 1024)
+#define JIT_MAX_INST_SIZE   128     // upper bound of the code emitted for one instruction
+#define JIT_MAX_BLOCK_SIZE  (256 + BLOCK_MAX_INSTS * JIT_MAX_INST_SIZE)
+#define JIT_CHAIN_ENTRY     27      // offset of the chain entry in a compiled block
+
+// host registers
+#define RAX 0
+#define RCX 1
+#define RDX 2
+
+// x86 condition codes
+#define CC_B    0x2
+#define CC_AE   0x3
+#define CC_E    0x4
+#define CC_NE   0x5
+#define CC_L    0xC
+#define CC_GE   0xD
+
+// opcode extensions of the group 1 (81 /ext) and group 2 (C1 /ext, D3 /ext) instructions
+#define EXT_ADD 0
+#define EXT_OR  1
+#define EXT_AND 4
+#define EXT_SUB 5
+#define EXT_XOR 6
+#define EXT_SHL 4
+#define EXT_SHR 5
+#define EXT_SAR 7
+
+// opcodes of reg/reg ALU instructions (op r/m, reg)
+#define OP_ADD  0x01
+#define OP_OR   0x09
+#define OP_AND  0x21
+#define OP_SUB  0x29
+#define OP_XOR  0x31
+#define OP_CMP  0x39
+
+#define GP_OFFSET(reg)  ((u32) (offsetof(state_t, gp_regs) + (reg) * sizeof(u64)))
+#define PC_OFFSET       ((u32) offsetof(state_t, pc))
+#define REENTER_OFFSET  ((u32) offsetof(state_t, reenter_pc))
+#define EXIT_OFFSET     ((u32) offsetof(state_t, exit_reason))
+#define INSTRET_OFFSET  ((u32) offsetof(state_t, instret))
+#define BLOCK_OFFSET    ((u32) offsetof(state_t, block))
+#define TIMER_OFFSET    ((u32) offsetof(state_t, timer))
+#define MEM_OFFSET      ((u32) offsetof(state_t, mem))
+#define COV_MAP_OFFSET  ((u32) offsetof(state_t, cov_map))
+#define COV_PREV_OFFSET ((u32) offsetof(state_t, cov_prev))
+
+/////////////////////////////////////////
+// x86-64 instruction emitters
+/////////////////////////////////////////
+
+static inline void emit8(u8 **p, u8 b) {
+    *(*p)++ = b;
+}
+
+static inline void emit32(u8 **p, u32 v) {
+    memcpy(*p, &v, sizeof(v));
+    *p += sizeof(v);
+}
+
+static inline void emit64(u8 **p, u64 v) {
+    memcpy(*p, &v, sizeof(v));
+    *p += sizeof(v);
+}
+
+// mov r, imm
+static void emit_mov_imm(u8 **p, int r, i64 imm) {
+    if (imm == (i32) imm) {
+        emit8(p, 0x48); emit8(p, 0xC7); emit8(p, 0xC0 | r); emit32(p, imm);
+    } else {
+        emit8(p, 0x48); emit8(p, 0xB8 | r); emit64(p, imm);
+    }
+}
+
+// mov r, gp_regs[reg]
+static void emit_load_reg(u8 **p, int r, i8 reg) {
+    if (reg == zero) {
+        emit8(p, 0x31); emit8(p, 0xC0 | (r << 3) | r);     // xor r32, r32
+        return;
+    }
+    emit8(p, 0x48); emit8(p, 0x8B); emit8(p, 0x83 | (r << 3)); emit32(p, GP_OFFSET(reg));
+}
+
+// mov gp_regs[reg], r ; writes to register zero are dropped
+static void emit_store_reg(u8 **p, int r, i8 reg) {
+    if (reg == zero) return;
+    emit8(p, 0x48); emit8(p, 0x89); emit8(p, 0x83 | (r << 3)); emit32(p, GP_OFFSET(reg));
+}
+
+// mov [rbx + offset], imm ; 64 bits
+static void emit_store_state_imm(u8 **p, u32 offset, i64 imm) {
+    if (imm == (i32) imm) {
+        emit8(p, 0x48); emit8(p, 0xC7); emit8(p, 0x83); emit32(p, offset); emit32(p, imm);
+    } else {
+        emit_mov_imm(p, RAX, imm);
+        emit8(p, 0x48); emit8(p, 0x89); emit8(p, 0x83); emit32(p, offset);
+    }
+}
+
+// mov dword [rbx + exit_reason], reason
+static void emit_set_exit_reason(u8 **p, enum exit_reason_t reason) {
+    emit8(p, 0xC7); emit8(p, 0x83); emit32(p, EXIT_OFFSET); emit32(p, reason);
+}
+
+// op rax, rcx
+static void emit_alu_rr(u8 **p, u8 op) {
+    emit8(p, 0x48); emit8(p, op); emit8(p, 0xC8);
+}
+
+// op eax, ecx
+static void emit_alu32_rr(u8 **p, u8 op) {
+    emit8(p, op); emit8(p, 0xC8);
+}
+
+// op rax, imm32
+static void emit_alu_ri(u8 **p, int ext, i32 imm) {
+    emit8(p, 0x48); emit8(p, 0x81); emit8(p, 0xC0 | (ext << 3)); emit32(p, imm);
+}
+
+// shift rax (eax if !w64) by imm
+static void emit_shift_ri(u8 **p, bool w64, int ext, u8 imm) {
+    if (w64) emit8(p, 0x48);
+    emit8(p, 0xC1); emit8(p, 0xC0 | (ext << 3)); emit8(p, imm);
+}
+
+// shift rax (eax if !w64) by cl
+static void emit_shift_rcl(u8 **p, bool w64, int ext) {
+    if (w64) emit8(p, 0x48);
+    emit8(p, 0xD3); emit8(p, 0xC0 | (ext << 3));
+}
+
+// movsxd rax, eax
+static void emit_sext32(u8 **p) {
+    emit8(p, 0x48); emit8(p, 0x63); emit8(p, 0xC0);
+}
+
+// setcc al ; movzx eax, al
+static void emit_setcc(u8 **p, u8 cc) {
+    emit8(p, 0x0F); emit8(p, 0x90 | cc); emit8(p, 0xC0);
+    emit8(p, 0x0F); emit8(p, 0xB6); emit8(p, 0xC0);
+}
+
+// jcc rel32, returns the location of rel32 to be patched
+static u8 *emit_jcc(u8 **p, u8 cc) {
+    emit8(p, 0x0F); emit8(p, 0x80 | cc);
+    u8 *rel = *p;
+    emit32(p, 0);
+    return rel;
+}
+
+// patch a rel32 to jump to the current location
+static void patch_rel32(u8 **p, u8 *rel) {
+    u32 v = *p - (rel + 4);
+    memcpy(rel, &v, sizeof(v));
+}
+
+// count the edge to the block at pc in the coverage map, see coverage_hit
+static void emit_coverage(u8 **p, u64 pc) {
+    u32 loc = coverage_loc(pc);
+    emit8(p, 0x48); emit8(p, 0x8B); emit8(p, 0x83); emit32(p, COV_MAP_OFFSET);    // mov rax, [rbx + cov_map]
+    emit8(p, 0x8B); emit8(p, 0x8B); emit32(p, COV_PREV_OFFSET);                   // mov ecx, [rbx + cov_prev]
+    emit8(p, 0x81); emit8(p, 0xF1); emit32(p, loc);                               // xor ecx, loc
+    emit8(p, 0xFE); emit8(p, 0x04); emit8(p, 0x08);                               // inc byte [rax + rcx]
+    emit8(p, 0xC7); emit8(p, 0x83); emit32(p, COV_PREV_OFFSET); emit32(p, loc >> 1); // mov dword [rbx + cov_prev], loc >> 1
+}
+
+// return the exiting block
+static void emit_epilogue(u8 **p, block_t *block) {
+    emit8(p, 0x48); emit8(p, 0xB8); emit64(p, (u64) block); // mov rax, imm64
+    emit8(p, 0x41); emit8(p, 0x5D);                 // pop r13
+    emit8(p, 0x41); emit8(p, 0x5C);                 // pop r12
+    emit8(p, 0x5B);                                 // pop rbx
+    emit8(p, 0xC3);                                 // ret
+}
+
+static void emit_prologue(u8 **p, jit_t *jit, block_t *block) {
+    emit8(p, 0x53);                                 // push rbx
+    emit8(p, 0x41); emit8(p, 0x54);                 // push r12
+    emit8(p, 0x41); emit8(p, 0x55);                 // push r13, keeps rsp 16 bytes aligned for calls
+    emit8(p, 0x48); emit8(p, 0x89); emit8(p, 0xFB); // mov rbx, rdi
+    emit8(p, 0x4C); emit8(p, 0x8B); emit8(p, 0xA3); emit32(p, MEM_OFFSET); // mov r12, [rbx + mem]
+    emit8(p, 0x49); emit8(p, 0xBD); emit64(p, (u64) &jit->chained); // mov r13, imm64
+    emit8(p, 0xEB); emit8(p, 0x04);                 // jmp body
+    emit8(p, 0x49); emit8(p, 0xFF); emit8(p, 0x45); emit8(p, 0x00); // chain entry: inc qword [r13]
+    if (jit->icount) {
+        // body: leave before the block when the timer interrupt is due, see machine_step
+        emit8(p, 0x48); emit8(p, 0x8B); emit8(p, 0x83); emit32(p, INSTRET_OFFSET); // mov rax, [rbx + instret]
+        emit8(p, 0x48); emit8(p, 0x3B); emit8(p, 0x83); emit32(p, TIMER_OFFSET);   // cmp rax, [rbx + timer]
+        u8 *skip = emit_jcc(p, CC_B);
+        emit_set_exit_reason(p, interrupt);
+        emit_store_state_imm(p, PC_OFFSET, block->pc);
+        emit_epilogue(p, block);
+        patch_rel32(p, skip);
+    }
+    // mov qword [rbx + block], block ; add qword [rbx + instret], len
+    emit_store_state_imm(p, BLOCK_OFFSET, (u64) block);
+    emit8(p, 0x48); emit8(p, 0x81); emit8(p, 0x83); emit32(p, INSTRET_OFFSET); emit32(p, block->icount);
+}
+
+// leave the block at pc with exit_reason raised, the exit can be patched if link is given
+static void emit_exit_branch(u8 **p, u64 pc, enum exit_reason_t reason, u64 target, block_t *block, link_t *link) {
+    if (link) link->patch = *p;
+    emit_set_exit_reason(p, reason);
+    emit_store_state_imm(p, REENTER_OFFSET, target);
+    emit_store_state_imm(p, PC_OFFSET, pc);
+    emit_epilogue(p, block);
+}
+
+// leave the block and continue at pc, the exit can be patched if link is given
+static void emit_exit_next(u8 **p, u64 pc, block_t *block, link_t *link) {
+    if (link) link->patch = *p;
+    emit_store_state_imm(p, PC_OFFSET, pc);
+    emit_epilogue(p, block);
+}
+
+/////////////////////////////////////////
+// Instruction templates
+/////////////////////////////////////////
+
+// rd = rs1 op imm
+static void emit_op_imm(u8 **p, inst_t *inst, i8 rs1, int ext) {
+    emit_load_reg(p, RAX, rs1);
+    emit_alu_ri(p, ext, inst->imm);
+    emit_store_reg(p, RAX, inst->rd);
+}
+
+// rd = rs1 op rs2
+static void emit_op(u8 **p, i8 rd, i8 rs1, i8 rs2, u8 op, bool w64) {
+    emit_load_reg(p, RAX, rs1);
+    emit_load_reg(p, RCX, rs2);
+    if (w64) {
+        emit_alu_rr(p, op);
+    } else {
+        emit_alu32_rr(p, op);
+        emit_sext32(p);
+    }
+    emit_store_reg(p, RAX, rd);
+}
+
+// rd = rs1 shift imm
+static void emit_shift_imm(u8 **p, i8 rd, i8 rs1, int ext, bool w64, u8 shamt) {
+    emit_load_reg(p, RAX, rs1);
+    emit_shift_ri(p, w64, ext, shamt);
+    if (!w64) emit_sext32(p);
+    emit_store_reg(p, RAX, rd);
+}
+
+// rd = rs1 shift rs2
+static void emit_shift(u8 **p, inst_t *inst, int ext, bool w64) {
+    emit_load_reg(p, RAX, inst->rs1);
+    emit_load_reg(p, RCX, inst->rs2);
+    emit_shift_rcl(p, w64, ext);
+    if (!w64) emit_sext32(p);
+    emit_store_reg(p, RAX, inst->rd);
+}
+
+// rd = rs1 < rs2 (or imm)
+static void emit_slt(u8 **p, inst_t *inst, u8 cc, bool imm) {
+    emit_load_reg(p, RAX, inst->rs1);
+    if (imm) emit_mov_imm(p, RCX, inst->imm);
+    else     emit_load_reg(p, RCX, inst->rs2);
+    emit_alu_rr(p, OP_CMP);
+    emit_setcc(p, cc);
+    emit_store_reg(p, RAX, inst->rd);
+}
+
+// rax = (u32) (base + imm), zero-extended as in TO_HOST
+static void emit_address(u8 **p, i8 base, i32 imm) {
+    emit_load_reg(p, RAX, base);
+    if (imm) emit_alu_ri(p, EXT_ADD, imm);
+    emit8(p, 0x89); emit8(p, 0xC0);     // mov eax, eax
+}
+
+// rd = *(type *) TO_HOST(base + imm)
+static void emit_load_mem(u8 **p, inst_t *inst, i8 base) {
+    emit_address(p, base, inst->imm);
+    switch (inst->type) {
+        // movsx rax, byte [r12 + rax]
+        case inst_lb: emit8(p, 0x49); emit8(p, 0x0F); emit8(p, 0xBE); break;
+        // movsx rax, word [r12 + rax]
+        case inst_lh: emit8(p, 0x49); emit8(p, 0x0F); emit8(p, 0xBF); break;
+        // movsxd rax, dword [r12 + rax]
+        case inst_lw: case inst_clw: case inst_clwsp: emit8(p, 0x49); emit8(p, 0x63); break;
+        // mov rax, [r12 + rax]
+        case inst_ld: case inst_cld: case inst_cldsp: emit8(p, 0x49); emit8(p, 0x8B); break;
+        // movzx eax, byte [r12 + rax]
+        case inst_lbu: emit8(p, 0x41); emit8(p, 0x0F); emit8(p, 0xB6); break;
+        // movzx eax, word [r12 + rax]
+        case inst_lhu: emit8(p, 0x41); emit8(p, 0x0F); emit8(p, 0xB7); break;
+        // mov eax, [r12 + rax]
+        case inst_lwu: emit8(p, 0x41); emit8(p, 0x8B); break;
+        default: unreachable();
+    }
+    emit8(p, 0x04); emit8(p, 0x04);     // modrm/sib: [r12 + rax]
+    emit_store_reg(p, RAX, inst->rd);
+}
+
+// *(type *) TO_HOST(base + imm) = rs2
+static void emit_store_mem(u8 **p, inst_t *inst, i8 base) {
+    emit_address(p, base, inst->imm);
+    emit_load_reg(p, RCX, inst->rs2);
+    switch (inst->type) {
+        // mov [r12 + rax], cl
+        case inst_sb: emit8(p, 0x41); emit8(p, 0x88); break;
+        // mov [r12 + rax], cx
+        case inst_sh: emit8(p, 0x66); emit8(p, 0x41); emit8(p, 0x89); break;
+        // mov [r12 + rax], ecx
+        case inst_sw: case inst_csw: case inst_cswsp: emit8(p, 0x41); emit8(p, 0x89); break;
+        // mov [r12 + rax], rcx
+        case inst_sd: case inst_csd: case inst_csdsp: emit8(p, 0x49); emit8(p, 0x89); break;
+        default: unreachable();
+    }
+    emit8(p, 0x0C); emit8(p, 0x04);     // modrm/sib: [r12 + rax], rcx
+}
+
+// conditional branch on rs1 cc rs2
+static bool emit_branch(u8 **p, u64 pc, u64 next_pc, block_t *block, inst_t *inst, i8 rs2, u8 cc) {
+    // misaligned targets are reported by the interpreter handler
+    if (((pc + (i64) inst->imm) & 0x3) != 0) return false;
+
+    emit_load_reg(p, RAX, inst->rs1);
+    emit_load_reg(p, RCX, rs2);
+    emit_alu_rr(p, OP_CMP);
+    u8 *not_taken = emit_jcc(p, cc ^ 1);
+    emit_exit_branch(p, pc, indirect_branch, pc + (i64) inst->imm, block, &block->links[link_taken]);
+    patch_rel32(p, not_taken);
+    emit_exit_next(p, next_pc, block, &block->links[link_next]);
+    return true;
+}
+
+// call the interpreter handler of the instruction
+static void emit_fallback(u8 **p, u64 pc, u64 next_pc, block_t *block, inst_t *inst, bool last) {
+    emit_store_state_imm(p, PC_OFFSET, pc);
+    emit8(p, 0x48); emit8(p, 0x89); emit8(p, 0xDF);                 // mov rdi, rbx
+    emit8(p, 0x48); emit8(p, 0xBE); emit64(p, (u64) inst);          // mov rsi, imm64
+    emit8(p, 0x48); emit8(p, 0xB8); emit64(p, (u64) interp_func(inst->type)); // mov rax, imm64
+    emit8(p, 0xFF); emit8(p, 0xD0);                                 // call rax
+
+    if (last) {
+        // cmp dword [rbx + exit_reason], none
+        emit8(p, 0x83); emit8(p, 0xBB); emit32(p, EXIT_OFFSET); emit8(p, none);
+        u8 *exit = emit_jcc(p, CC_NE);
+        emit_store_state_imm(p, PC_OFFSET, next_pc);
+        patch_rel32(p, exit);
+        emit_epilogue(p, block);
+    }
+}
+
+/**
+ * @brief emit the native code of an instruction
+ *
+ * @param p       code cursor
+ * @param pc      guest pc of the instruction
+ * @param block   block of the instruction
+ * @param inst    decoded instruction
+ * @param last    the instruction is the last one of its block
+ * @return true   a native template is emitted
+ * @return false  the instruction has no template and nothing is emitted
+ */
+static bool emit_inst(u8 **p, u64 pc, block_t *block, inst_t *inst, bool last) {
+    u64 next_pc = pc + INST_LEN(inst);
+
+    switch (inst->type) {
+        case inst_nop:      break;
+        case inst_li:
+        case inst_lui:
+        case inst_cli:
+        case inst_clui:     emit_mov_imm(p, RAX, inst->imm); emit_store_reg(p, RAX, inst->rd); break;
+        case inst_auipc:    emit_mov_imm(p, RAX, pc + (i64) inst->imm); emit_store_reg(p, RAX, inst->rd); break;
+
+        case inst_addi:
+        case inst_caddi:    emit_op_imm(p, inst, inst->rs1, EXT_ADD); break;
+        case inst_xori:     emit_op_imm(p, inst, inst->rs1, EXT_XOR); break;
+        case inst_ori:      emit_op_imm(p, inst, inst->rs1, EXT_OR);  break;
+        case inst_andi:     emit_op_imm(p, inst, inst->rs1, EXT_AND); break;
+        case inst_candi:    emit_op_imm(p, inst, inst->rd, EXT_AND);  break;
+        case inst_caddi4spn: emit_op_imm(p, inst, sp, EXT_ADD); break;
+        case inst_caddi16sp: {
+            emit_load_reg(p, RAX, sp);
+            emit_alu_ri(p, EXT_ADD, inst->imm);
+            emit_store_reg(p, RAX, sp);
+            break;
+        }
+        case inst_addiw:
+        case inst_caddiw: {
+            emit_load_reg(p, RAX, inst->rs1);
+            emit_alu_ri(p, EXT_ADD, inst->imm);
+            emit_sext32(p);
+            emit_store_reg(p, RAX, inst->rd);
+            break;
+        }
+        case inst_slti:     emit_slt(p, inst, CC_L, true); break;
+        case inst_sltiu:    emit_slt(p, inst, CC_B, true); break;
+
+        case inst_slli:     emit_shift_imm(p, inst->rd, inst->rs1, EXT_SHL, true, inst->imm & 0x3F); break;
+        case inst_srli:     emit_shift_imm(p, inst->rd, inst->rs1, EXT_SHR, true, inst->imm & 0x3F); break;
+        case inst_srai:     emit_shift_imm(p, inst->rd, inst->rs1, EXT_SAR, true, inst->imm & 0x3F); break;
+        case inst_cslli:    emit_shift_imm(p, inst->rd, inst->rd, EXT_SHL, true, inst->imm & 0x3F); break;
+        case inst_csrli:    emit_shift_imm(p, inst->rd, inst->rd, EXT_SHR, true, inst->imm & 0x3F); break;
+        case inst_csrai:    emit_shift_imm(p, inst->rd, inst->rd, EXT_SAR, true, inst->imm & 0x3F); break;
+        case inst_slliw:    emit_shift_imm(p, inst->rd, inst->rs1, EXT_SHL, false, inst->imm & 0x1F); break;
+        case inst_srliw:    emit_shift_imm(p, inst->rd, inst->rs1, EXT_SHR, false, inst->imm & 0x1F); break;
+        case inst_sraiw:    emit_shift_imm(p, inst->rd, inst->rs1, EXT_SAR, false, inst->imm & 0x1F); break;
+
+        case inst_add:      emit_op(p, inst->rd, inst->rs1, inst->rs2, OP_ADD, true); break;
+        case inst_sub:      emit_op(p, inst->rd, inst->rs1, inst->rs2, OP_SUB, true); break;
+        case inst_and:      emit_op(p, inst->rd, inst->rs1, inst->rs2, OP_AND, true); break;
+        case inst_or:       emit_op(p, inst->rd, inst->rs1, inst->rs2, OP_OR,  true); break;
+        case inst_xor:      emit_op(p, inst->rd, inst->rs1, inst->rs2, OP_XOR, true); break;
+        case inst_addw:     emit_op(p, inst->rd, inst->rs1, inst->rs2, OP_ADD, false); break;
+        case inst_subw:     emit_op(p, inst->rd, inst->rs1, inst->rs2, OP_SUB, false); break;
+        case inst_cadd:     emit_op(p, inst->rd, inst->rd, inst->rs2, OP_ADD, true); break;
+        case inst_cand:     emit_op(p, inst->rd, inst->rd, inst->rs2, OP_AND, true); break;
+        case inst_cor:      emit_op(p, inst->rd, inst->rd, inst->rs2, OP_OR,  true); break;
+        case inst_cxor:     emit_op(p, inst->rd, inst->rd, inst->rs2, OP_XOR, true); break;
+        case inst_csub:     emit_op(p, inst->rd, inst->rd, inst->rs2, OP_SUB, true); break;
+        case inst_caddw:    emit_op(p, inst->rd, inst->rd, inst->rs2, OP_ADD, false); break;
+        case inst_csubw:    emit_op(p, inst->rd, inst->rd, inst->rs2, OP_SUB, false); break;
+        case inst_mv:       emit_load_reg(p, RAX, inst->rs1); emit_store_reg(p, RAX, inst->rd); break;
+        case inst_cmv:      emit_load_reg(p, RAX, inst->rs2); emit_store_reg(p, RAX, inst->rd); break;
+        case inst_cnop:     break;
+
+        case inst_sll:      emit_shift(p, inst, EXT_SHL, true);  break;
+        case inst_srl:      emit_shift(p, inst, EXT_SHR, true);  break;
+        case inst_sra:      emit_shift(p, inst, EXT_SAR, true);  break;
+        case inst_sllw:     emit_shift(p, inst, EXT_SHL, false); break;
+        case inst_srlw:     emit_shift(p, inst, EXT_SHR, false); break;
+        case inst_sraw:     emit_shift(p, inst, EXT_SAR, false); break;
+        case inst_slt:      emit_slt(p, inst, CC_L, false); break;
+        case inst_sltu:     emit_slt(p, inst, CC_B, false); break;
+
+        case inst_mul:
+        case inst_mulw: {
+            emit_load_reg(p, RAX, inst->rs1);
+            emit_load_reg(p, RCX, inst->rs2);
+            if (inst->type == inst_mul) emit8(p, 0x48);
+            emit8(p, 0x0F); emit8(p, 0xAF); emit8(p, 0xC1);         // imul rax, rcx
+            if (inst->type == inst_mulw) emit_sext32(p);
+            emit_store_reg(p, RAX, inst->rd);
+            break;
+        }
+
+        case inst_lb: case inst_lh: case inst_lw: case inst_ld:
+        case inst_lbu: case inst_lhu: case inst_lwu:
+        case inst_clw: case inst_cld:
+            emit_load_mem(p, inst, inst->rs1); break;
+        case inst_clwsp: case inst_cldsp:
+            emit_load_mem(p, inst, sp); break;
+        case inst_sb: case inst_sh: case inst_sw: case inst_sd:
+        case inst_csw: case inst_csd:
+            emit_store_mem(p, inst, inst->rs1); break;
+        case inst_cswsp: case inst_csdsp:
+            emit_store_mem(p, inst, sp); break;
+
+        case inst_beq:      return emit_branch(p, pc, next_pc, block, inst, inst->rs2, CC_E);
+        case inst_bne:      return emit_branch(p, pc, next_pc, block, inst, inst->rs2, CC_NE);
+        case inst_blt:      return emit_branch(p, pc, next_pc, block, inst, inst->rs2, CC_L);
+        case inst_bge:      return emit_branch(p, pc, next_pc, block, inst, inst->rs2, CC_GE);
+        case inst_bltu:     return emit_branch(p, pc, next_pc, block, inst, inst->rs2, CC_B);
+        case inst_bgeu:     return emit_branch(p, pc, next_pc, block, inst, inst->rs2, CC_AE);
+        case inst_cbeqz:    return emit_branch(p, pc, next_pc, block, inst, zero, CC_E);
+        case inst_cbnez:    return emit_branch(p, pc, next_pc, block, inst, zero, CC_NE);
+
+        case inst_jal: {
+            u64 target = pc + (i64) inst->imm;
+            // misaligned targets are reported by the interpreter handler
+            if ((target & 0x3) != 0) return false;
+            emit_mov_imm(p, RAX, next_pc);
+            emit_store_reg(p, RAX, inst->rd);
+            emit_exit_branch(p, pc, direct_branch, target, block, &block->links[link_taken]);
+            break;
+        }
+        case inst_j: {
+            u64 target = pc + (i64) inst->imm;
+            // misaligned targets are reported by the interpreter handler
+            if ((target & 0x3) != 0) return false;
+            emit_exit_branch(p, pc, direct_branch, target, block, &block->links[link_taken]);
+            break;
+        }
+        case inst_cj: {
+            emit_exit_branch(p, pc, direct_branch, pc + (i64) inst->imm, block, &block->links[link_taken]);
+            break;
+        }
+
+        case inst_lui_addi: {
+            emit_mov_imm(p, RAX, (i64) (inst->imm & ~0xFFF) + FUSED_LO(inst->imm));
+            emit_store_reg(p, RAX, inst->rd);
+            break;
+        }
+        case inst_auipc_ld: {
+            u64 base = pc + (i64) (inst->imm & ~0xFFF);
+            emit_mov_imm(p, RAX, base);
+            emit_store_reg(p, RAX, inst->rs1);
+            emit_mov_imm(p, RAX, (u32) (base + FUSED_LO(inst->imm)));
+            emit8(p, 0x49); emit8(p, 0x8B); emit8(p, 0x04); emit8(p, 0x04);  // mov rax, [r12 + rax]
+            emit_store_reg(p, RAX, inst->rd);
+            break;
+        }
+        case inst_slli_srli: {
+            emit_load_reg(p, RAX, inst->rs1);
+            emit_shift_ri(p, true, EXT_SHL, FUSED_HI(inst->imm));
+            emit_shift_ri(p, true, EXT_SHR, FUSED_LO(inst->imm));
+            emit_store_reg(p, RAX, inst->rd);
+            break;
+        }
+        case inst_addi_bne: {
+            u64 target = pc + FUSED_HI(inst->imm);
+            // misaligned targets are reported by the interpreter handler
+            if ((target & 0x3) != 0) return false;
+            emit_load_reg(p, RAX, inst->rs1);
+            emit_alu_ri(p, EXT_ADD, FUSED_LO(inst->imm));
+            emit_store_reg(p, RAX, inst->rd);
+            emit_load_reg(p, RCX, inst->rs2);
+            emit_alu_rr(p, OP_CMP);
+            u8 *not_taken = emit_jcc(p, CC_E);
+            emit_exit_branch(p, pc, indirect_branch, target, block, &block->links[link_taken]);
+            patch_rel32(p, not_taken);
+            emit_exit_next(p, next_pc, block, &block->links[link_next]);
+            return true;
+        }
+
+        case inst_ecall: {
+            emit_set_exit_reason(p, ecall);
+            emit_exit_next(p, pc, block, NULL);
+            break;
+        }
+
+        default: return false;
+    }
+
+    // the block ends without control flow instruction
+    if (last && !inst->cont) emit_exit_next(p, next_pc, block, &block->links[link_next]);
+    return true;
+}
+
+/////////////////////////////////////////
+// Code buffer management
+/////////////////////////////////////////
+
+// native templates accessing guest memory
+static bool inst_accesses_memory(inst_t *inst) {
+    switch (inst->type) {
+        case inst_lb: case inst_lh: case inst_lw: case inst_ld:
+        case inst_lbu: case inst_lhu: case inst_lwu:
+        case inst_clw: case inst_cld: case inst_clwsp: case inst_cldsp:
+        case inst_sb: case inst_sh: case inst_sw: case inst_sd:
+        case inst_csw: case inst_csd: case inst_cswsp: case inst_csdsp:
+        case inst_auipc_ld:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief remember the guest pc of the native code of a memory access
+ *
+ * @param jit    pointer to the jit
+ * @param offset offset of the code of the instruction in the code buffer
+ * @param pc     guest pc of the instruction
+ */
+static void jit_add_access(jit_t *jit, u64 offset, u64 pc) {
+    if (jit->num_accesses == jit->max_accesses) {
+        jit->max_accesses = jit->max_accesses ? jit->max_accesses * 2 : 4096;
+        jit->accesses = realloc(jit->accesses, jit->max_accesses * sizeof(jit_access_t));
+        if (!jit->accesses) fatal("realloc failed.");
+    }
+    jit->accesses[jit->num_accesses++] = (jit_access_t) {.offset = offset, .pc = pc};
+}
+
+/**
+ * @brief allocate the executable code buffer
+ *
+ * @param jit pointer to the jit
+ */
+void jit_init(jit_t *jit) {
+    jit->code = mmap(NULL, JIT_CODE_SIZE, PROT_READ | PROT_WRITE | PROT_EXEC,
+                     MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    if (jit->code == MAP_FAILED) fatal(strerror(errno));
+    jit->size = JIT_CODE_SIZE;
+    jit->used = 0;
+}
+
+/**
+ * @brief translate a decoded block into host code
+ *
+ * @param jit   pointer to the jit
+ * @param block decoded block
+ * @return jit_func_t* the compiled block or NULL if the code buffer is full
+ */
+jit_func_t *jit_compile(jit_t *jit, block_t *block) {
+    if (jit->used + JIT_MAX_BLOCK_SIZE > jit->size) return NULL;
+
+    u8 *start = jit->code + jit->used;
+    u8 *p = start;
+    u64 pc = block->pc;
+
+    emit_prologue(&p, jit, block);
+    assert(p - start > JIT_CHAIN_ENTRY);
+    if (jit->coverage) emit_coverage(&p, pc);
+    for (u32 i = 0; i < block->len; i++) {
+        inst_t *inst = &block->insts[i];
+        bool last = i == block->len - 1;
+        u64 next_pc = pc + INST_LEN(inst);
+
+        // translated accesses go through the TLB of the interpreter handlers
+        u8 *code = p;
+        bool translated = block->translate && inst_accesses_memory(inst);
+        if (!translated && emit_inst(&p, pc, block, inst, last)) {
+            if (inst_accesses_memory(inst)) jit_add_access(jit, code - jit->code, pc);
+            jit->templates++;
+        } else {
+            emit_fallback(&p, pc, next_pc, block, inst, last);
+            jit->fallbacks++;
+        }
+        pc = next_pc;
+    }
+
+    // calls always go back to machine_step to feed the return-address stack
+    if (block->call) block->links[link_taken].patch = NULL;
+
+    assert(p - start <= JIT_MAX_BLOCK_SIZE);
+    jit->used += ROUNDUP(p - start, 16);
+    jit->blocks++;
+    return (jit_func_t *) start;
+}
+
+/**
+ * @brief drop all the compiled code, the blocks referring to it must be dropped too
+ *
+ * @param jit pointer to the jit
+ */
+void jit_flush(jit_t *jit) {
+    jit->used = 0;
+    jit->num_accesses = 0;
+}
+
+/**
+ * @brief release the code buffer
+ *
+ * @param jit pointer to the jit
+ */
+void jit_free(jit_t *jit) {
+    munmap(jit->code, jit->size);
+    free(jit->accesses);
+}
+
+/**
+ * @brief find the guest pc of a faulting native memory access, called by the signal handler
+ *
+ * The accesses are recorded in code order: the faulting one is the last one
+ * starting at or before the faulting host instruction.
+ *
+ * @param jit   pointer to the jit
+ * @param host  host address of the faulting instruction
+ * @param pc    guest pc of the access
+ * @return true the fault is in the compiled code
+ * @return false the fault is elsewhere, pc is not changed
+ */
+bool jit_fault_pc(jit_t *jit, u64 host, u64 *pc) {
+    if (host < (u64) jit->code || host >= (u64) jit->code + jit->used) return false;
+
+    u64 offset = host - (u64) jit->code;
+    u64 lo = 0, hi = jit->num_accesses;
+    while (lo < hi) {
+        u64 mid = (lo + hi) / 2;
+        if (jit->accesses[mid].offset <= offset) lo = mid + 1;
+        else                                     hi = mid;
+    }
+    if (!lo) return false;
+    *pc = jit->accesses[lo - 1].pc;
+    return true;
+}
+
+/**
+ * @brief link a block exit to its successor, patching the exit into a direct
+ * jump when both blocks are compiled
+ *
+ * @param link  exit of the predecessor block
+ * @param block successor block
+ */
+void jit_link(link_t *link, block_t *block) {
+    link->block = block;
+    if (!link->patch || !block->code) return;
+
+    u8 *p = link->patch;
+    emit8(&p, 0xE9);                                // jmp rel32
+    emit32(&p, (u8 *) block->code + JIT_CHAIN_ENTRY - (p + 4));
+}
+
+#else
+
+void jit_init(jit_t *jit) {
+    fatal("the JIT is only supported on x86-64 hosts");
+}
+
+jit_func_t *jit_compile(jit_t *jit, block_t *block) {
+    unreachable();
+}
+
+void jit_flush(jit_t *jit) {
+}
+
+void jit_free(jit_t *jit) {
+}
+
+void jit_link(link_t *link, block_t *block) {
+    link->block = block;
+}
+
+bool jit_fault_pc(jit_t *jit, u64 host, u64 *pc) {
+    return false;
+}
+
+#endif
@@ -1,25 +1,163 @@
 #include "rvemu.h"
 
+/**
+ * @brief find the link to follow after a block exit
+ *
+ * @param m     pointer to machine, pc is the guest pc to continue at
+ * @param block block whose exit was taken
+ * @return link_t* link to the next block or NULL if the next block must be looked up
+ */
+static link_t *machine_next_link(machine_t *m, block_t *block) {
+    cache_t *cache = &m->cache;
+    u64 pc = m->state.pc;
+    link_t *link = NULL;
+
+    if (block->call) cache_ras_push(cache, &block->links[link_return]);
+
+    switch (block->jump) {
+        case jump_return:
+            link = cache_ras_pop(cache, pc);
+            if (link) return link;
+            return cache_jump_lookup(cache, pc);
+        case jump_indirect:
+            return cache_jump_lookup(cache, pc);
+        default:
+            // the exit taken is found by its target
+            for (int i = link_taken; i <= link_next && !link; i++) {
+                if (block->links[i].valid && block->links[i].pc == pc) link = &block->links[i];
+            }
+            return link;
+    }
+}
 
 /**
- * @brief execute multiple instructions till we hit a ecall
+ * @brief drop the decoded blocks and the compiled code
  *
  * @param m pointer to machine
- * @return enum exit_reason_t
  */
-enum exit_reason_t machine_step(machine_t *m) {
+void machine_flush(machine_t *m) {
+    cache_flush(&m->cache);
+    jit_flush(&m->jit);
+    m->state.block = NULL;
+    m->cache.translate = m->state.translate;
+    m->cache.priv = m->state.priv;
+}
+
+/**
+ * @brief drop the decoded blocks if they were fetched with another address translation
+ *
+ * Blocks are looked up by guest pc, which only names the same code as long as
+ * the translation and the privilege checked on fetch stay the same.
+ *
+ * @param m pointer to machine
+ */
+static void machine_sync_translation(machine_t *m) {
+    if (m->cache.translate == m->state.translate && (!m->state.translate || m->cache.priv == m->state.priv)) return;
+    machine_flush(m);
+}
+
+/**
+ * @brief decode the block at pc, a fault while reading the guest code is an instruction access fault
+ *
+ * @param m pointer to machine
+ * @return block_t* the decoded block
+ */
+static block_t *machine_decode(machine_t *m) {
+    m->fetching = true;
+    block_t *block = cache_add(&m->cache, &m->state, m->state.pc);
+    m->fetching = false;
+    return block;
+}
+
+/**
+ * @brief run blocks till an ecall, the dispatch loop of machine_step
+ *
+ * Inlined twice, with and without coverage, so that the loop without it has
+ * no trace of it. Compiled blocks record their own edges (see jit.c).
+ *
+ * @param m        pointer to machine
+ * @param coverage record the edges of the interpreted blocks in the coverage map
+ */
+static inline __attribute__((always_inline)) void machine_loop(machine_t *m, const bool coverage) {
+    // link to the next block: a static exit, a jump cache entry or a predicted return
+    link_t *link = NULL;
+
     while(true) {
-        exec_block_interp(&m->state);
+        // follow the chain to the successor block, otherwise replay the
+        // decoded block at pc, decode it on the first visit
+        block_t *block;
+        if (link && link->block) {
+            block = link->block;
+            m->cache.chained++;
+        } else {
+            block = cache_lookup(&m->cache, m->state.pc);
+            if (!block) block = machine_decode(m);
+            m->cache.unchained++;
+        }
+
+        if (m->use_jit) {
+            if (!block->code) block->code = jit_compile(&m->jit, block);
+            if (!block->code) {
+                // code buffer is full, start over with empty buffer and cache
+                machine_flush(m);
+                link = NULL;
+                block = machine_decode(m);
+                block->code = jit_compile(&m->jit, block);
+            }
+            if (link) jit_link(link, block);
+            // compiled code counts the retired instructions itself, and
+            // may leave through a block chained to this one
+            block = ((jit_func_t *) block->code)(&m->state);
+        } else {
+            if (link) link->block = block;
+            if (m->state.instret >= m->state.timer) {
+                // the timer interrupt is taken before the block, as compiled blocks do
+                m->state.exit_reason = interrupt;
+            } else {
+                if (coverage) coverage_hit(&m->state, block->pc);
+                // counted before the block runs, the counters read in a block agree with the JIT
+                m->state.block = block;
+                m->state.instret += block->icount;
+                exec_block_interp(&m->state, block);
+            }
+        }
+
+        // fall through to the next block
+        if (m->state.exit_reason == none) {
+            link = machine_next_link(m, block);
+            continue;
+        }
 
         // continue execution if it is indirect branch or direct branch
         if (m->state.exit_reason == indirect_branch || m->state.exit_reason == direct_branch) {
             m->state.exit_reason = none;
             m->state.pc = m->state.reenter_pc;
+            link = machine_next_link(m, block);
             continue;
         }
 
-        // continue execution if it is mret
+        // continue execution if it is mret, the privilege may have changed
         if (m->state.exit_reason == mret) {
+            machine_sync_translation(m);
+            link = NULL;
+            m->state.exit_reason = none;
+            m->state.pc = m->state.reenter_pc;
+            continue;
+        }
+
+        // --icount timer, the block at pc has not run
+        if (m->state.exit_reason == interrupt) {
+            m->state.exit_reason = none;
+            trap_interrupt(&m->state);
+            machine_sync_translation(m);
+            link = NULL;
+            continue;
+        }
+
+        // guest code or its mapping may have been modified, drop the decoded blocks
+        if (m->state.exit_reason == fence_i || m->state.exit_reason == sfence_vma) {
+            machine_flush(m);
+            link = NULL;
             m->state.exit_reason = none;
             m->state.pc = m->state.reenter_pc;
             continue;
@@ -32,10 +170,122 @@ enum exit_reason_t machine_step(machine_t *m) {
         assert(m->state.exit_reason == ecall);
         break;
     }
+}
+
+/**
+ * @brief execute multiple instructions till we hit a ecall
+ *
+ * @param m pointer to machine
+ * @return enum exit_reason_t
+ */
+enum exit_reason_t machine_step(machine_t *m) {
+    // guest accesses to unmapped memory come back here, the trap is taken and
+    // execution goes on at the trap handler
+    if (sigsetjmp(m->trap_jmp, 0)) {
+        trap_access_fault(m);
+        machine_sync_translation(m);
+    }
+    trap_attach(m);
 
+    if (m->state.cov_map) machine_loop(m, true);
+    else                  machine_loop(m, false);
+
+    trap_detach();
     return ecall;
 }
 
+/**
+ * @brief print the execution statistics to stderr
+ *
+ * @param m pointer to machine
+ */
+void machine_print_stats(machine_t *m) {
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    f64 elapsed = (end.tv_sec - m->start.tv_sec) + (end.tv_nsec - m->start.tv_nsec) * 1e-9;
+
+    #ifdef THREADED_DISPATCH
+    const char *engine = m->use_jit ? "jit" : "threaded";
+    #else
+    const char *engine = m->use_jit ? "jit" : "call";
+    #endif
+    fprintf(stderr, "engine: %s, %lu instructions in %.3f s, %.2f MIPS\n",
+            engine, m->state.instret, elapsed, elapsed > 0 ? m->state.instret / elapsed * 1e-6 : 0.0);
+    if (m->state.mhz) {
+        fprintf(stderr, "icount: %lu MHz, %.6f s of guest time\n", m->state.mhz, (f64) m->state.instret / m->state.mhz * 1e-6);
+    }
+
+    cache_t *cache = &m->cache;
+    u64 lookups = cache->hits + cache->misses;
+    fprintf(stderr, "block cache: %lu blocks, %lu hits, %lu misses, hit rate %.2f%%\n",
+            cache->count, cache->hits, cache->misses,
+            lookups ? 100.0 * cache->hits / lookups : 0.0);
+
+    u64 chained = cache->chained + m->jit.chained;
+    u64 transitions = chained + cache->unchained;
+    fprintf(stderr, "chaining: %lu chained, %lu unchained block transitions, %.2f%% chained\n",
+            chained, cache->unchained, transitions ? 100.0 * chained / transitions : 0.0);
+
+    fprintf(stderr, "fusion: %s, %lu pairs fused\n", cache->fuse ? "on" : "off", cache->fused);
+
+    u64 jumps = cache->jump_hits + cache->jump_misses;
+    u64 returns = cache->ras_hits + cache->ras_misses;
+    fprintf(stderr, "jump cache: %lu hits, %lu misses, hit rate %.2f%%\n",
+            cache->jump_hits, cache->jump_misses, jumps ? 100.0 * cache->jump_hits / jumps : 0.0);
+    fprintf(stderr, "return stack: %lu hits, %lu misses, hit rate %.2f%%\n",
+            cache->ras_hits, cache->ras_misses, returns ? 100.0 * cache->ras_hits / returns : 0.0);
+
+    u64 cycles, insts, l1d_misses;
+    if (perf_read(&m->perf, perf_cycles, &cycles) && perf_read(&m->perf, perf_instructions, &insts) &&
+        perf_read(&m->perf, perf_l1d_misses, &l1d_misses)) {
+        f64 guest = m->state.instret ? m->state.instret : 1;
+        fprintf(stderr, "host: IPC %.2f, %.2f instructions and %.3f L1d misses per guest instruction\n",
+                cycles ? (f64) insts / cycles : 0.0, insts / guest, l1d_misses / guest);
+    } else {
+        fprintf(stderr, "host: hardware counters unavailable\n");
+    }
+
+    tlb_t *tlb = &m->state.tlb;
+    if (tlb->hits || tlb->misses) {
+        fprintf(stderr, "tlb: %lu hits, %lu misses, %lu flushes, hit rate %.2f%%\n",
+                tlb->hits, tlb->misses, tlb->flushes, 100.0 * tlb->hits / (tlb->hits + tlb->misses));
+    }
+
+    mmu_t *mmu = &m->mmu;
+    fprintf(stderr, "heap: %lu brk changes, %lu host mmap (%lu avoided), %lu host munmap (%lu avoided)\n",
+            mmu->brks, mmu->maps, mmu->page_maps - mmu->maps, mmu->unmaps, mmu->page_unmaps - mmu->unmaps);
+    if (mmu->hugetlb) fprintf(stderr, "hugetlb: %lu commits without free huge pages\n", mmu->huge_fallbacks);
+
+    console_t *console = &m->console;
+    fprintf(stderr, "console: %lu guest writes, %lu host writes\n", console->writes, console->host_writes);
+
+    uring_t *ring = &m->uring;
+    if (ring->enabled) {
+        fprintf(stderr, "io_uring: %lu writes queued (%lu merged), %lu reads (%lu from readahead), %lu waits\n",
+                ring->writes, ring->merged, ring->reads, ring->ra_hits, ring->waits);
+    }
+
+    if (m->state.cov_map) fprintf(stderr, "coverage: %lu edges\n", coverage_edges(m));
+
+    replay_t *replay = &m->replay;
+    if (replay->mode != replay_off) {
+        fprintf(stderr, "%s: %lu syscalls, %lu bytes of guest memory\n",
+                replay->mode == replay_record ? "record" : "replay", replay->syscalls, replay->bytes);
+    }
+
+    checkpoint_t *checkpoint = &m->checkpoint;
+    if (checkpoint->every) {
+        fprintf(stderr, "checkpoint: %lu taken, %lu pages, %lu bytes, guest paused %.3f ms\n",
+                checkpoint->taken, checkpoint->pages, checkpoint->bytes, checkpoint->pause * 1e3);
+    }
+
+    if (m->use_jit) {
+        jit_t *jit = &m->jit;
+        fprintf(stderr, "jit: %lu blocks compiled, %lu bytes of code, %lu native / %lu fallback instructions\n",
+                jit->blocks, jit->used, jit->templates, jit->fallbacks);
+    }
+}
+
 /**
  * @brief Load the program into memory
  * @param m: pointer to a machine
@@ -48,12 +298,84 @@ void machine_load_program(machine_t *m, char *prog) {
         fatal(strerror(errno));
     }
 
+    machine_load_elf(m, fd);
+    close(fd);
+}
+
+/**
+ * @brief Load the program of an open ELF file into memory
+ * @param m: pointer to a machine
+ * @param fd: ELF file, only read at offsets and mapped, it can be shared by machines
+ */
+void machine_load_elf(machine_t *m, int fd) {
     // load ELF information to MMU
+    mmu_init(&(m->mmu));
     mmu_load_elf(&(m->mmu), fd);
-    close(fd);
+    m->state.mem = m->mmu.mem;
 
     // assign the program entry to current PC
     m->state.pc = m->mmu.entry;
+    m->state.priv = priv_m;
+    m->cache.priv = priv_m;
+    m->state.timer = UINT64_MAX;
+}
+
+/**
+ * @brief run the guest till it exits, serving its syscalls
+ *
+ * With --fork-server, the run stops at the ready point of the guest as well
+ * (see snapshot.c), snapshot.ready is then set and the guest is not exited.
+ * With --checkpoint-every, the checkpoints are taken after the syscalls.
+ *
+ * @param m pointer to machine, loaded and set up
+ * @return int exit status of the guest, 0 at the ready point
+ */
+int machine_run(machine_t *m) {
+    while (true) {
+        enum exit_reason_t reason = machine_step(m);
+        assert(reason == ecall);
+
+        if (m->snapshot.pc == m->state.pc && m->snapshot.pc) {
+            // ecall planted at the ready point, the guest resumes with the instruction it replaced
+            snapshot_reached(m);
+        } else {
+            u64 syscall = machine_get_gp_reg(m, a7);
+            u64 ret = do_syscall(m, syscall);
+            if (m->exited) return m->exit_code;
+            machine_set_gp_reg(m, a0, ret);
+            m->state.pc += 4;            // resume after the ecall
+        }
+        m->state.exit_reason = none; // reset the exit_reason
+        if (m->checkpoint.every && m->state.instret >= m->checkpoint.next) checkpoint_take(m);
+        if (m->snapshot.ready) return 0;
+    }
+}
+
+/**
+ * @brief release everything a machine holds, its guest window included
+ *
+ * The guest output is written out and its writes in flight are waited for,
+ * the files it left open are closed. The machine may have been stopped at
+ * any point of its setup or of its run.
+ *
+ * @param m pointer to machine
+ */
+void machine_free(machine_t *m) {
+    uring_free(&m->uring);
+    console_flush(&m->console);
+    free(m->console.buf);
+    for (int fd = 0; fd < GUEST_MAX_FDS; fd++) {
+        if (m->fds[fd] > STDERR_FILENO) close(m->fds[fd]);
+    }
+    if (m->stats) {
+        for (int i = 0; i < num_perf_counters; i++) {
+            if (m->perf.fds[i] >= 0) close(m->perf.fds[i]);
+        }
+    }
+    for (int i = 0; i < CSR_NUM_PAGES; i++) free(m->state.csr.pages[i]);
+    cache_free(&m->cache);
+    if (m->use_jit) jit_free(&m->jit);
+    if (m->mmu.mem) mmu_free(&m->mmu);
 }
 
 void machine_setup(machine_t *m, int argc, char *argv[]) {
@@ -76,14 +398,20 @@ void machine_setup(machine_t *m, int argc, char *argv[]) {
         size_t len = strlen(argv[i]);
         // argv[i] is a string, we need to allocate the addition '\0' character
         u64 addr = mmu_alloc(&m->mmu, len+1);
-        mmu_write(addr, (u8 *) argv[i], len);
+        mmu_write(&m->mmu, addr, (u8 *) argv[i], len);
         // store the address of the argument into stack (argc is char** type)
         m->state.gp_regs[sp] -= 8; // argv[i]
-        mmu_write(m->state.gp_regs[sp], (u8 *) &addr, sizeof(u64));
+        mmu_write(&m->mmu, m->state.gp_regs[sp], (u8 *) &addr, sizeof(u64));
     }
 
     m->state.gp_regs[sp] -= 8; // argc
-    mmu_write(m->state.gp_regs[sp], (u8 *) &args, sizeof(u64));
+    mmu_write(&m->mmu, m->state.gp_regs[sp], (u8 *) &args, sizeof(u64));
+    m->mmu.heap = m->mmu.alloc;
+
+    syscall_init(m);
+    trap_init();
+    if (m->stats) perf_open(&m->perf);
+    clock_gettime(CLOCK_MONOTONIC, &m->start);
 
 }
 
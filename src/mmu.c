@@ -1,5 +1,8 @@
+#include <asm/unistd.h>
 #include "rvemu.h"
 
+#define MPOL_BIND   2   // mbind mode of numaif.h, not needed otherwise
+
 /**
  * Memory Mapping between host program and guest program
  *
@@ -10,12 +13,88 @@
  * guest program is stored in the low address in the machine (e.g. entry: 0x10xxx)
  *
  * we add an offset to address of guest program to map the guest program address space
- * into host program memory space
+ * into host program memory space. The offset, mmu->mem, is the host address
+ * of the guest window of the machine: every machine has its own window, where
+ * the kernel found room for it, so that machines can run side by side in one
+ * process.
  *
  * mmap related info: https://www.cnblogs.com/huxiao-tee/p/4660352.html
  *
+ * The whole guest address space [0, GUEST_MEMORY_SIZE) is reserved up front,
+ * with GUEST_GUARD_SIZE of guard on both sides, all PROT_NONE. The segments
+ * and the allocations of the guest are mapped over the reservation and given
+ * back to it when freed, so a guest access outside of the guest mappings
+ * faults (see trap.c) instead of reaching host memory.
+ *
  */
 
+/**
+ * @brief reserve the guest window and its guard regions
+ *
+ * @param mmu pointer to the mmu
+ */
+void mmu_init(mmu_t *mmu) {
+    // the window starts on a huge page boundary, the slack around it is given back
+    u64 size = GUEST_GUARD_SIZE + GUEST_MEMORY_SIZE + GUEST_GUARD_SIZE;
+    u8 *addr = mmap(NULL, size + HUGE_PAGE_SIZE, PROT_NONE, MAP_ANONYMOUS | MAP_PRIVATE | MAP_NORESERVE, -1, 0);
+    if (addr == MAP_FAILED) fatal("can not reserve the guest memory window");
+    u8 *start = (u8 *) ROUNDUP((u64) addr, HUGE_PAGE_SIZE);
+    if (start > addr) munmap(addr, start - addr);
+    munmap(start + size, addr + HUGE_PAGE_SIZE - start);
+    mmu->mem = (u64) start + GUEST_GUARD_SIZE;
+
+    // page zero is never handed out, a NULL guest pointer stays unmapped
+    mmu->ranges_size = 16;
+    mmu->ranges = malloc(mmu->ranges_size * sizeof(range_t));
+    if (!mmu->ranges) fatal("malloc failed.");
+    mmu->ranges[0] = (range_t) {GUEST_PAGE_SIZE, GUEST_MEMORY_SIZE};
+    mmu->nranges = 1;
+    mmu->heap_limit = mmu->mmap_base = GUEST_MMAP_BASE;
+}
+
+/**
+ * @brief release the guest window and everything mapped in it
+ *
+ * @param mmu pointer to the mmu
+ */
+void mmu_free(mmu_t *mmu) {
+    munmap((void *) (mmu->mem - GUEST_GUARD_SIZE), GUEST_GUARD_SIZE + GUEST_MEMORY_SIZE + GUEST_GUARD_SIZE);
+    free(mmu->ranges);
+    free(mmu->track_prot);
+    free(mmu->track_dirty);
+}
+
+/**
+ * @brief bind guest memory to the NUMA nodes of the memory policy
+ *
+ * The policy belongs to the host mapping, each new mapping is bound again.
+ *
+ * @param mmu  pointer to the mmu
+ * @param addr guest address, page aligned
+ * @param len  length in bytes, page aligned
+ */
+void mmu_bind(mmu_t *mmu, u64 addr, u64 len) {
+    if (!mmu->nodes) return;
+    if (syscall(__NR_mbind, TO_HOST(mmu, addr), len, MPOL_BIND, &mmu->nodes, 64, 0) < 0) {
+        fatalf("mbind: %s", strerror(errno));
+    }
+}
+
+/**
+ * @brief give guest memory back to the window reservation
+ *
+ * @param mmu  pointer to the mmu
+ * @param addr guest address, page aligned
+ * @param len  length in bytes, page aligned
+ */
+void mmu_reserve(mmu_t *mmu, u64 addr, u64 len) {
+    checkpoint_touch(mmu, addr, len);
+    if (mmap((void *) TO_HOST(mmu, addr), len, PROT_NONE,
+             MAP_ANONYMOUS | MAP_PRIVATE | MAP_NORESERVE | MAP_FIXED, -1, 0) == MAP_FAILED) {
+        fatal(strerror(errno));
+    }
+}
+
 
 /**
  * @brief Load program header
@@ -23,16 +102,11 @@
  * @param phdr pointer to program header
  * @param ehdr pointer to elf header
  * @param i    i-th program header
- * @param file file
+ * @param fd   file descriptor of the ELF, read at offsets so that jobs can share it
  */
-static void load_phdr(elf64_phdr_t *phdr, elf64_ehdr_t *ehdr, int i, FILE *file) {
-    // Advance the file pointer to the start of the i-th program header
-    if (fseek(file, ehdr->e_phoff + ehdr->e_phentsize * i, SEEK_SET) != 0) {
-        fatal("fseek failed");
-    }
-
-    // Load the program header to phdr
-    if (fread((void *) phdr, 1, sizeof(elf64_phdr_t), file) != sizeof(elf64_phdr_t)) {
+static void load_phdr(elf64_phdr_t *phdr, elf64_ehdr_t *ehdr, int i, int fd) {
+    // Load the i-th program header to phdr
+    if (pread(fd, (void *) phdr, sizeof(elf64_phdr_t), ehdr->e_phoff + ehdr->e_phentsize * i) != sizeof(elf64_phdr_t)) {
         fatal("file too small");
     }
 }
@@ -61,9 +135,12 @@ static int flags_to_mmap_prot(u32 flags) {
 static void mmu_load_segment(mmu_t *mmu, elf64_phdr_t *phdr, int fd) {
     // get the page size of the host program, usually 4096
     int page_size = getpagesize();
+    if (phdr->p_vaddr + phdr->p_memsz > GUEST_MEMORY_SIZE || phdr->p_vaddr + phdr->p_memsz < phdr->p_vaddr) {
+        fatal("segment out of the guest memory window");
+    }
     u64 offset = phdr->p_offset;
     // map the virtual address in the segment to the host memory space
-    u64 vaddr = TO_HOST(phdr->p_vaddr);
+    u64 vaddr = TO_HOST(mmu, phdr->p_vaddr);
     // address and offset in mmap function needs to be page aligned
     // align the address to the page boundary for mmap function
     u64 aligned_offset = ROUNDDOWN(offset, page_size);
@@ -101,8 +178,9 @@ static void mmu_load_segment(mmu_t *mmu, elf64_phdr_t *phdr, int fd) {
     // [     ELF      | malloc-ed spaced |] > in guest memory space
     //                ^ base             ^ alloc
     //
+    mmu_range_take(mmu, TO_GUEST(mmu, aligned_vaddr), TO_GUEST(mmu, aligned_vaddr + ROUNDUP(memsz, page_size)));
     mmu->host_alloc = MAX(mmu->host_alloc, (aligned_vaddr + ROUNDUP(memsz, page_size)));
-    mmu->base = mmu->alloc = TO_GUEST(mmu->host_alloc);
+    mmu->base = mmu->alloc = TO_GUEST(mmu, mmu->host_alloc);
 }
 
 /**
@@ -120,11 +198,8 @@ void mmu_load_elf(mmu_t *mmu, int fd) {
     // open the ELF file and load ELF header
     ///////////////////////////////////////////
 
-    // open the file with read only access and read as binary.
-    FILE *file = fdopen(fd, "rb");
-
     // read the elf header and check if the read size is good.
-    if (fread(buf, 1, sizeof(elf64_ehdr_t), file) != sizeof(elf64_ehdr_t)) {
+    if (pread(fd, buf, sizeof(elf64_ehdr_t), 0) != sizeof(elf64_ehdr_t)) {
         fatal("file too small");
     }
 
@@ -155,13 +230,20 @@ void mmu_load_elf(mmu_t *mmu, int fd) {
     // iterate over all the program header sections
     for (int i = 0; i < ehdr->e_phnum; i++) {
         // load program header from the file
-        load_phdr(&phdr, ehdr, i, file);
+        load_phdr(&phdr, ehdr, i, fd);
 
         // load the segment into mmu
         if (phdr.p_type == PT_LOAD) {
             mmu_load_segment(mmu, &phdr, fd);
         }
     }
+
+    // the heap has the room up to GUEST_MMAP_BASE, or the stack at least
+    // when the program is loaded above it
+    mmu->heap_limit = MIN(ROUNDUP(MAX(mmu->base + STACK_SIZE + HEAP_MAX_COMMIT, GUEST_MMAP_BASE), HUGE_PAGE_SIZE),
+                          GUEST_MEMORY_SIZE);
+    mmu->mmap_base = mmu->heap_limit;
+    mmu_range_take(mmu, mmu->base, mmu->heap_limit);
 }
 
 /*
@@ -180,6 +262,56 @@ stack memory map:
          ^ stack top
 */
 
+/**
+ * @brief map heap memory read write with the memory policy
+ *
+ * With --hugetlb, the memory from the first huge page boundary is mapped with
+ * huge pages, the part before it and all of it when the host has no huge
+ * pages free are small pages. Prefaulting comes after the binding and the
+ * huge page advice, so the pages are faulted in where and as they should be.
+ *
+ * @param mmu  pointer to the mmu
+ * @param addr guest address, page aligned
+ * @param len  length in bytes, a multiple of HUGE_PAGE_SIZE past the first boundary with --hugetlb
+ */
+static void mmu_commit(mmu_t *mmu, u64 addr, u64 len) {
+    checkpoint_touch(mmu, addr, len);
+    int flags = MAP_ANONYMOUS | MAP_PRIVATE | MAP_FIXED;
+    u64 huge = mmu->hugetlb ? MIN(ROUNDUP(addr, HUGE_PAGE_SIZE), addr + len) : addr + len;
+    if (huge < addr + len && mmap((void *) TO_HOST(mmu, huge), addr + len - huge, PROT_READ | PROT_WRITE,
+                                  flags | MAP_HUGETLB | (21 << MAP_HUGE_SHIFT), -1, 0) == MAP_FAILED) {
+        mmu->huge_fallbacks++;
+        huge = addr + len;
+    }
+    if (huge > addr && mmap((void *) TO_HOST(mmu, addr), huge - addr, PROT_READ | PROT_WRITE, flags, -1, 0) == MAP_FAILED) {
+        fatal("mmap failed.");
+    }
+
+    if (mmu->thp) madvise((void *) TO_HOST(mmu, addr), len, MADV_HUGEPAGE);
+    mmu_bind(mmu, addr, len);
+    if (mmu->populate && madvise((void *) TO_HOST(mmu, addr), len, MADV_POPULATE_WRITE) < 0) {
+        // kernels before 5.14, fault the pages in by hand
+        for (u64 page = addr; page < addr + len; page += GUEST_PAGE_SIZE) *(volatile u8 *) TO_HOST(mmu, page) = 0;
+    }
+}
+
+/*
+The heap is committed over the guest window reservation with room to grow as
+large as the heap already is, from HEAP_MIN_COMMIT up to HEAP_MAX_COMMIT, so a growing
+break maps host memory a logarithmic number of times. A shrinking break gives
+the memory back only once more than half of the committed heap is free, and
+keeps HEAP_MIN_COMMIT above the break: a guest malloc moving the break up and
+down around the same size makes no host call at all.
+
+The memory kept committed is not fresh, the guest expects zeroes in memory
+it gets from brk, so memory used before is cleared when allocated again.
+
+With huge pages (--thp, --hugetlb), the committed end stays on a huge page
+boundary so that the heap is made of whole huge pages.
+
+[ program ][ stack ][ heap ]|[ committed ]|[ reserved ]
+                            ^ alloc       ^ host_alloc
+*/
 u64 mmu_alloc(mmu_t *mmu, i64 sz) {
     int page_size = getpagesize();
     u64 base = mmu->alloc;
@@ -190,23 +322,321 @@ u64 mmu_alloc(mmu_t *mmu, i64 sz) {
 
     mmu->alloc += sz;
     assert(mmu->alloc >= mmu->base);
+    mmu->brks++;
 
-    // mmu->alloc is page aligned so
-    // check if we need to apply for a new page.
-    if (sz > 0 && mmu->alloc > TO_GUEST(mmu->host_alloc)) {
-        if (mmap((void*) mmu->host_alloc, ROUNDUP(sz, page_size),
-                 PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0) == MAP_FAILED) {
-            fatal("mmap failed.");
-        }
-        mmu->host_alloc += ROUNDUP(sz, page_size);
+    u64 top = ROUNDUP(mmu->alloc, page_size);
+    u64 committed = TO_GUEST(mmu, mmu->host_alloc);
+    if (top > ROUNDUP(base, page_size)) mmu->page_maps++;
+    if (top < ROUNDUP(base, page_size)) mmu->page_unmaps++;
+
+    if (sz > 0 && mmu->alloc > committed) {
+        if (top > mmu->heap_limit) fatal("out of guest memory");
+        u64 chunk = MIN(MAX(top - mmu->base, HEAP_MIN_COMMIT), HEAP_MAX_COMMIT);
+        u64 end = MIN(top + chunk, mmu->heap_limit);
+        if (mmu->thp || mmu->hugetlb) end = MIN(ROUNDUP(end, HUGE_PAGE_SIZE), mmu->heap_limit);
+        mmu_commit(mmu, committed, end - committed);
+        mmu->host_alloc = mmu->mem + end;     // end may be the end of the window
+        mmu->maps++;
     }
-    else if (sz < 0 && ROUNDUP(mmu->alloc, page_size) < TO_GUEST(mmu->host_alloc)) {
-        u64 len = TO_GUEST(mmu->host_alloc) - ROUNDUP(mmu->alloc, page_size);
-        if (munmap((void *) ROUNDUP(mmu->alloc, page_size), len) == -1) {
-            fatal(strerror(errno));
+    else if (sz < 0 && committed - top > MAX(HEAP_MIN_COMMIT, (committed - mmu->base) / 2)) {
+        u64 end = top + HEAP_MIN_COMMIT;
+        if (mmu->thp || mmu->hugetlb) end = ROUNDUP(end, HUGE_PAGE_SIZE);
+        if (end < committed) {
+            mmu_reserve(mmu, end, committed - end);
+            mmu->host_alloc = mmu->mem + end;
+            mmu->dirty = MIN(mmu->dirty, end);
+            mmu->unmaps++;
         }
-        mmu->host_alloc -= len;
     }
 
+    if (sz > 0 && base < mmu->dirty) memset((void *) TO_HOST(mmu, base), 0, MIN(mmu->alloc, mmu->dirty) - base);
+    mmu->dirty = MAX(mmu->dirty, mmu->alloc);
     return base;
 }
+
+/**
+ * Guest mappings
+ *
+ * The ranges of the guest window that are neither loaded from the ELF, nor
+ * the heap (up to heap_limit), nor mapped by the guest are kept in
+ * mmu->ranges. Guest mmap takes the highest free range large enough, top
+ * down from the end of the window like Linux, and munmap gives the range
+ * back, merged with its free neighbours.
+ *
+ * Only the part of the window above mmap_base, where the heap ended when the
+ * program was loaded, goes back to the free ranges: the program, the stack
+ * and the heap the guest unmaps stay unmapped, without being handed out to
+ * mmap again or growing the heap over them.
+ */
+
+// index of the first free range ending after addr (at addr when adjacent is set)
+static u64 mmu_range_index(mmu_t *mmu, u64 addr, bool adjacent) {
+    u64 i = 0;
+    while (i < mmu->nranges && (mmu->ranges[i].end < addr || (!adjacent && mmu->ranges[i].end == addr))) i++;
+    return i;
+}
+
+// replace the free ranges [i, j) with the n ranges of with
+static void mmu_range_replace(mmu_t *mmu, u64 i, u64 j, range_t *with, u64 n) {
+    if (mmu->nranges - (j - i) + n > mmu->ranges_size) {
+        mmu->ranges_size *= 2;
+        mmu->ranges = realloc(mmu->ranges, mmu->ranges_size * sizeof(range_t));
+        if (!mmu->ranges) fatal("realloc failed.");
+    }
+    memmove(&mmu->ranges[i + n], &mmu->ranges[j], (mmu->nranges - j) * sizeof(range_t));
+    memcpy(&mmu->ranges[i], with, n * sizeof(range_t));
+    mmu->nranges = mmu->nranges - (j - i) + n;
+}
+
+/**
+ * @brief find room for a guest mapping
+ *
+ * @param mmu pointer to the mmu
+ * @param len length in bytes, page aligned
+ * @return u64 the highest free guest address of len bytes, 0 if there is none
+ */
+u64 mmu_range_find(mmu_t *mmu, u64 len) {
+    for (u64 i = mmu->nranges; i > 0; i--) {
+        range_t *range = &mmu->ranges[i - 1];
+        if (range->end - range->start >= len) return range->end - len;
+    }
+    return 0;
+}
+
+/**
+ * @brief is the whole range free
+ *
+ * @param mmu   pointer to the mmu
+ * @param start first guest address
+ * @param end   guest address after the range
+ */
+bool mmu_range_free(mmu_t *mmu, u64 start, u64 end) {
+    u64 i = mmu_range_index(mmu, start, false);
+    return i < mmu->nranges && mmu->ranges[i].start <= start && end <= mmu->ranges[i].end;
+}
+
+/**
+ * @brief is the whole range used, by the program, the heap or guest mappings
+ *
+ * @param mmu   pointer to the mmu
+ * @param start first guest address
+ * @param end   guest address after the range
+ */
+bool mmu_range_used(mmu_t *mmu, u64 start, u64 end) {
+    u64 i = mmu_range_index(mmu, start, false);
+    return i == mmu->nranges || mmu->ranges[i].start >= end;
+}
+
+/**
+ * @brief mark a range as used, parts of it may be used already
+ *
+ * @param mmu   pointer to the mmu
+ * @param start first guest address
+ * @param end   guest address after the range
+ */
+void mmu_range_take(mmu_t *mmu, u64 start, u64 end) {
+    u64 i = mmu_range_index(mmu, start, false), j = i;
+    while (j < mmu->nranges && mmu->ranges[j].start < end) j++;
+    if (i == j) return;
+
+    // the free ends of the first and the last overlapping ranges stay
+    range_t left[2];
+    u64 n = 0;
+    if (mmu->ranges[i].start < start) left[n++] = (range_t) {mmu->ranges[i].start, start};
+    if (mmu->ranges[j - 1].end > end) left[n++] = (range_t) {end, mmu->ranges[j - 1].end};
+    mmu_range_replace(mmu, i, j, left, n);
+}
+
+/**
+ * @brief give back a range the guest unmapped, parts of it may be free already
+ *
+ * The heap ends at the first page unmapped in it, brk does not grow over the
+ * hole. Only the part above mmap_base becomes free.
+ *
+ * @param mmu   pointer to the mmu
+ * @param start first guest address
+ * @param end   guest address after the range
+ */
+void mmu_range_give(mmu_t *mmu, u64 start, u64 end) {
+    if (start < mmu->heap_limit && end > mmu->heap) mmu->heap_limit = MAX(start, mmu->heap);
+
+    start = MAX(start, mmu->mmap_base);
+    if (start >= end) return;
+
+    // merge with the free ranges overlapping or adjacent to it
+    u64 i = mmu_range_index(mmu, start, true), j = i;
+    while (j < mmu->nranges && mmu->ranges[j].start <= end) j++;
+    range_t merged = {start, end};
+    if (i < j) {
+        merged.start = MIN(start, mmu->ranges[i].start);
+        merged.end = MAX(end, mmu->ranges[j - 1].end);
+    }
+    mmu_range_replace(mmu, i, j, &merged, 1);
+}
+
+/**
+ * Sv39 virtual memory
+ *
+ * With satp in Sv39 mode, the guest addresses of the S and U modes are
+ * virtual: the guest window holds the physical memory and the page tables.
+ * Translations are cached in three direct mapped software TLBs, for fetches,
+ * loads and stores, so a hit is one compare away from the host address (see
+ * mmu_host). Entries are tagged with tlb_key, the ASID and the privilege they
+ * were checked for, so address space switches do not flush them. A store TLB
+ * entry is only filled for a writable page whose dirty bit is set.
+ */
+
+// page table entry bits
+#define PTE_V   (1 << 0)
+#define PTE_R   (1 << 1)
+#define PTE_W   (1 << 2)
+#define PTE_X   (1 << 3)
+#define PTE_U   (1 << 4)
+#define PTE_A   (1 << 6)
+#define PTE_D   (1 << 7)
+#define PTE_PPN(pte)    (((pte) >> 10) & 0xFFFFFFFFFFFULL)
+
+// tlb_key of an entry that was filled, empty entries have a zero key
+#define TLB_KEY_VALID   (1ULL << 63)
+
+static const enum exception_type_t page_faults[num_access_types] = {
+    [access_fetch] = instruction_page_fault,
+    [access_load]  = load_page_fault,
+    [access_store] = store_page_fault,
+};
+
+static const enum exception_type_t access_faults[num_access_types] = {
+    [access_fetch] = instruction_access_fault,
+    [access_load]  = load_access_fault,
+    [access_store] = store_access_fault,
+};
+
+/**
+ * @brief recompute the translation state after a change of satp, mstatus or the privilege
+ *
+ * @param state CPU state
+ */
+void mmu_update(state_t *state) {
+    u64 satp = csr_read(state, satp_id);
+    u64 mstatus = csr_read(state, mstatus_id);
+
+    state->translate = csr_get(satp, mode, satp) == satp_mode_sv39 && state->priv != priv_m;
+    // everything the permission checks of a walk depend on
+    state->tlb_key = TLB_KEY_VALID | csr_get(satp, asid, satp) | (u64) state->priv << 16 |
+                     (mstatus & (mstatus_sum_mask | mstatus_mxr_mask));
+}
+
+/**
+ * @brief walk the page table of a virtual address and fill the TLB
+ *
+ * @param state  CPU state
+ * @param addr   guest virtual address
+ * @param access kind of access
+ * @return u64   guest physical address, faults do not return
+ */
+static u64 mmu_walk(state_t *state, u64 addr, enum access_type_t access) {
+    // bits 63-39 must all equal bit 38
+    if ((u64) ((i64) (addr << 25) >> 25) != addr) trap_throw(page_faults[access], addr);
+
+    u64 satp = csr_read(state, satp_id);
+    u64 mstatus = csr_read(state, mstatus_id);
+    u64 table = csr_get(satp, ppn, satp) << 12;
+
+    for (int level = 2; level >= 0; level--) {
+        u64 pte_addr = table + ((addr >> (12 + 9 * level)) & 0x1FF) * sizeof(u64);
+        if (pte_addr >= GUEST_MEMORY_SIZE) trap_throw(access_faults[access], addr);
+        u64 *pte = (u64 *) TO_HOST(state, pte_addr);
+
+        if (!(*pte & PTE_V) || (!(*pte & PTE_R) && (*pte & PTE_W))) break;
+
+        // pointer to the next level
+        if (!(*pte & (PTE_R | PTE_X))) {
+            table = PTE_PPN(*pte) << 12;
+            continue;
+        }
+
+        // leaf, U pages are for U mode, and for S mode loads and stores with SUM
+        if (state->priv == priv_u ? !(*pte & PTE_U) :
+            (*pte & PTE_U) && (access == access_fetch || !(mstatus & mstatus_sum_mask))) break;
+        if (access == access_fetch && !(*pte & PTE_X)) break;
+        if (access == access_load && !(*pte & PTE_R) && !((mstatus & mstatus_mxr_mask) && (*pte & PTE_X))) break;
+        if (access == access_store && !(*pte & PTE_W)) break;
+
+        // superpages must be aligned
+        u64 level_mask = (1ULL << (9 * level)) - 1;
+        if (PTE_PPN(*pte) & level_mask) break;
+
+        u64 ppn = PTE_PPN(*pte) | ((addr >> 12) & level_mask);
+        if ((ppn << 12) >= GUEST_MEMORY_SIZE) trap_throw(access_faults[access], addr);
+
+        // accessed and dirty bits are updated by the walk
+        *pte |= PTE_A | (access == access_store ? PTE_D : 0);
+
+        tlb_entry_t *entry = &state->tlb.entries[access][(addr >> 12) & (TLB_SIZE - 1)];
+        entry->page = ROUNDDOWN(addr, GUEST_PAGE_SIZE);
+        entry->key = state->tlb_key;
+        entry->addend = TO_HOST(state, ppn << 12) - entry->page;
+        return (ppn << 12) | (addr & (GUEST_PAGE_SIZE - 1));
+    }
+    trap_throw(page_faults[access], addr);
+}
+
+/**
+ * @brief translate a guest access which missed the TLB
+ *
+ * Misaligned accesses always come here, they are translated through the TLB
+ * entry of their page. An access crossing two pages which are not contiguous
+ * in the physical memory raises a misaligned exception.
+ *
+ * @param state  CPU state
+ * @param addr   guest virtual address
+ * @param size   size of the access
+ * @param access kind of access
+ * @return u64   host address, faults do not return
+ */
+u64 mmu_translate(state_t *state, u64 addr, u64 size, enum access_type_t access) {
+    u64 paddr;
+    tlb_entry_t *entry = &state->tlb.entries[access][(addr >> 12) & (TLB_SIZE - 1)];
+    if (ROUNDDOWN(addr, GUEST_PAGE_SIZE) == entry->page && entry->key == state->tlb_key) {
+        state->tlb.hits++;
+        paddr = TO_GUEST(state, addr + entry->addend);
+    } else {
+        state->tlb.misses++;
+        paddr = mmu_walk(state, addr, access);
+    }
+
+    u64 last = addr + size - 1;
+    if (ROUNDDOWN(last, GUEST_PAGE_SIZE) != ROUNDDOWN(addr, GUEST_PAGE_SIZE)) {
+        u64 next = TO_GUEST(state, mmu_host(state, ROUNDDOWN(last, GUEST_PAGE_SIZE), 1, access));
+        if (next != ROUNDDOWN(paddr, GUEST_PAGE_SIZE) + GUEST_PAGE_SIZE) {
+            trap_throw(access == access_store ? store_address_misaligned : load_address_misaligned, addr);
+        }
+    }
+    return TO_HOST(state, paddr);
+}
+
+/**
+ * @brief sfence.vma, drop the TLB entries of an address and/or an ASID
+ *
+ * Entries of global mappings are dropped as well, they are filled again by
+ * the next walk.
+ *
+ * @param state     CPU state
+ * @param addr      guest virtual address
+ * @param asid      address space
+ * @param all_addrs drop the entries of every address
+ * @param all_asids drop the entries of every address space
+ */
+void mmu_sfence(state_t *state, u64 addr, u64 asid, bool all_addrs, bool all_asids) {
+    for (int access = 0; access < num_access_types; access++) {
+        u64 first = all_addrs ? 0 : (addr >> 12) & (TLB_SIZE - 1);
+        u64 last = all_addrs ? TLB_SIZE - 1 : first;
+        for (u64 i = first; i <= last; i++) {
+            tlb_entry_t *entry = &state->tlb.entries[access][i];
+            if (!all_addrs && entry->page != ROUNDDOWN(addr, GUEST_PAGE_SIZE)) continue;
+            if (!all_asids && (entry->key & 0xFFFF) != asid) continue;
+            entry->key = 0;
+        }
+    }
+    state->tlb.flushes++;
+}
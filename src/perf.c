@@ -0,0 +1,57 @@
+#include <linux/perf_event.h>
+#include <asm/unistd.h>
+#include "rvemu.h"
+
+/**
+ * Host hardware counters
+ *
+ * Counting the cycles, instructions and cache misses of the emulator itself
+ * tells how well the hot data structures fit the host caches. Counters are
+ * user space only, so they work with perf_event_paranoid up to 2. Counters
+ * the host does not provide (virtual machines, containers) stay closed.
+ */
+
+static const struct {
+    u32 type;
+    u64 config;
+} perf_events[num_perf_counters] = {
+    [perf_cycles]       = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    [perf_instructions] = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    [perf_l1d_misses]   = {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D |
+                                               (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                               (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+    [perf_branches]     = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS},
+    [perf_branch_misses] = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+};
+
+/**
+ * @brief open and start the host counters of the calling thread
+ *
+ * @param perf pointer to the counters
+ */
+void perf_open(perf_t *perf) {
+    for (int i = 0; i < num_perf_counters; i++) {
+        struct perf_event_attr attr = {
+            .size = sizeof(attr),
+            .type = perf_events[i].type,
+            .config = perf_events[i].config,
+            .exclude_kernel = 1,
+            .exclude_hv = 1,
+        };
+        perf->fds[i] = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+}
+
+/**
+ * @brief read a host counter
+ *
+ * @param perf    pointer to the counters
+ * @param counter counter to read
+ * @param value   value of the counter
+ * @return true   the counter is available
+ * @return false  the host does not provide the counter
+ */
+bool perf_read(perf_t *perf, enum perf_counter_t counter, u64 *value) {
+    if (perf->fds[counter] < 0) return false;
+    return read(perf->fds[counter], value, sizeof(*value)) == sizeof(*value);
+}
@@ -0,0 +1,155 @@
+#include "rvemu.h"
+
+/**
+ * Syscall record and replay
+ *
+ * With --record, the result of every guest syscall and the guest memory it
+ * wrote (the data of a read, a struct stat, the contents of a file mapping)
+ * are logged to a file. With --replay, the guest runs again with its
+ * syscalls taken from the log: the files, the standard input and the host
+ * are not read, and the guest sees the same results and the same data, so
+ * two runs execute the same guest instructions whatever the host state.
+ *
+ * The syscalls managing the guest memory (brk, mmap, munmap, mremap,
+ * mprotect) and exit run again, they change the machine and not the host,
+ * and a file mapping is made anonymous and filled with the logged contents.
+ * The writes to the console are done again as well, so that the replay
+ * shows the output of the recorded run; every other write is dropped. A
+ * guest making another syscall than the logged one, or a memory syscall
+ * returning another result, diverged from the recorded run and is stopped.
+ *
+ * The log is a header and an entry per syscall (see replay_entry_t), with
+ * the bytes of guest memory written after it. A fatal error writes out the
+ * log recorded so far (see replay_abort), and an unimplemented syscall
+ * stops the replay as it stopped the record, so a failing run can be
+ * replayed up to its failure.
+ */
+
+#define REPLAY_MAGIC    0x50525652  // "RVRP"
+#define REPLAY_VERSION  1
+
+typedef struct {
+    u32 magic;
+    u32 version;
+} replay_header_t;
+
+// log recorded on this thread, NULL without --record
+static __thread replay_t *replay_recording;
+
+/**
+ * @brief open the log of --record or --replay
+ *
+ * @param m    pointer to machine
+ * @param path log file
+ * @param mode replay_record or replay_play
+ */
+void replay_init(machine_t *m, const char *path, enum replay_mode_t mode) {
+    replay_t *replay = &m->replay;
+    replay->mode = mode;
+    replay->path = path;
+    replay->log = fopen(path, mode == replay_record ? "we" : "re");
+    if (!replay->log) fatalf("%s: %s", path, strerror(errno));
+    // most entries are a few bytes, they are written and read in large blocks
+    setvbuf(replay->log, NULL, _IOFBF, 1 << 20);
+
+    replay_header_t header = {REPLAY_MAGIC, REPLAY_VERSION};
+    if (mode == replay_record) {
+        if (fwrite(&header, sizeof(header), 1, replay->log) != 1) fatalf("%s: %s", path, strerror(errno));
+        replay_recording = replay;
+        return;
+    }
+    if (fread(&header, sizeof(header), 1, replay->log) != 1 || header.magic != REPLAY_MAGIC ||
+        header.version != REPLAY_VERSION) {
+        fatalf("%s: not a syscall log of this rvemu", path);
+    }
+    replay->mem = open("/proc/self/mem", O_RDWR | O_CLOEXEC);
+    if (replay->mem < 0) fatal(strerror(errno));
+}
+
+/**
+ * @brief log a syscall run on the host
+ *
+ * @param m     pointer to machine
+ * @param entry syscall, its result and the guest memory it wrote
+ * @param data  entry->len bytes of guest memory
+ */
+void replay_log(machine_t *m, replay_entry_t *entry, void *data) {
+    replay_t *replay = &m->replay;
+    if (fwrite(entry, sizeof(*entry), 1, replay->log) != 1 ||
+        (entry->len && fwrite(data, entry->len, 1, replay->log) != 1)) {
+        fatalf("%s: %s", replay->path, strerror(errno));
+    }
+    replay->syscalls++;
+    replay->bytes += entry->len;
+}
+
+/**
+ * @brief the next logged syscall
+ *
+ * @param m     pointer to machine
+ * @param entry filled with the logged entry
+ * @return void* entry->len bytes of guest memory, valid till the next call
+ */
+void *replay_next(machine_t *m, replay_entry_t *entry) {
+    replay_t *replay = &m->replay;
+    if (fread(entry, sizeof(*entry), 1, replay->log) != 1) {
+        console_flush(&m->console);
+        fatalf("%s: the log ends before the guest does", replay->path);
+    }
+    if (entry->len > replay->size) {
+        replay->size = MAX(entry->len, replay->size * 2);
+        free(replay->data);
+        replay->data = malloc(replay->size);
+        if (!replay->data) fatal("malloc failed.");
+    }
+    if (entry->len && fread(replay->data, entry->len, 1, replay->log) != 1) fatalf("%s: truncated log", replay->path);
+    replay->syscalls++;
+    replay->bytes += entry->len;
+    return replay->data;
+}
+
+/**
+ * @brief write logged data to guest memory, read only pages included
+ *
+ * @param m    pointer to machine
+ * @param addr guest address
+ * @param data bytes to write
+ * @param len  length in bytes
+ */
+void replay_write(machine_t *m, u64 addr, void *data, u64 len) {
+    if (addr > GUEST_MEMORY_SIZE || len > GUEST_MEMORY_SIZE - addr) fatalf("%s: bad log", m->replay.path);
+    // written like a debugger does, the checkpoint tracking does not see it
+    checkpoint_touch(&m->mmu, addr, len);
+    if (pwrite(m->replay.mem, data, len, TO_HOST(&m->mmu, addr)) != (ssize_t) len) {
+        fatalf("replay write of %lu bytes at 0x%lx: %s", len, addr, strerror(errno));
+    }
+}
+
+/**
+ * @brief close the log, the recorded one is complete once it returns
+ *
+ * @param m pointer to machine
+ */
+void replay_finish(machine_t *m) {
+    replay_t *replay = &m->replay;
+    if (replay->mode == replay_off) return;
+    replay_recording = NULL;
+    if (fclose(replay->log) != 0) fatalf("%s: %s", replay->path, strerror(errno));
+    if (replay->mode == replay_play) close(replay->mem);
+    free(replay->data);
+    replay->mode = replay_off;
+}
+
+/**
+ * @brief write out the log of --record before a fatal error ends the run
+ *
+ * Called by fatal_exit, the log buffer would otherwise be lost when the
+ * error does not go through exit. Errors writing the log itself are ignored.
+ */
+void replay_abort() {
+    replay_t *replay = replay_recording;
+    if (!replay) return;
+    replay_recording = NULL;
+    fclose(replay->log);
+    replay->mode = replay_off;
+}
@@ -1,24 +1,182 @@
+#include <getopt.h>
 #include "rvemu.h"
 
+static void usage(const char *prog) {
+    fprintf(stderr, "usage: %s [options] program [args...]\n", prog);
+    fprintf(stderr, "       %s [options] --batch list [-j N]\n", prog);
+    fprintf(stderr, "       %s [options] --fork-server [--snapshot-pc addr] program [args...]\n", prog);
+    fprintf(stderr, "       %s [options] --restore file\n", prog);
+    fprintf(stderr, "options:\n");
+    fprintf(stderr, "  --jit        translate guest blocks to x86-64 code instead of interpreting them\n");
+    fprintf(stderr, "  --stats      print execution statistics when the guest exits\n");
+    fprintf(stderr, "  --no-fusion  decode fusable instruction pairs as two instructions\n");
+    fprintf(stderr, "  --io-uring   queue guest file writes and read ahead with io_uring\n");
+    fprintf(stderr, "  --unbuffered write the guest output to stdout and stderr at each guest write\n");
+    fprintf(stderr, "  --thp        back the heap and the stack with transparent huge pages\n");
+    fprintf(stderr, "  --hugetlb    back the heap and the stack with 2 MiB huge pages from the host pool\n");
+    fprintf(stderr, "  --populate   prefault the heap and the stack as they are committed\n");
+    fprintf(stderr, "  --numa-node N\n");
+    fprintf(stderr, "               bind the guest memory to the NUMA node N\n");
+    fprintf(stderr, "  --batch list run the programs listed one per line with their arguments, in parallel\n");
+    fprintf(stderr, "  -j, --jobs N host threads of --batch, one per core by default\n");
+    fprintf(stderr, "  --fork-server\n");
+    fprintf(stderr, "               run to the ready point, then fork a run from there for each request on fd %d\n", SNAPSHOT_REQUEST_FD);
+    fprintf(stderr, "  --snapshot-pc addr\n");
+    fprintf(stderr, "               ready point at a guest pc instead of the guest's snapshot ecall\n");
+    fprintf(stderr, "  --coverage   record the edge coverage, in the map of afl-fuzz under __AFL_SHM_ID\n");
+    fprintf(stderr, "  --checkpoint-every N\n");
+    fprintf(stderr, "               save the machine every N guest instructions, at the next syscall\n");
+    fprintf(stderr, "  --checkpoint-file file\n");
+    fprintf(stderr, "               file of the checkpoints, rvemu.ckpt by default\n");
+    fprintf(stderr, "  --restore file\n");
+    fprintf(stderr, "               resume the machine of the last checkpoint of a file\n");
+    fprintf(stderr, "  --record log log the results of the guest syscalls and the memory they wrote\n");
+    fprintf(stderr, "  --replay log run the guest with the syscall results of a log, without host I/O\n");
+    fprintf(stderr, "  --icount MHz\n");
+    fprintf(stderr, "               derive the guest time, its counters and its timer from the retired instructions at MHz\n");
+    exit(1);
+}
+
 int main (int argc, char **argv) {
+    machine_t machine = {0};
+    machine.cache.fuse = true;
+
+    static struct option options[] = {
+        {"jit", no_argument, NULL, 'J'},
+        {"stats", no_argument, NULL, 's'},
+        {"no-fusion", no_argument, NULL, 'f'},
+        {"io-uring", no_argument, NULL, 'u'},
+        {"unbuffered", no_argument, NULL, 'b'},
+        {"thp", no_argument, NULL, 't'},
+        {"hugetlb", no_argument, NULL, 'h'},
+        {"populate", no_argument, NULL, 'p'},
+        {"numa-node", required_argument, NULL, 'n'},
+        {"batch", required_argument, NULL, 'B'},
+        {"jobs", required_argument, NULL, 'j'},
+        {"fork-server", no_argument, NULL, 'F'},
+        {"snapshot-pc", required_argument, NULL, 'P'},
+        {"coverage", no_argument, NULL, 'C'},
+        {"checkpoint-every", required_argument, NULL, 'K'},
+        {"checkpoint-file", required_argument, NULL, 'W'},
+        {"restore", required_argument, NULL, 'R'},
+        {"record", required_argument, NULL, 'r'},
+        {"replay", required_argument, NULL, 'y'},
+        {"icount", required_argument, NULL, 'I'},
+        {NULL, 0, NULL, 0},
+    };
+
+    const char *batch = NULL;
+    int threads = sysconf(_SC_NPROCESSORS_ONLN);
+    bool uring = false;
+    bool fork_server = false;
+    u64 snapshot_pc = 0;
+    bool coverage = false;
+    u64 checkpoint_every = 0;
+    const char *checkpoint_file = NULL;
+    const char *restore = NULL;
+    const char *record = NULL;
+    const char *replay = NULL;
+
+    // stop at the first non-option so that the guest arguments are untouched
+    int opt;
+    while ((opt = getopt_long(argc, argv, "+j:", options, NULL)) != -1) {
+        switch (opt) {
+            case 'J': machine.use_jit = true; break;
+            case 's': machine.stats = true; break;
+            case 'f': machine.cache.fuse = false; break;
+            case 'u': uring = true; break;
+            case 'b': machine.console.unbuffered = true; break;
+            case 't': machine.mmu.thp = true; break;
+            case 'h': machine.mmu.hugetlb = true; break;
+            case 'p': machine.mmu.populate = true; break;
+            case 'n': {
+                char *end;
+                long node = strtol(optarg, &end, 10);
+                if (*end || node < 0 || node >= 64) usage(argv[0]);
+                machine.mmu.nodes = 1ULL << node;
+                break;
+            }
+            case 'B': batch = optarg; break;
+            case 'j': {
+                char *end;
+                threads = strtol(optarg, &end, 10);
+                if (*end || threads < 1) usage(argv[0]);
+                break;
+            }
+            case 'F': fork_server = true; break;
+            case 'C': coverage = true; break;
+            case 'P': {
+                char *end;
+                snapshot_pc = strtoull(optarg, &end, 0);
+                if (*end || !snapshot_pc) usage(argv[0]);
+                break;
+            }
+            case 'K': {
+                char *end;
+                checkpoint_every = strtoull(optarg, &end, 0);
+                if (*end || !checkpoint_every) usage(argv[0]);
+                break;
+            }
+            case 'W': checkpoint_file = optarg; break;
+            case 'R': restore = optarg; break;
+            case 'r': record = optarg; break;
+            case 'y': replay = optarg; break;
+            case 'I': {
+                char *end;
+                machine.state.mhz = strtoull(optarg, &end, 0);
+                if (*end || !machine.state.mhz) usage(argv[0]);
+                machine.jit.icount = true;
+                break;
+            }
+            default: usage(argv[0]);
+        }
+    }
+
+    if (snapshot_pc && !fork_server) usage(argv[0]);
+    // the forked runs would share the rings of the server
+    if (fork_server && (uring || batch)) usage(argv[0]);
+    if (coverage && batch) usage(argv[0]);
+    if (checkpoint_file && !checkpoint_every) usage(argv[0]);
+    // the io_uring backend keeps file positions of its own, huge pages are not protected page by page
+    if (checkpoint_every && (uring || batch || fork_server || machine.mmu.hugetlb)) usage(argv[0]);
+    if (restore && (batch || fork_server || optind != argc)) usage(argv[0]);
+    // a log covers one whole run of the guest
+    if ((record || replay) && (batch || fork_server || restore || (record && replay))) usage(argv[0]);
+
+    if (batch) {
+        if (optind != argc) usage(argv[0]);
+        return batch_run(batch, threads, &machine, uring);
+    }
+
     // check if arguments are valid.
-    if (argc < 2) {
+    if (optind >= argc && !restore) {
         fatal("No input files");
     }
 
-    machine_t machine = {0};
-    machine_load_program(&machine, argv[1]);
-    machine_setup(&machine, argc, argv);
-
-    while(true) {
-        enum exit_reason_t reason = machine_step(&machine);
-        assert(reason == ecall);
+    if (machine.use_jit) jit_init(&machine.jit);
+    if (uring) uring_init(&machine.uring);
+    if (coverage) coverage_init(&machine);
 
-        u64 syscall = machine_get_gp_reg(&machine, a7);
-        u64 ret = do_syscall(&machine, syscall);
-        machine_set_gp_reg(&machine, a0, ret);
-        machine.state.exit_reason = none; // reset the exit_reason
+    if (restore) {
+        // the guest time goes on at the rate of this run
+        u64 mhz = machine.state.mhz;
+        checkpoint_restore(&machine, restore);
+        machine.state.mhz = mhz;
+        csr_timer_update(&machine.state);
+    } else {
+        machine_load_program(&machine, argv[optind]);
+        // machine_setup expects argv[0] to be the emulator itself
+        machine_setup(&machine, argc - optind + 1, argv + optind - 1);
     }
+    if (fork_server) snapshot_init(&machine, snapshot_pc);
+    if (checkpoint_every) checkpoint_init(&machine, checkpoint_every, checkpoint_file ? checkpoint_file : "rvemu.ckpt");
+    if (record) replay_init(&machine, record, replay_record);
+    if (replay) replay_init(&machine, replay, replay_play);
 
-    return 0;
-}
\ No newline at end of file
+    int status = machine_run(&machine);
+    checkpoint_finish(&machine);
+    replay_finish(&machine);
+    if (machine.snapshot.ready) return snapshot_serve(&machine);
+    if (fork_server) fatal("the guest exited before its ready point");
+    return status;
+}
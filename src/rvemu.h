@@ -16,6 +16,8 @@
 #include <sys/mman.h>
 #include <assert.h>
 #include <stdbool.h>
+#include <time.h>
+#include <setjmp.h>
 
 #include "types.h"
 #include "elfdef.h"
@@ -28,7 +30,7 @@
 //////////////////////////////////
 
 // Error logging
-#define fatalf(fmt, ...) (fprintf(stderr, "fatal: %s:%d " fmt "\n", __FILE__, __LINE__, __VA_ARGS__), exit(1))
+#define fatalf(fmt, ...) (fprintf(stderr, "fatal: %s:%d " fmt "\n", __FILE__, __LINE__, __VA_ARGS__), fatal_exit())
 #define fatal(msg) fatalf("%s", msg)
 #define unreachable() (fatal("unreachable"), __builtin_unreachable())
 
@@ -40,28 +42,95 @@
 #define MIN(x, y)           (((x) < (y)) ? (x) : (y))
 #define MAX(x, y)           (((x) > (y)) ? (x) : (y))
 
-// Memory mapping between host and guest
-#define GUEST_MEMORY_OFFSET 0x088800000000ULL
-#define TO_GUEST(addr)  ((addr) - GUEST_MEMORY_OFFSET)
-#define TO_HOST(addr)   ((addr) + GUEST_MEMORY_OFFSET)
+// Memory mapping between host and guest, at the guest window (mem) of the
+// mmu_t or the state_t of a machine. Guest addresses are zero-extended from
+// 32 bits so no guest pointer reaches host memory outside the window, GUEST_END
+// is the end of the window.
+#define TO_GUEST(mmu, addr) ((addr) - (mmu)->mem)
+#define TO_HOST(mmu, addr)  ((u64) (u32) (addr) + (mmu)->mem)
+#define GUEST_END(mmu)      ((mmu)->mem + GUEST_MEMORY_SIZE)
+#define GUEST_MEMORY_SIZE   (4ULL << 30)    // guest addresses are below 4 GiB
+#define GUEST_GUARD_SIZE    (4ULL << 30)    // PROT_NONE on both sides of the guest window
+#define GUEST_PAGE_SIZE     4096
+#define GUEST_MMAP_BASE     (2ULL << 30)    // the heap ends here, guest mmap places mappings above
 
 #define STACK_SIZE          32 * 1024 * 1024
-#define DEBUG
+#define HEAP_MIN_COMMIT     (1ULL << 20)    // smallest chunk of heap committed or kept free
+#define HEAP_MAX_COMMIT     (64ULL << 20)   // largest chunk of heap committed at once
+#define HUGE_PAGE_SIZE      (2ULL << 20)    // huge pages of the heap with --thp and --hugetlb
+#define BLOCK_MAX_INSTS     128
+#define JUMP_CACHE_SIZE     1024    // entries of the indirect jump cache, power of 2
+#define RAS_SIZE            64      // entries of the return-address stack, power of 2
+#define CSR_PAGE_SIZE       256     // CSRs allocated together
+#define CSR_NUM_PAGES       (4096 / CSR_PAGE_SIZE)
+#define TLB_SIZE            256     // entries of each software TLB, power of 2
+#define GUEST_MAX_FDS       1024    // open files of a guest
+#define URING_ENTRIES       64      // submission queue entries of the io_uring backend
+#define URING_BUFFERS       64      // registered buffers, the first URING_RA_BUFFERS for readahead
+#define URING_RA_BUFFERS    2
+#define URING_BUFFER_SIZE   (64 * 1024)
+#define URING_BATCH         8       // writes queued before they are submitted
+#define CONSOLE_BUFFER_SIZE (64 * 1024) // guest output to stdout and stderr buffered by the emulator
+#define SNAPSHOT_REQUEST_FD 3       // fork server requests, read by the emulator
+#define SNAPSHOT_STATUS_FD  4       // fork server replies, written by the emulator
+#define SNAPSHOT_HELLO      0x52564653  // first reply of the fork server, once the guest is at its ready point
+#define COVERAGE_MAP_SIZE   (1 << 16)   // bytes of the edge coverage map, the MAP_SIZE of AFL
+#define AFL_FORKSRV_FD      198         // afl-fuzz fork server control pipe, the status pipe is the next fd
+#define CHECKPOINT_CHUNK    (64 * 1024) // guest memory unprotected and written again together by checkpoints
+#define REPLAY_CONSOLE      0x1         // flag of a logged write to the console, written again by the replay
+#define TIMEBASE_MHZ        10          // frequency of the time CSR
 
 //////////////////////////////////
 // Structs
 //////////////////////////////////
 
+/**
+ * @brief range of guest addresses [start, end)
+ *
+ */
+typedef struct {
+    u64 start;
+    u64 end;
+} range_t;
+
 /**
  * @brief Memory Management Unit
  *
  */
 typedef struct {
+    u64 mem;        // host address of the guest window, guest address 0
     u64 entry;      // starting address of the executable section of the guest program (pc entry)
                     // in guest memory space
     u64 host_alloc; // stores the upper boundary of the malloced memory space in host view
     u64 base;       // base is the guest view of host_alloc (host_alloc mapped to guest memory space)
     u64 alloc;      // alloc stores the upper boundary of the malloced memory space
+    u64 heap;       // initial program break of the guest, brk does not go below it
+    u64 heap_limit; // the program break stays below it
+    u64 mmap_base;  // guest mappings are given back above it, the program and the heap are below
+    u64 dirty;      // memory up to dirty was used before, it is cleared when allocated again
+
+    // statistics
+    u64 brks;           // changes of the program break
+    u64 maps;           // host mmap calls committing heap memory
+    u64 unmaps;         // host mmap calls giving heap memory back
+    u64 page_maps;      // the calls of a heap committed page by page
+    u64 page_unmaps;
+
+    // memory policy of the heap (and the stack in it), nodes also binds the guest mappings
+    bool thp;           // transparent huge pages
+    bool hugetlb;       // explicit 2 MiB huge pages, small pages when the host has none free
+    bool populate;      // prefault the committed memory
+    u64 nodes;          // mask of the NUMA nodes the memory is bound to, 0 for the default policy
+    u64 huge_fallbacks; // commits that found no free huge pages
+
+    // free ranges of the guest window, sorted and never adjacent
+    range_t *ranges;
+    u64 nranges;
+    u64 ranges_size;    // allocated entries
+
+    // dirty tracking of --checkpoint-every, NULL without it (see checkpoint.c)
+    u8 *track_prot;     // host protection of each guest page write protected by the tracker, 0 if it is not
+    u8 *track_dirty;    // each CHECKPOINT_CHUNK of the window written since the last checkpoint
 } mmu_t;
 
 /**
@@ -74,34 +143,91 @@ enum exit_reason_t {
     indirect_branch,
     ecall,
     mret,
+    fence_i,
+    sfence_vma,     // address translation changed
+    interrupt,      // timer interrupt due before the block at pc
 };
 
+// privilege levels
+enum priv_t {
+    priv_u = 0,
+    priv_s = 1,
+    priv_m = 3,
+};
+
+// kinds of guest memory accesses, one software TLB each
+enum access_type_t {
+    access_fetch,
+    access_load,
+    access_store,
+    num_access_types,
+};
+
+/**
+ * @brief Software TLB entry
+ *
+ * An access of size bytes at addr hits when (addr & (~0xFFF | (size - 1))) is
+ * page, misaligned accesses always miss, and key is the current tlb_key.
+ */
+typedef struct {
+    u64 page;       // guest virtual address of the page
+    u64 key;        // tlb_key the entry was filled with, zero if empty
+    u64 addend;     // host address minus guest virtual address on the page
+} tlb_entry_t;
+
+/**
+ * @brief Direct mapped, ASID tagged software TLBs of the Sv39 translation
+ *
+ */
+typedef struct {
+    tlb_entry_t entries[num_access_types][TLB_SIZE];
+    u64 hits;       // accesses translated by the TLB
+    u64 misses;     // page table walks
+    u64 flushes;    // sfence.vma executed
+} tlb_t;
+
+/**
+ * @brief CSR registers
+ *
+ * Guest programs only touch a handful of the 4096 CSRs, and rarely. They are
+ * kept in pages of CSR_PAGE_SIZE registers allocated on the first write, out
+ * of the way of the registers used by every instruction.
+ */
+typedef struct {
+    u64 *pages[CSR_NUM_PAGES];  // NULL pages read as zero
+} csr_file_t;
+
 /**
  * @brief CPU state
  *
+ * Hot fields first: the integer registers fill the first four cache lines,
+ * pc and the exit state the fifth, then the float point registers.
  */
 typedef struct {
-    enum exit_reason_t exit_reason;
     u64 gp_regs[num_gp_regs];   // RISCV 32 general purpose registers
-    u64 csr[4096];              // 4096 CSR registers
-
-    fp_reg_t fp_regs[num_fp_regs];   // RISCV 32 float point registers
 
     u64 pc;                     // Program counter
     u64 reenter_pc;             // Re-enter Program counter
-
+    enum exit_reason_t exit_reason;
     bool raise_exception;       // exception happens
     u32  exception_code;        // exception types
-} state_t;
+    u64 instret;                // retired instructions, counted at the start of a block
+    struct block_t *block;      // running block, its instructions from a fault on do not retire
+    u8 priv;                    // privilege level
+    bool translate;             // Sv39 translation of the guest addresses
+    u64 tlb_key;                // ASID and privilege of the translation, see mmu_update
+    u64 mem;                    // host address of the guest window, see TO_HOST
+    u8 *cov_map;                // edge hit counts of --coverage, NULL without it
+    u32 cov_prev;               // location of the previous block, shifted right by one
+    u64 timer;                  // instret at which the timer interrupt is taken, UINT64_MAX if never
 
-/**
- * @brief store machine status
- *
- */
-typedef struct {
-    state_t state;
-    mmu_t mmu;
-} machine_t;
+    fp_reg_t fp_regs[num_fp_regs] __attribute__((aligned(64)));   // RISCV 32 float point registers
+
+    csr_file_t csr;             // cold, CSR instructions only
+    u64 mhz;                    // guest instructions per microsecond of --icount, 0 for the host time
+    bool stimecmp_set;          // stimecmp written, mip.STIP and the timer follow it from then on
+    tlb_t tlb;                  // used with translation only
+} __attribute__((aligned(64))) state_t;
 
 /**
  * @brief RISC-V instructions
@@ -116,7 +242,15 @@ enum inst_type_t {
  *
  */
 enum exception_type_t {
-    instruction_address_misaligned = 0, // FIXME: assign to the actual exception number
+    instruction_address_misaligned = 0,
+    instruction_access_fault = 1,
+    load_address_misaligned = 4,
+    load_access_fault = 5,
+    store_address_misaligned = 6,
+    store_access_fault = 7,
+    instruction_page_fault = 12,
+    load_page_fault = 13,
+    store_page_fault = 15,
 };
 
 /**
@@ -124,37 +258,451 @@ enum exception_type_t {
  *
  */
 typedef struct {
-    i8 rd;
-    i8 rs1;
-    i8 rs2;
-    i8 rs3;
-    i32 imm;
-    i16 csr;
-    enum inst_type_t type;
-    bool rvc;
-    bool cont;
+    i32 imm;            // immediate, CSR number for Zicsr instructions
+    u32 type : 8;       // enum inst_type_t
+    u32 rd : 5;
+    u32 rs1 : 5;        // also the zimm of Zicsr instructions
+    u32 rs2 : 5;
+    u32 rs3 : 5;
+    u32 rvc : 1;
+    u32 cont : 1;       // instruction ends a basic block
+    u32 fused : 1;      // pair of 4 bytes instructions executed as one
 } inst_t;
 
+_Static_assert(sizeof(inst_t) == 8, "decoded instructions are 8 bytes");
+_Static_assert(num_insts <= 256, "instruction types must fit in inst_t.type");
+
+// size of the guest code of a decoded instruction
+#define INST_LEN(inst)      ((inst)->fused ? 8 : (inst)->rvc ? 2 : 4)
+
+// fused instructions with two immediates keep a 12 bits one in the low bits of imm
+#define FUSED_IMM(hi, lo)   ((i32) (((u32) (hi) << 12) | ((lo) & 0xFFF)))
+#define FUSED_HI(imm)       ((imm) >> 12)
+#define FUSED_LO(imm)       ((i32) ((u32) (imm) << 20) >> 20)
+
+typedef struct block_t block_t;
+
+/**
+ * @brief Link from a block exit to its statically known successor
+ *
+ */
+typedef struct {
+    bool valid;         // the exit has a statically known successor
+    u64 pc;             // guest pc of the successor
+    block_t *block;     // successor block, NULL if not linked yet
+    u8 *patch;          // JIT exit stub to be patched into a jump to the successor
+} link_t;
+
+// block exits with a static successor
+enum link_type_t {
+    link_taken,         // target of a branch or a direct jump
+    link_next,          // fall through to the instruction following the block
+    link_return,        // return address of a call, reached by the matching return
+    num_links,
+};
+
+// how the last instruction of a block transfers control
+enum jump_type_t {
+    jump_static,        // successors are statically known, or the block ends with a system instruction
+    jump_indirect,      // jalr, c.jr and c.jalr
+    jump_return,        // indirect jump through ra
+};
+
+/**
+ * @brief Decoded basic block
+ *
+ * A run of decoded instructions starting at pc and ending with (and including)
+ * the first control flow instruction, after BLOCK_MAX_INSTS instructions, or
+ * at the end of the guest page of pc.
+ */
+struct block_t {
+    u64 pc;             // guest pc of the first instruction
+    u32 len;            // number of decoded instructions
+    u32 icount;         // number of guest instructions, a fused pair counts as two
+    void *code;         // JIT compiled code, NULL if not compiled yet
+    enum jump_type_t jump;
+    bool call;          // block ends with a jump writing ra, links[link_return] is the return address
+    bool translate;     // decoded with Sv39 translation, the JIT keeps its memory accesses in the interpreter
+    link_t links[num_links];
+    inst_t insts[];     // decoded instructions
+};
+
+/**
+ * @brief Block cache: open addressing hash table of decoded blocks keyed by guest pc
+ *
+ */
+typedef struct {
+    block_t **table;    // hash table, size is a power of 2
+    u64 size;           // number of slots in the table
+    u64 count;          // number of blocks stored in the table
+    bool fuse;          // fuse common instruction pairs when decoding
+    bool translate;     // blocks are decoded from Sv39 virtual addresses of privilege priv
+    u8 priv;
+    u64 fused;          // fused pairs decoded
+    u64 hits;           // lookups that found a decoded block
+    u64 misses;         // lookups that had to decode a new block
+    u64 chained;        // block transitions following a link, jump cache and return stack included
+    u64 unchained;      // block transitions going through a lookup
+    link_t jump_cache[JUMP_CACHE_SIZE]; // targets of indirect jumps, direct mapped by guest pc
+    link_t *ras[RAS_SIZE];              // shadow return-address stack, the oldest entries are overwritten
+    u64 ras_top;        // number of pushes minus pops
+    u64 ras_count;      // number of valid entries on the stack
+    u64 jump_hits;      // indirect jumps resolved by the jump cache
+    u64 jump_misses;
+    u64 ras_hits;       // returns predicted by the return-address stack
+    u64 ras_misses;
+    u64 code_start;     // guest pcs of the decoded blocks are in [code_start, code_end)
+    u64 code_end;
+} cache_t;
+
+/**
+ * @brief Native guest memory access of the JIT code, found back by the fault handler
+ *
+ */
+typedef struct {
+    u64 offset;         // offset of the access instruction in the code buffer
+    u64 pc;             // guest pc of the access
+} jit_access_t;
+
+/**
+ * @brief JIT code buffer
+ *
+ */
+typedef struct {
+    u8 *code;           // executable code buffer
+    u64 size;           // size of the code buffer
+    u64 used;           // bytes used in the code buffer
+    u64 blocks;         // number of compiled blocks
+    u64 templates;      // instructions translated to native code
+    u64 fallbacks;      // instructions calling back into the interpreter
+    u64 chained;        // jumps between compiled blocks through patched exits
+    bool coverage;      // compiled blocks record their edges in the coverage map
+    bool icount;        // compiled blocks check the timer of --icount
+    jit_access_t *accesses; // native guest memory accesses in code order
+    u64 num_accesses;
+    u64 max_accesses;
+} jit_t;
+
+// host hardware counters
+enum perf_counter_t {
+    perf_cycles,
+    perf_instructions,
+    perf_l1d_misses,    // L1 data cache read misses
+    perf_branches,
+    perf_branch_misses,
+    num_perf_counters,
+};
+
+typedef struct {
+    int fds[num_perf_counters]; // -1 if the host does not provide the counter
+} perf_t;
+
+/**
+ * @brief guest fd handled by the io_uring backend
+ *
+ */
+typedef struct {
+    int host_fd;
+    i8 kind;            // 1 regular file opened by the guest, -1 other fd, 0 not checked yet
+    bool tracked;       // pos is the file position, the one of host_fd is stale
+    u64 pos;
+    u32 inflight;       // writes queued or submitted, not completed
+    u64 lo, hi;         // file range of the writes in flight
+    int error;          // errno of a write that failed after the guest was told it succeeded
+} uring_file_t;
+
+// readahead buffer
+typedef struct {
+    bool valid;         // len bytes at start were read
+    bool pending;       // a read of the buffer is in flight
+    u64 start;          // file offset of the buffer
+    u64 len;            // bytes read, less than the buffer size at the end of the file
+} uring_ra_t;
+
+/**
+ * @brief io_uring backend of the guest file I/O
+ *
+ */
+typedef struct {
+    bool enabled;
+    int fd;             // ring
+    u32 *sq_head, *sq_tail, *sq_array;
+    u32 sq_mask;
+    void *sqes;
+    u32 *cq_head, *cq_tail;
+    u32 cq_mask;
+    void *cqes;
+    u32 queued;         // requests in the submission queue, not submitted yet
+    u32 inflight;       // requests not completed
+    bool fixed;         // buffers are registered with the ring
+    u8 *buffers;        // URING_BUFFERS buffers of URING_BUFFER_SIZE bytes
+    void *sq_ring, *cq_ring;            // ring mappings, the same one on recent kernels
+    u64 sq_size, cq_size, sqes_size;
+    u32 free[URING_BUFFERS];
+    u32 num_free;
+    struct {
+        i32 slot;       // guest fd
+        u32 len;        // bytes of the write
+    } owner[URING_BUFFERS];
+    void *last;         // sqe of the last queued write, NULL once submitted
+    i32 ra_slot;        // guest fd read ahead, -1 if none
+    uring_ra_t ra[URING_RA_BUFFERS];
+    uring_file_t files[GUEST_MAX_FDS];
+    u32 num_tracked;    // files whose position is kept by the backend
+    u64 writes;         // guest writes queued
+    u64 merged;         // guest writes appended to the previous queued one
+    u64 reads;          // guest reads
+    u64 ra_hits;        // guest reads served from the readahead buffers
+    u64 waits;          // waits for completions
+} uring_t;
+
+/**
+ * @brief buffered guest output to the standard streams of the emulator
+ *
+ */
+typedef struct {
+    bool unbuffered;    // every guest write is a host write, set by --unbuffered
+    u8 *buf;            // CONSOLE_BUFFER_SIZE bytes, NULL when unbuffered
+    u64 len;            // bytes buffered
+    int fd;             // stream of the buffered bytes, STDOUT_FILENO or STDERR_FILENO
+    int out[STDERR_FILENO + 1];     // host fd written for each stream, the same fd unless redirected
+    bool tty[STDERR_FILENO + 1];    // the stream is a terminal, flushed at each newline
+    u64 writes;         // guest writes
+    u64 host_writes;    // host writes
+} console_t;
+
+/**
+ * @brief ready point of the fork server
+ *
+ */
+typedef struct {
+    bool armed;         // --fork-server, the guest has not reached its ready point yet
+    bool afl;           // the fork server answers afl-fuzz on AFL_FORKSRV_FD
+    bool ready;         // the guest is at its ready point, machine_run returns
+    u64 pc;             // guest pc of the ecall planted by --snapshot-pc, 0 once it is reached
+    u32 inst;           // instruction the ecall replaced
+    u64 runs;           // runs forked from the ready point
+} snapshot_t;
+
+// --record and --replay
+enum replay_mode_t {
+    replay_off,
+    replay_record,      // log the syscalls run on the host
+    replay_play,        // take the syscalls from the log
+};
+
+/**
+ * @brief logged syscall, followed by len bytes of guest memory written at addr
+ *
+ */
+typedef struct {
+    u16 n;              // syscall number
+    u16 flags;          // REPLAY_CONSOLE
+    u32 len;
+    u64 ret;            // result returned to the guest
+    u64 addr;
+} replay_entry_t;
+
+/**
+ * @brief syscall log of --record and --replay
+ *
+ */
+typedef struct {
+    enum replay_mode_t mode;
+    FILE *log;
+    const char *path;
+    int mem;            // /proc/self/mem, the replay writes guest memory of any protection through it
+    u8 *data;           // guest memory of the entry replayed
+    u64 size;           // allocated bytes of data
+    u64 syscalls;       // syscalls logged or replayed
+    u64 bytes;          // bytes of guest memory logged or replayed
+} replay_t;
+
+typedef struct checkpoint_writer_t checkpoint_writer_t;
+
+/**
+ * @brief periodic checkpoints of --checkpoint-every
+ *
+ */
+typedef struct {
+    u64 every;          // guest instructions between checkpoints, 0 without checkpoints
+    u64 next;           // instret of the next checkpoint, taken at the first syscall from there
+    const char *path;   // checkpoint file
+    checkpoint_writer_t *writer;    // background thread writing the records
+    u64 taken;          // checkpoints taken, the first one is full
+    u64 pages;          // guest pages written
+    u64 bytes;          // bytes written
+    f64 pause;          // seconds the guest was stopped for them
+} checkpoint_t;
+
+/**
+ * @brief store machine status
+ *
+ */
+typedef struct {
+    state_t state;
+    mmu_t mmu;
+    cache_t cache;
+    jit_t jit;
+    bool use_jit;       // execute blocks with the JIT instead of the interpreter
+    bool stats;         // print statistics when the guest exits
+    perf_t perf;        // host counters, opened with stats
+    struct timespec start;  // host time when the guest started
+    sigjmp_buf trap_jmp;    // machine_step resumes here after a guest access fault
+    u64 fault_addr;         // guest address of the faulting access
+    i64 fault_code;         // exception raised by trap_throw, -1 for a host fault
+    bool fetching;          // decoding guest code, faults are instruction access faults
+    int fds[GUEST_MAX_FDS]; // host fd of each guest fd, -1 if closed
+    uring_t uring;          // asynchronous file I/O, enabled by --io-uring
+    console_t console;      // guest output to stdout and stderr
+    bool exited;            // the guest called exit
+    int exit_code;          // status passed to exit
+    snapshot_t snapshot;    // ready point of --fork-server
+    checkpoint_t checkpoint;    // --checkpoint-every
+    replay_t replay;            // --record and --replay
+} machine_t;
+
+
+// instruction handler
+typedef void (func_t)(state_t *, inst_t *);
+
+// JIT compiled block, returns the block whose exit was taken
+typedef block_t *(jit_func_t)(state_t *);
 
 //////////////////////////////////
 // Function prototype
 //////////////////////////////////
 
+void mmu_init(mmu_t *);
 void mmu_load_elf(mmu_t *, int);
+void mmu_update(state_t *state);
+u64 mmu_translate(state_t *state, u64 addr, u64 size, enum access_type_t access);
+void mmu_sfence(state_t *state, u64 addr, u64 asid, bool all_addrs, bool all_asids);
 void machine_load_program(machine_t *, char *);
+void machine_load_elf(machine_t *m, int fd);
+int machine_run(machine_t *m);
+void machine_free(machine_t *m);
+void mmu_free(mmu_t *mmu);
+void cache_free(cache_t *cache);
 void inst_decode(inst_t *inst, u32 data);
-void exec_block_interp(state_t *state);
+u64 csr_read(state_t *state, u16 csr);
+void csr_write(state_t *state, u16 csr, u64 value);
+u64 csr_time(state_t *state);
+void csr_timer_update(state_t *state);
+bool inst_fuse(inst_t *first, inst_t *second);
+void exec_block_interp(state_t *state, block_t *block);
 enum exit_reason_t machine_step(machine_t *m);
+void machine_print_stats(machine_t *m);
+void machine_flush(machine_t *m);
+block_t *cache_lookup(cache_t *cache, u64 pc);
+block_t *cache_add(cache_t *cache, state_t *state, u64 pc);
+void cache_flush(cache_t *cache);
+link_t *cache_jump_lookup(cache_t *cache, u64 pc);
+void cache_ras_push(cache_t *cache, link_t *link);
+link_t *cache_ras_pop(cache_t *cache, u64 pc);
+func_t *interp_func(enum inst_type_t type);
+void jit_init(jit_t *jit);
+jit_func_t *jit_compile(jit_t *jit, block_t *block);
+void jit_flush(jit_t *jit);
+void jit_free(jit_t *jit);
+void jit_link(link_t *link, block_t *block);
+bool jit_fault_pc(jit_t *jit, u64 host, u64 *pc);
+void trap_init();
+void trap_attach(machine_t *m);
+void trap_detach();
+void trap_access_fault(machine_t *m);
+void trap_raise(state_t *state, enum exception_type_t code, u64 tval);
+void trap_interrupt(state_t *state);
+void trap_throw(enum exception_type_t code, u64 tval) __attribute__((noreturn));
+i64 trap_copy(void *dst, void *src, u64 len);
+void perf_open(perf_t *perf);
+bool perf_read(perf_t *perf, enum perf_counter_t counter, u64 *value);
 u64 mmu_alloc(mmu_t *, i64);
+void mmu_reserve(mmu_t *mmu, u64 addr, u64 len);
+void mmu_bind(mmu_t *mmu, u64 addr, u64 len);
+u64 mmu_range_find(mmu_t *mmu, u64 len);
+bool mmu_range_free(mmu_t *mmu, u64 start, u64 end);
+bool mmu_range_used(mmu_t *mmu, u64 start, u64 end);
+void mmu_range_take(mmu_t *mmu, u64 start, u64 end);
+void mmu_range_give(mmu_t *mmu, u64 start, u64 end);
 void machine_setup(machine_t *, int, char**);
+void syscall_init(machine_t *m);
+void console_init(console_t *console);
+i64 console_write(console_t *console, int fd, void *buf, u64 len);
+i64 console_flush(console_t *console);
+void uring_init(uring_t *ring);
+bool uring_accepts(uring_t *ring, int slot, int host_fd);
+i64 uring_write(uring_t *ring, int slot, void *buf, u64 len, i64 offset);
+i64 uring_read(uring_t *ring, int slot, void *buf, u64 len);
+void uring_sync(uring_t *ring);
+int uring_error(uring_t *ring, int slot);
+void uring_close(uring_t *ring, int slot);
+void uring_free(uring_t *ring);
+void fatal_exit() __attribute__((noreturn));
+int batch_run(const char *list, int threads, const machine_t *config, bool uring);
+void snapshot_init(machine_t *m, u64 pc);
+void snapshot_reached(machine_t *m);
+int snapshot_serve(machine_t *m);
+void coverage_init(machine_t *m);
+u64 coverage_edges(machine_t *m);
+void checkpoint_init(machine_t *m, u64 every, const char *path);
+void checkpoint_take(machine_t *m);
+void checkpoint_finish(machine_t *m);
+void checkpoint_restore(machine_t *m, const char *path);
+void checkpoint_touch(mmu_t *mmu, u64 addr, u64 len);
+bool checkpoint_fault(u64 host);
+void replay_init(machine_t *m, const char *path, enum replay_mode_t mode);
+void replay_log(machine_t *m, replay_entry_t *entry, void *data);
+void *replay_next(machine_t *m, replay_entry_t *entry);
+void replay_write(machine_t *m, u64 addr, void *data, u64 len);
+void replay_finish(machine_t *m);
+void replay_abort();
 u64 do_syscall(machine_t *, u64);
 
 //////////////////////////////////
 // Inline Function
 //////////////////////////////////
 
-inline void mmu_write(u64 addr, u8 *data, size_t len) {
-    memcpy((void *) TO_HOST(addr), (void *) data, len);
+/**
+ * @brief host address of a guest access, through the TLB when translation is on
+ *
+ * @param state  CPU state
+ * @param addr   guest address
+ * @param size   size of the access
+ * @param access kind of access
+ * @return u64   host address, faults do not return
+ */
+static inline u64 mmu_host(state_t *state, u64 addr, u64 size, enum access_type_t access) {
+    if (!state->translate) return TO_HOST(state, addr);
+    tlb_entry_t *entry = &state->tlb.entries[access][(addr >> 12) & (TLB_SIZE - 1)];
+    if ((addr & (~0xFFFULL | (size - 1))) == entry->page && entry->key == state->tlb_key) {
+        state->tlb.hits++;
+        return addr + entry->addend;
+    }
+    return mmu_translate(state, addr, size, access);
+}
+
+// raw instruction at a guest address, a 2 bytes instruction is not read past its end
+static inline u32 mmu_fetch(state_t *state, u64 addr) {
+    u32 raw = *(u16 *) mmu_host(state, addr, 2, access_fetch);
+    if ((raw & 0x3) == 0x3) raw |= (u32) *(u16 *) mmu_host(state, addr + 2, 2, access_fetch) << 16;
+    return raw;
+}
+
+// AFL location of a block, hashed from its pc as in the QEMU mode of AFL
+static inline u32 coverage_loc(u64 pc) {
+    return ((pc >> 4) ^ (pc << 8)) & (COVERAGE_MAP_SIZE - 1);
+}
+
+// count the edge from the previous block to the block at pc
+static inline void coverage_hit(state_t *state, u64 pc) {
+    u32 loc = coverage_loc(pc);
+    state->cov_map[loc ^ state->cov_prev]++;
+    state->cov_prev = loc >> 1;
+}
+
+inline void mmu_write(mmu_t *mmu, u64 addr, u8 *data, size_t len) {
+    memcpy((void *) TO_HOST(mmu, addr), (void *) data, len);
 }
 
 inline u64 machine_get_gp_reg(machine_t *m, i32 reg) {
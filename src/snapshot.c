@@ -0,0 +1,166 @@
+#define _GNU_SOURCE
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include "rvemu.h"
+
+/**
+ * Fork server
+ *
+ * With --fork-server the guest runs up to a ready point, after its loading,
+ * its setup and its own start-up, and the machine is frozen there. Each run
+ * asked for afterwards is a host fork of the frozen emulator: the child goes
+ * on from the ready point with a copy-on-write guest window, and with the
+ * decoded blocks and the JIT code of the parent, while the parent waits for
+ * the next request.
+ *
+ * The ready point is the guest ecall SYS_snapshot, or the guest pc given with
+ * --snapshot-pc, where an ecall is planted before the guest starts and the
+ * instruction it replaced is put back when it is reached.
+ *
+ * The server is driven over two pipes the caller passes as host fds:
+ *
+ *   SNAPSHOT_STATUS_FD   the server writes a u32 SNAPSHOT_HELLO once ready,
+ *                        then the u32 wait status of each run
+ *   SNAPSHOT_REQUEST_FD  the caller writes a u32 length and as many bytes of
+ *                        input for each run, read by the guest on its stdin
+ *
+ * The server exits when the request pipe is closed.
+ *
+ * Under afl-fuzz (see coverage.c) the server speaks the protocol of the AFL
+ * fork server instead, on AFL_FORKSRV_FD and the next fd: a hello, then for
+ * each u32 read the pid and the wait status of a run. afl-fuzz gives the
+ * input in a file, or on the stdin shared by the server and its runs.
+ */
+
+/**
+ * @brief arm the ready point of the fork server
+ *
+ * @param m  pointer to machine, loaded
+ * @param pc guest pc of the ready point, 0 for the SYS_snapshot ecall
+ */
+void snapshot_init(machine_t *m, u64 pc) {
+    m->snapshot.armed = true;
+    if (!pc) return;
+
+    // code segments are not writable, /proc/self/mem writes to them as a debugger does
+    u32 ecall = 0x73;
+    int mem = open("/proc/self/mem", O_RDWR | O_CLOEXEC);
+    if (mem < 0) fatal(strerror(errno));
+    if (pc >= GUEST_MEMORY_SIZE - sizeof(u32) ||
+        pread(mem, &m->snapshot.inst, sizeof(u32), TO_HOST(&m->mmu, pc)) != sizeof(u32) ||
+        pwrite(mem, &ecall, sizeof(u32), TO_HOST(&m->mmu, pc)) != sizeof(u32)) {
+        fatalf("cannot set the ready point at pc 0x%lx", pc);
+    }
+    close(mem);
+    m->snapshot.pc = pc;
+}
+
+/**
+ * @brief the guest reached the ecall planted at the ready point, put back the instruction it replaced
+ *
+ * @param m pointer to machine, stopped at the ready point
+ */
+void snapshot_reached(machine_t *m) {
+    int mem = open("/proc/self/mem", O_RDWR | O_CLOEXEC);
+    if (mem < 0 || pwrite(mem, &m->snapshot.inst, sizeof(u32), TO_HOST(&m->mmu, m->snapshot.pc)) != sizeof(u32)) {
+        fatal(strerror(errno));
+    }
+    close(mem);
+    machine_flush(m);
+    m->snapshot.pc = 0;
+    m->snapshot.ready = true;
+}
+
+// read exactly len bytes, false at the end of the pipe
+static bool snapshot_read(int fd, void *buf, u64 len) {
+    for (u64 done = 0; done < len;) {
+        ssize_t n = read(fd, (u8 *) buf + done, len - done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        done += n;
+    }
+    return true;
+}
+
+static void snapshot_write(int fd, u32 value) {
+    if (write(fd, &value, sizeof(value)) != sizeof(value)) fatal(strerror(errno));
+}
+
+// fork a run from the ready point, the parent returns its pid
+static pid_t snapshot_fork(machine_t *m, int input) {
+    // nothing buffered may be written twice, by the parent and by the child
+    fflush(stdout);
+    fflush(stderr);
+    pid_t pid = fork();
+    if (pid < 0) fatal(strerror(errno));
+    if (pid) return pid;
+
+    if (m->snapshot.afl) {
+        close(AFL_FORKSRV_FD);
+        close(AFL_FORKSRV_FD + 1);
+    } else {
+        close(SNAPSHOT_REQUEST_FD);
+        close(SNAPSHOT_STATUS_FD);
+        m->fds[STDIN_FILENO] = input;
+    }
+    // the edges of a run start from no block
+    m->state.cov_prev = 0;
+    _exit(machine_run(m));
+}
+
+static int snapshot_wait(pid_t pid) {
+    int status;
+    while (waitpid(pid, &status, 0) < 0) {
+        if (errno != EINTR) fatal(strerror(errno));
+    }
+    return status;
+}
+
+// the fork server of afl-fuzz
+static int snapshot_serve_afl(machine_t *m) {
+    snapshot_write(AFL_FORKSRV_FD + 1, 0);
+    u32 killed;
+    while (snapshot_read(AFL_FORKSRV_FD, &killed, sizeof(killed))) {
+        pid_t pid = snapshot_fork(m, -1);
+        snapshot_write(AFL_FORKSRV_FD + 1, pid);
+        snapshot_write(AFL_FORKSRV_FD + 1, snapshot_wait(pid));
+        m->snapshot.runs++;
+    }
+    return 0;
+}
+
+/**
+ * @brief serve runs from the machine frozen at its ready point, till the request pipe is closed
+ *
+ * @param m pointer to machine, stopped at the ready point by machine_run
+ * @return int exit status of the emulator
+ */
+int snapshot_serve(machine_t *m) {
+    m->snapshot.armed = false;
+    m->snapshot.ready = false;
+    console_flush(&m->console);
+    if (m->snapshot.afl) return snapshot_serve_afl(m);
+
+    int input = memfd_create("input", MFD_CLOEXEC);
+    if (input < 0) fatal(strerror(errno));
+    snapshot_write(SNAPSHOT_STATUS_FD, SNAPSHOT_HELLO);
+
+    u8 buf[65536];
+    u32 len;
+    while (snapshot_read(SNAPSHOT_REQUEST_FD, &len, sizeof(len))) {
+        if (ftruncate(input, 0) < 0) fatal(strerror(errno));
+        for (u32 done = 0, n; done < len; done += n) {
+            n = MIN(len - done, sizeof(buf));
+            if (!snapshot_read(SNAPSHOT_REQUEST_FD, buf, n)) fatal("truncated fork server request");
+            if (pwrite(input, buf, n, done) != n) fatal(strerror(errno));
+        }
+        lseek(input, 0, SEEK_SET);
+
+        snapshot_write(SNAPSHOT_STATUS_FD, snapshot_wait(snapshot_fork(m, input)));
+        m->snapshot.runs++;
+    }
+
+    close(input);
+    if (m->stats) fprintf(stderr, "fork server: %lu runs\n", m->snapshot.runs);
+    return 0;
+}
@@ -1,54 +1,695 @@
+#define _GNU_SOURCE
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
 #include "rvemu.h"
 
+/**
+ * Guest syscalls
+ *
+ * The file and I/O syscalls are passed through to the host. Guest buffers are
+ * handed to the host syscall as TO_HOST pointers, the data is never copied:
+ * the kernel fails with EFAULT on the pages the guest has not mapped, and a
+ * buffer must lie in the guest window. Addresses are taken untranslated, as
+ * with the proxy kernel the guest libc targets. The small argument structs
+ * read or written by the emulator itself (iovec, stat, timespec) and the
+ * paths are copied with trap_copy, so they fail with EFAULT as well.
+ *
+ * Guest fds index m->fds, which holds the host fds. The open flags and the
+ * stat layout are the ones of newlib, the guest libc.
+ *
+ * Writes to the standard output and error of the emulator go through the
+ * console buffer (see console.c). It copies the guest data with trap_copy,
+ * as do the io_uring writes, so unmapped buffers fail with EFAULT there too.
+ *
+ * Guest mmap maps the anonymous memory and the files directly over the guest
+ * window with a host MAP_FIXED mmap, in the free ranges kept by the mmu (see
+ * mmu.c), and mremap moves the host pages. Decoded blocks of the guest code
+ * unmapped, moved or mapped over are dropped.
+ *
+ * With --io-uring, reads and writes of the regular files the guest opened go
+ * through the io_uring backend (see uring.c), and every other syscall waits
+ * for the writes it has in flight.
+ *
+ * clock_gettime and gettimeofday return the host time, or with --icount the
+ * guest time counted from the epoch by its retired instructions (see
+ * csr_time), the same at each run.
+ *
+ * With --record, the results and the guest memory written by the syscalls
+ * are logged, and --replay takes them from the log (see replay.c).
+ *
+ * With --checkpoint-every, the buffers the host kernel writes to and the
+ * ranges whose mapping changes are unprotected from the dirty tracking first
+ * (see checkpoint.c).
+ */
+
 #define GET(reg, name) u64 name = machine_get_gp_reg(m, reg);
 
+// host fd of a guest fd argument, EBADF if the guest fd is not open
+#define GET_FD(reg, name) \
+    int name = sys_host_fd(m, machine_get_gp_reg(m, reg)); \
+    if (name < 0) return -EBADF;
+
+// host pointer of a guest buffer argument of len bytes, EFAULT if it leaves the guest window
+#define GET_BUF(reg, len, name) \
+    void *name = sys_buffer(m, machine_get_gp_reg(m, reg), len); \
+    if (!name) return -EFAULT;
+
+// GET_BUF of a buffer the host kernel writes to, not write protected by the checkpoint dirty tracking
+#define GET_OUT_BUF(reg, len, name) \
+    GET_BUF(reg, len, name) \
+    checkpoint_touch(&m->mmu, machine_get_gp_reg(m, reg), len);
+
+// mmap protections and flags of the guest, the Linux ones
+#define GUEST_PROT_READ             0x1
+#define GUEST_PROT_WRITE            0x2
+#define GUEST_PROT_EXEC             0x4
+#define GUEST_MAP_SHARED            0x01
+#define GUEST_MAP_PRIVATE           0x02
+#define GUEST_MAP_FIXED             0x10
+#define GUEST_MAP_ANONYMOUS         0x20
+#define GUEST_MAP_NORESERVE         0x4000
+#define GUEST_MAP_POPULATE          0x8000
+#define GUEST_MAP_FIXED_NOREPLACE   0x100000
+#define GUEST_MREMAP_MAYMOVE        0x1
+#define GUEST_MREMAP_FIXED          0x2
+
+// rvemu ecall marking the ready point of the fork server, beyond the syscalls of the proxy kernel
+#define SYS_snapshot                0x5256
+
+// AT_FDCWD and AT_SYMLINK_NOFOLLOW of newlib
+#define GUEST_AT_FDCWD              -100
+#define GUEST_AT_SYMLINK_NOFOLLOW   0x2
+
 typedef u64 (* syscall_t)(machine_t *m);
 
+// open flags of newlib, the access mode (the low two bits) is the same on the host
+static const struct {
+    u64 guest;
+    int host;
+} open_flags[] = {
+    {0x0008, O_APPEND},
+    {0x0200, O_CREAT},
+    {0x0400, O_TRUNC},
+    {0x0800, O_EXCL},
+    {0x2000, O_SYNC},
+    {0x4000, O_NONBLOCK},
+    {0x8000, O_NOCTTY},
+};
+
+// struct stat of the RV64 guest
+typedef struct {
+    u64 dev;
+    u64 ino;
+    u32 mode;
+    u32 nlink;
+    u32 uid;
+    u32 gid;
+    u64 rdev;
+    u64 pad1;
+    i64 size;
+    i32 blksize;
+    i32 pad2;
+    i64 blocks;
+    i64 atime;
+    u64 atime_nsec;
+    i64 mtime;
+    u64 mtime_nsec;
+    i64 ctime;
+    u64 ctime_nsec;
+    u32 unused4;
+    u32 unused5;
+} guest_stat_t;
+
+// struct timespec and struct timeval of the RV64 guest
+typedef struct {
+    i64 sec;
+    i64 frac;   // nanoseconds of a timespec, microseconds of a timeval
+} guest_time_t;
+
+// struct iovec of the RV64 guest
+typedef struct {
+    u64 base;
+    u64 len;
+} guest_iovec_t;
+
+/**
+ * @brief map the standard streams of the guest to the ones of the emulator
+ *
+ * @param m pointer to machine
+ */
+void syscall_init(machine_t *m) {
+    for (int fd = 0; fd < GUEST_MAX_FDS; fd++) m->fds[fd] = fd <= STDERR_FILENO ? fd : -1;
+    console_init(&m->console);
+}
+
+// host fd of a guest fd, -1 if it is not open
+static int sys_host_fd(machine_t *m, u64 fd) {
+    return fd < GUEST_MAX_FDS ? m->fds[fd] : -1;
+}
+
+// host pointer of a guest buffer, NULL if it does not fit in the guest window
+static void *sys_buffer(machine_t *m, u64 addr, u64 len) {
+    if (addr > GUEST_MEMORY_SIZE || len > GUEST_MEMORY_SIZE - addr) return NULL;
+    return (void *) TO_HOST(&m->mmu, addr);
+}
+
+// copy len bytes from the guest buffer at addr, -EFAULT if it is not mapped
+static i64 sys_copy_in(machine_t *m, void *dst, u64 addr, u64 len) {
+    void *buf = sys_buffer(m, addr, len);
+    return buf ? trap_copy(dst, buf, len) : -EFAULT;
+}
+
+// copy len bytes to the guest buffer at addr, -EFAULT if it is not mapped
+static i64 sys_copy_out(machine_t *m, u64 addr, void *src, u64 len) {
+    void *buf = sys_buffer(m, addr, len);
+    return buf ? trap_copy(buf, src, len) : -EFAULT;
+}
+
+/**
+ * @brief copy a path argument of the guest
+ *
+ * The path is read a page at a time, the guest may have mapped nothing past
+ * its end.
+ *
+ * @param m     pointer to machine
+ * @param path  host buffer
+ * @param addr  guest address of the path
+ * @return i64  0, -EFAULT if the path is not mapped, -ENAMETOOLONG if it does not end within PATH_MAX
+ */
+static i64 sys_path(machine_t *m, char path[PATH_MAX], u64 addr) {
+    for (u64 len = 0; len < PATH_MAX;) {
+        u64 chunk = MIN(GUEST_PAGE_SIZE - (addr + len) % GUEST_PAGE_SIZE, PATH_MAX - len);
+        if (sys_copy_in(m, path + len, addr + len, chunk) < 0) return -EFAULT;
+        if (memchr(path + len, 0, chunk)) return 0;
+        len += chunk;
+    }
+    return -ENAMETOOLONG;
+}
+
+// host directory fd of a guest dirfd argument, -1 if the guest fd is not open
+static int sys_host_dirfd(machine_t *m, u64 dirfd) {
+    return (i64) dirfd == GUEST_AT_FDCWD ? AT_FDCWD : sys_host_fd(m, dirfd);
+}
+
+// result of a host syscall, -errno on failure as the guest expects
+static u64 sys_ret(i64 ret) {
+    return ret < 0 ? (u64) -errno : (u64) ret;
+}
+
+// host fd of the console, stdout or stderr of the emulator
+static bool sys_console(int fd) {
+    return fd == STDOUT_FILENO || fd == STDERR_FILENO;
+}
+
 static u64 sys_unimpl(machine_t *m) {
+    console_flush(&m->console);
     fatalf("unimplemented syscall: %ld", machine_get_gp_reg(m, a7));
 }
 
+// the machine stops, machine_run returns the status
 static u64 sys_exit(machine_t *m) {
     GET(a0, status);
-    exit(status);
+    console_flush(&m->console);
+    if (m->stats) machine_print_stats(m);
+    m->exited = true;
+    m->exit_code = status;
+    return 0;
+}
+
+static u64 sys_read(machine_t *m) {
+    GET(a0, slot);
+    GET_FD(a0, fd);
+    GET(a2, count);
+    GET_OUT_BUF(a1, count, buf);
+    if (uring_accepts(&m->uring, slot, fd)) return uring_read(&m->uring, slot, buf, count);
+    // prompts are out before the guest waits for its input
+    if (fd == STDIN_FILENO) console_flush(&m->console);
+    return sys_ret(read(fd, buf, count));
+}
+
+static u64 sys_write(machine_t *m) {
+    GET(a0, slot);
+    GET_FD(a0, fd);
+    GET(a2, count);
+    GET_BUF(a1, count, buf);
+    if (sys_console(fd)) return console_write(&m->console, fd, buf, count);
+    if (uring_accepts(&m->uring, slot, fd)) return uring_write(&m->uring, slot, buf, count, -1);
+    return sys_ret(write(fd, buf, count));
+}
+
+static u64 sys_pread(machine_t *m) {
+    GET_FD(a0, fd);
+    GET(a2, count);
+    GET(a3, offset);
+    GET_OUT_BUF(a1, count, buf);
+    return sys_ret(pread(fd, buf, count, offset));
+}
+
+static u64 sys_pwrite(machine_t *m) {
+    GET(a0, slot);
+    GET_FD(a0, fd);
+    GET(a2, count);
+    GET(a3, offset);
+    GET_BUF(a1, count, buf);
+    if ((i64) offset < 0) return -EINVAL;
+    if (uring_accepts(&m->uring, slot, fd)) return uring_write(&m->uring, slot, buf, count, offset);
+    return sys_ret(pwrite(fd, buf, count, offset));
+}
+
+static u64 sys_writev(machine_t *m) {
+    GET_FD(a0, fd);
+    GET(a2, iovcnt);
+    if (iovcnt > IOV_MAX) return -EINVAL;
+    guest_iovec_t guest_iov[IOV_MAX];
+    if (sys_copy_in(m, guest_iov, machine_get_gp_reg(m, a1), iovcnt * sizeof(guest_iovec_t)) < 0) return -EFAULT;
+
+    // only the descriptors are converted, the data stays in the guest buffers
+    struct iovec iov[IOV_MAX];
+    for (u64 i = 0; i < iovcnt; i++) {
+        guest_iovec_t *v = &guest_iov[i];
+        iov[i].iov_base = sys_buffer(m, v->base, v->len);
+        iov[i].iov_len = v->len;
+        if (!iov[i].iov_base) return -EFAULT;
+    }
+    if (!sys_console(fd)) return sys_ret(writev(fd, iov, iovcnt));
+
+    u64 done = 0;
+    for (u64 i = 0; i < iovcnt; i++) {
+        i64 n = console_write(&m->console, fd, iov[i].iov_base, iov[i].iov_len);
+        if (n < 0) return done ? done : (u64) n;
+        done += n;
+    }
+    return done;
+}
+
+static u64 sys_openat(machine_t *m) {
+    GET(a0, dirfd);
+    GET(a1, path);
+    GET(a2, flags);
+    GET(a3, mode);
+    int host_dirfd = sys_host_dirfd(m, dirfd);
+    if (host_dirfd == -1) return -EBADF;
+    char host_path[PATH_MAX];
+    i64 error = sys_path(m, host_path, path);
+    if (error < 0) return error;
+
+    int fd = 0;
+    while (fd < GUEST_MAX_FDS && m->fds[fd] >= 0) fd++;
+    if (fd == GUEST_MAX_FDS) return -EMFILE;
+
+    // host fds are not inherited by the programs the emulator may start
+    int host_flags = (flags & O_ACCMODE) | O_CLOEXEC;
+    for (u64 i = 0; i < sizeof(open_flags) / sizeof(open_flags[0]); i++) {
+        if (flags & open_flags[i].guest) host_flags |= open_flags[i].host;
+    }
+
+    int host_fd = openat(host_dirfd, host_path, host_flags, (mode_t) mode);
+    if (host_fd < 0) return -errno;
+    m->fds[fd] = host_fd;
+    return fd;
+}
+
+static u64 sys_close(machine_t *m) {
+    GET(a0, fd);
+    int host_fd = sys_host_fd(m, fd);
+    if (host_fd < 0) return -EBADF;
+    m->fds[fd] = -1;
+    int error = uring_error(&m->uring, fd);
+    uring_close(&m->uring, fd);
+
+    // the standard streams stay open for the emulator
+    if (sys_console(host_fd)) console_flush(&m->console);
+    if (host_fd > STDERR_FILENO && close(host_fd) < 0) return -errno;
+    return error ? -error : 0;
+}
+
+static u64 sys_fsync(machine_t *m) {
+    GET(a0, slot);
+    GET_FD(a0, fd);
+    int error = uring_error(&m->uring, slot);
+    if (fsync(fd) < 0) return -errno;
+    return error ? -error : 0;
+}
+
+// like Linux, a break out of range is refused by returning the current one
+static u64 sys_brk(machine_t *m) {
+    GET(a0, addr);
+    mmu_t *mmu = &m->mmu;
+    if (addr >= mmu->heap && addr <= mmu->heap_limit && addr != mmu->alloc) mmu_alloc(mmu, addr - mmu->alloc);
+    return mmu->alloc;
 }
 
-static syscall_t syscall_table[] = {
+// host protection of a guest mapping, the guest code is fetched with host reads
+static int sys_prot(u64 prot) {
+    int host = 0;
+    if (prot & (GUEST_PROT_READ | GUEST_PROT_EXEC)) host |= PROT_READ;
+    if (prot & GUEST_PROT_WRITE) host |= PROT_WRITE;
+    return host;
+}
+
+// is [addr, addr + len) a page aligned range of the guest window
+static bool sys_range(u64 addr, u64 len) {
+    return addr % GUEST_PAGE_SIZE == 0 && len && addr <= GUEST_MEMORY_SIZE && len <= GUEST_MEMORY_SIZE - addr;
+}
+
+// drop the decoded blocks that may come from a range whose mapping changed
+static void sys_remapped(machine_t *m, u64 addr, u64 len) {
+    cache_t *cache = &m->cache;
+    if (!cache->count) return;
+    if (cache->translate || (addr < cache->code_end && addr + len > cache->code_start)) machine_flush(m);
+}
+
+static u64 sys_mmap(machine_t *m) {
+    GET(a0, addr);
+    GET(a1, len);
+    GET(a2, prot);
+    GET(a3, flags);
+    GET(a4, fd);
+    GET(a5, offset);
+    mmu_t *mmu = &m->mmu;
+    len = ROUNDUP(len, GUEST_PAGE_SIZE);
+    if (!len || len > GUEST_MEMORY_SIZE || offset % GUEST_PAGE_SIZE) return -EINVAL;
+
+    u64 type = flags & (GUEST_MAP_SHARED | GUEST_MAP_PRIVATE);
+    if (type != GUEST_MAP_SHARED && type != GUEST_MAP_PRIVATE) return -EINVAL;
+    int host_flags = MAP_FIXED | (type == GUEST_MAP_SHARED ? MAP_SHARED : MAP_PRIVATE);
+    if (flags & GUEST_MAP_NORESERVE) host_flags |= MAP_NORESERVE;
+    if (flags & GUEST_MAP_POPULATE) host_flags |= MAP_POPULATE;
+    int host_fd = -1;
+    if (flags & GUEST_MAP_ANONYMOUS) {
+        host_flags |= MAP_ANONYMOUS;
+        offset = 0;
+    } else {
+        host_fd = sys_host_fd(m, fd);
+        if (host_fd < 0) return -EBADF;
+    }
+
+    bool fixed = flags & (GUEST_MAP_FIXED | GUEST_MAP_FIXED_NOREPLACE);
+    if (fixed) {
+        if (!sys_range(addr, len)) return -EINVAL;
+        if (!(flags & GUEST_MAP_FIXED) && !mmu_range_free(mmu, addr, addr + len)) return -EEXIST;
+    } else if (!sys_range(addr, len) || !mmu_range_free(mmu, addr, addr + len)) {
+        // the hint is taken when it is free, like Linux
+        addr = mmu_range_find(mmu, len);
+        if (!addr) return -ENOMEM;
+    }
+
+    checkpoint_touch(mmu, addr, len);
+    if (mmap((void *) TO_HOST(&m->mmu, addr), len, sys_prot(prot), host_flags, host_fd, offset) == MAP_FAILED) return -errno;
+    if (flags & GUEST_MAP_ANONYMOUS) mmu_bind(mmu, addr, len);
+    mmu_range_take(mmu, addr, addr + len);
+    if (fixed) sys_remapped(m, addr, len);
+    return addr;
+}
+
+static u64 sys_munmap(machine_t *m) {
+    GET(a0, addr);
+    GET(a1, len);
+    len = ROUNDUP(len, GUEST_PAGE_SIZE);
+    if (!sys_range(addr, len)) return -EINVAL;
+
+    mmu_reserve(&m->mmu, addr, len);
+    mmu_range_give(&m->mmu, addr, addr + len);
+    sys_remapped(m, addr, len);
+    return 0;
+}
+
+static u64 sys_mprotect(machine_t *m) {
+    GET(a0, addr);
+    GET(a1, len);
+    GET(a2, prot);
+    len = ROUNDUP(len, GUEST_PAGE_SIZE);
+    if (!sys_range(addr, len)) return -EINVAL;
+    if (!mmu_range_used(&m->mmu, addr, addr + len)) return -ENOMEM;
+
+    checkpoint_touch(&m->mmu, addr, len);
+    if (mprotect((void *) TO_HOST(&m->mmu, addr), len, sys_prot(prot)) < 0) return -errno;
+    sys_remapped(m, addr, len);
+    return 0;
+}
+
+// host protection of a range of anonymous private memory, -1 if it is anything else or mixed
+static int sys_anon_prot(u64 host, u64 len) {
+    FILE *maps = fopen("/proc/self/maps", "re");
+    if (!maps) return -1;
+
+    int prot = -1;
+    u64 covered = host;
+    char *line = NULL;
+    size_t size = 0;
+    while (covered < host + len && getline(&line, &size, maps) > 0) {
+        u64 start, end, inode;
+        char perms[5];
+        if (sscanf(line, "%lx-%lx %4s %*x %*x:%*x %lu", &start, &end, perms, &inode) != 4) continue;
+        if (end <= covered || start >= host + len) continue;
+        int vma = (perms[0] == 'r' ? PROT_READ : 0) | (perms[1] == 'w' ? PROT_WRITE : 0) |
+                  (perms[2] == 'x' ? PROT_EXEC : 0);
+        if (start > covered || inode || perms[3] != 'p' || (prot >= 0 && vma != prot)) {
+            prot = -1;
+            break;
+        }
+        prot = vma;
+        covered = end;
+    }
+    free(line);
+    fclose(maps);
+    return covered >= host + len ? prot : -1;
+}
+
+/**
+ * @brief move the host pages of a guest mapping to target, resized to new_len
+ *
+ * The window never has a hole another host thread could map into: the pages
+ * leave it with MREMAP_DONTUNMAP, which keeps the old range mapped, are
+ * resized outside of it, and come back with MREMAP_FIXED, which replaces the
+ * reservation (or the old range) at target at once.
+ *
+ * Hosts without MREMAP_DONTUNMAP for the mapping get anonymous private memory
+ * mapped over the reservation instead, with the data copied when it moves.
+ * Other mappings fail with ENOMEM there, the guest libc copies them itself.
+ *
+ * @param m        pointer to machine
+ * @param addr     guest address of the mapping
+ * @param old_len  length of the mapping
+ * @param new_len  length at target
+ * @param target   guest address of the moved mapping, reserved or addr itself
+ * @return i64     0 or -errno, the mapping stays at addr on errors
+ */
+static i64 sys_move(machine_t *m, u64 addr, u64 old_len, u64 new_len, u64 target) {
+    mmu_t *mmu = &m->mmu;
+    void *old = (void *) TO_HOST(mmu, addr);
+    void *out = mremap(old, old_len, old_len, MREMAP_MAYMOVE | MREMAP_DONTUNMAP);
+    if (out != MAP_FAILED) {
+        void *moved = new_len == old_len ? out : mremap(out, old_len, new_len, MREMAP_MAYMOVE);
+        if (moved != MAP_FAILED) moved = mremap(moved, new_len, new_len, MREMAP_MAYMOVE | MREMAP_FIXED, (void *) TO_HOST(mmu, target));
+        if (moved != MAP_FAILED) return 0;
+
+        // back over the old range, which is still mapped
+        int error = errno;
+        if (mremap(out, old_len, old_len, MREMAP_MAYMOVE | MREMAP_FIXED, old) == MAP_FAILED) fatal("can not restore a guest mapping");
+        return -error;
+    }
+    if (errno != EINVAL) return -errno;
+
+    int prot = sys_anon_prot((u64) old, old_len);
+    if (prot < 0) return -ENOMEM;
+    int flags = MAP_FIXED | MAP_PRIVATE | MAP_ANONYMOUS;
+    if (target == addr) {
+        // grow in place
+        if (mmap(old + old_len, new_len - old_len, prot, flags, -1, 0) == MAP_FAILED) return -errno;
+        mmu_bind(mmu, addr + old_len, new_len - old_len);
+        return 0;
+    }
+    void *to = (void *) TO_HOST(mmu, target);
+    if (mmap(to, new_len, PROT_READ | PROT_WRITE, flags, -1, 0) == MAP_FAILED) return -errno;
+    mmu_bind(mmu, target, new_len);
+    if (!(prot & PROT_READ)) mprotect(old, old_len, PROT_READ);
+    memcpy(to, old, MIN(old_len, new_len));
+    mprotect(to, new_len, prot);
+    return 0;
+}
+
+static u64 sys_mremap(machine_t *m) {
+    GET(a0, addr);
+    GET(a1, old_len);
+    GET(a2, new_len);
+    GET(a3, flags);
+    GET(a4, new_addr);
+    mmu_t *mmu = &m->mmu;
+    old_len = ROUNDUP(old_len, GUEST_PAGE_SIZE);
+    new_len = ROUNDUP(new_len, GUEST_PAGE_SIZE);
+    if (!sys_range(addr, old_len) || !new_len || new_len > GUEST_MEMORY_SIZE) return -EINVAL;
+    if (flags & ~(GUEST_MREMAP_MAYMOVE | GUEST_MREMAP_FIXED)) return -EINVAL;
+    if ((flags & GUEST_MREMAP_FIXED) && !(flags & GUEST_MREMAP_MAYMOVE)) return -EINVAL;
+    if (!mmu_range_used(mmu, addr, addr + old_len)) return -EFAULT;
+    // the pages keep their protection when they move
+    checkpoint_touch(mmu, addr, old_len);
+
+    u64 target;
+    if (flags & GUEST_MREMAP_FIXED) {
+        if (!sys_range(new_addr, new_len)) return -EINVAL;
+        if (new_addr < addr + old_len && addr < new_addr + new_len) return -EINVAL;
+        target = new_addr;
+    } else if (new_len <= old_len) {
+        if (new_len < old_len) {
+            mmu_reserve(&m->mmu, addr + new_len, old_len - new_len);
+            mmu_range_give(mmu, addr + new_len, addr + old_len);
+            sys_remapped(m, addr + new_len, old_len - new_len);
+        }
+        return addr;
+    } else if (mmu_range_free(mmu, addr + old_len, addr + new_len)) {
+        // grow in place, over the reservation after the mapping
+        target = addr;
+    } else {
+        if (!(flags & GUEST_MREMAP_MAYMOVE)) return -ENOMEM;
+        target = mmu_range_find(mmu, new_len);
+        if (!target) return -ENOMEM;
+    }
+
+    // the host pages go to target, see sys_move
+    checkpoint_touch(mmu, target, new_len);
+    i64 error = sys_move(m, addr, old_len, new_len, target);
+    if (error < 0) return error;
+    if (target != addr) {
+        mmu_reserve(&m->mmu, addr, old_len);
+        mmu_range_give(mmu, addr, addr + old_len);
+        sys_remapped(m, addr, old_len);
+        sys_remapped(m, target, new_len);
+    }
+    mmu_range_take(mmu, target, target + new_len);
+    return target;
+}
+
+static u64 sys_lseek(machine_t *m) {
+    GET_FD(a0, fd);
+    GET(a1, offset);
+    GET(a2, whence);
+    return sys_ret(lseek(fd, offset, whence));
+}
+
+// copy a host struct stat out to the guest buffer at addr, in the guest layout
+static u64 sys_stat(machine_t *m, u64 addr, struct stat *st) {
+    guest_stat_t out = {
+        .dev = st->st_dev,
+        .ino = st->st_ino,
+        .mode = st->st_mode,
+        .nlink = st->st_nlink,
+        .uid = st->st_uid,
+        .gid = st->st_gid,
+        .rdev = st->st_rdev,
+        .size = st->st_size,
+        .blksize = st->st_blksize,
+        .blocks = st->st_blocks,
+        .atime = st->st_atim.tv_sec,
+        .atime_nsec = st->st_atim.tv_nsec,
+        .mtime = st->st_mtim.tv_sec,
+        .mtime_nsec = st->st_mtim.tv_nsec,
+        .ctime = st->st_ctim.tv_sec,
+        .ctime_nsec = st->st_ctim.tv_nsec,
+    };
+    return sys_copy_out(m, addr, &out, sizeof(out));
+}
+
+static u64 sys_fstat(machine_t *m) {
+    GET_FD(a0, fd);
+    GET(a1, buf);
+    struct stat st;
+    if (fstat(fd, &st) < 0) return -errno;
+    return sys_stat(m, buf, &st);
+}
+
+static u64 sys_fstatat(machine_t *m) {
+    GET(a0, dirfd);
+    GET(a1, path);
+    GET(a2, buf);
+    GET(a3, flags);
+    int host_dirfd = sys_host_dirfd(m, dirfd);
+    if (host_dirfd == -1) return -EBADF;
+    char host_path[PATH_MAX];
+    i64 error = sys_path(m, host_path, path);
+    if (error < 0) return error;
+
+    struct stat st;
+    int host_flags = flags & GUEST_AT_SYMLINK_NOFOLLOW ? AT_SYMLINK_NOFOLLOW : 0;
+    if (fstatat(host_dirfd, host_path, &st, host_flags) < 0) return -errno;
+    return sys_stat(m, buf, &st);
+}
+
+// guest time of --icount, its retired instructions at mhz MHz from the epoch, or the host clock
+static void sys_time(machine_t *m, clockid_t clock, struct timespec *ts) {
+    if (!m->state.mhz) {
+        clock_gettime(clock, ts);
+        return;
+    }
+    u64 ns = (unsigned __int128) m->state.instret * 1000 / m->state.mhz;
+    ts->tv_sec = ns / 1000000000;
+    ts->tv_nsec = ns % 1000000000;
+}
+
+static u64 sys_clock_gettime(machine_t *m) {
+    GET(a0, clock);
+    GET(a1, buf);
+    // the clocks of the guest are those of Linux
+    struct timespec ts;
+    if (clock_getres(clock, &ts) < 0) return -errno;
+    sys_time(m, clock, &ts);
+    guest_time_t out = {ts.tv_sec, ts.tv_nsec};
+    return sys_copy_out(m, buf, &out, sizeof(out));
+}
+
+static u64 sys_gettimeofday(machine_t *m) {
+    GET(a0, buf);
+    struct timespec ts;
+    sys_time(m, CLOCK_REALTIME, &ts);
+    guest_time_t out = {ts.tv_sec, ts.tv_nsec / 1000};
+    return sys_copy_out(m, buf, &out, sizeof(out));
+}
+
+// ready point of --fork-server, without it the guest goes on
+static u64 sys_snapshot(machine_t *m) {
+    if (m->snapshot.armed && !m->snapshot.pc) m->snapshot.ready = true;
+    return 0;
+}
+
+static const syscall_t syscall_table[] = {
     [SYS_exit] = sys_exit,
     [SYS_exit_group] = sys_unimpl,
     [SYS_getpid] = sys_unimpl,
     [SYS_kill] = sys_unimpl,
-    [SYS_read] = sys_unimpl,
-    [SYS_write] = sys_unimpl,
-    [SYS_openat] = sys_unimpl,
-    [SYS_close] = sys_unimpl,
-    [SYS_lseek] = sys_unimpl,
-    [SYS_brk] = sys_unimpl,
+    [SYS_read] = sys_read,
+    [SYS_write] = sys_write,
+    [SYS_openat] = sys_openat,
+    [SYS_close] = sys_close,
+    [SYS_lseek] = sys_lseek,
+    [SYS_brk] = sys_brk,
     [SYS_linkat] = sys_unimpl,
     [SYS_unlinkat] = sys_unimpl,
     [SYS_mkdirat] = sys_unimpl,
     [SYS_renameat] = sys_unimpl,
     [SYS_chdir] = sys_unimpl,
     [SYS_getcwd] = sys_unimpl,
-    [SYS_fstat] = sys_unimpl,
-    [SYS_fstatat] = sys_unimpl,
+    [SYS_fstat] = sys_fstat,
+    [SYS_fsync] = sys_fsync,
+    [SYS_fstatat] = sys_fstatat,
     [SYS_faccessat] = sys_unimpl,
-    [SYS_pread] = sys_unimpl,
-    [SYS_pwrite] = sys_unimpl,
+    [SYS_pread] = sys_pread,
+    [SYS_pwrite] = sys_pwrite,
     [SYS_uname] = sys_unimpl,
     [SYS_getuid] = sys_unimpl,
     [SYS_geteuid] = sys_unimpl,
     [SYS_getgid] = sys_unimpl,
     [SYS_getegid] = sys_unimpl,
-    [SYS_mmap] = sys_unimpl,
-    [SYS_munmap] = sys_unimpl,
-    [SYS_mremap] = sys_unimpl,
-    [SYS_mprotect] = sys_unimpl,
+    [SYS_mmap] = sys_mmap,
+    [SYS_munmap] = sys_munmap,
+    [SYS_mremap] = sys_mremap,
+    [SYS_mprotect] = sys_mprotect,
     [SYS_prlimit64] = sys_unimpl,
     [SYS_getmainvars] = sys_unimpl,
     [SYS_rt_sigaction] = sys_unimpl,
-    [SYS_writev] = sys_unimpl,
-    [SYS_gettimeofday] = sys_unimpl,
+    [SYS_writev] = sys_writev,
+    [SYS_gettimeofday] = sys_gettimeofday,
     [SYS_times] = sys_unimpl,
     [SYS_fcntl] = sys_unimpl,
     [SYS_ftruncate] = sys_unimpl,
@@ -60,7 +701,7 @@ static syscall_t syscall_table[] = {
     [SYS_getrlimit] = sys_unimpl,
     [SYS_setrlimit] = sys_unimpl,
     [SYS_getrusage] = sys_unimpl,
-    [SYS_clock_gettime] = sys_unimpl,
+    [SYS_clock_gettime] = sys_clock_gettime,
     [SYS_set_tid_address] = sys_unimpl,
     [SYS_set_robust_list] = sys_unimpl,
     [SYS_open] = sys_unimpl,
@@ -73,9 +714,101 @@ static syscall_t syscall_table[] = {
     [SYS_time] = sys_unimpl,
 };
 
+// the syscalls --replay runs again, they change the machine and not the host
+static bool sys_replayed(u64 n) {
+    return n == SYS_exit || n == SYS_brk || n == SYS_mmap || n == SYS_munmap || n == SYS_mremap ||
+           n == SYS_mprotect || n == SYS_snapshot;
+}
+
+// log a syscall of --record with the guest memory it wrote
+static void sys_record(machine_t *m, u64 n, u64 ret) {
+    replay_entry_t entry = {.n = n, .ret = ret};
+    u64 len = 0;
+    void *data = NULL;
+    switch (n) {
+        case SYS_read:
+        case SYS_pread:
+            if ((i64) ret > 0) entry.addr = machine_get_gp_reg(m, a1), len = ret;
+            break;
+        case SYS_fstat:
+            if (!ret) entry.addr = machine_get_gp_reg(m, a1), len = sizeof(guest_stat_t);
+            break;
+        case SYS_fstatat:
+            if (!ret) entry.addr = machine_get_gp_reg(m, a2), len = sizeof(guest_stat_t);
+            break;
+        case SYS_clock_gettime:
+            if (!ret) entry.addr = machine_get_gp_reg(m, a1), len = sizeof(guest_time_t);
+            break;
+        case SYS_gettimeofday:
+            if (!ret) entry.addr = machine_get_gp_reg(m, a0), len = sizeof(guest_time_t);
+            break;
+        case SYS_write:
+        case SYS_writev:
+            if (sys_console(sys_host_fd(m, machine_get_gp_reg(m, a0)))) entry.flags = REPLAY_CONSOLE;
+            break;
+        case SYS_mmap: {
+            // the contents of a file mapping, read from the file as the mapping may not be readable
+            GET(a1, map_len);
+            GET(a3, flags);
+            GET(a5, offset);
+            int host_fd = sys_host_fd(m, machine_get_gp_reg(m, a4));
+            struct stat st;
+            if (ret >= (u64) -4095 || (flags & GUEST_MAP_ANONYMOUS) || fstat(host_fd, &st) < 0 ||
+                (u64) st.st_size <= offset) {
+                break;
+            }
+            entry.addr = ret;
+            len = MIN(st.st_size - offset, map_len);
+            data = malloc(len);
+            if (!data) fatal("malloc failed.");
+            if (pread(host_fd, data, len, offset) != (ssize_t) len) fatal("cannot log the file mapping");
+            break;
+        }
+    }
+    if (len > UINT32_MAX) fatalf("syscall %lu wrote too much guest memory to be logged", n);
+    entry.len = len;
+    replay_log(m, &entry, data ? data : (void *) TO_HOST(&m->mmu, entry.addr));
+    free(data);
+}
+
+// a syscall of --replay, from the log
+static u64 sys_replay(machine_t *m, u64 n, syscall_t f) {
+    replay_entry_t entry;
+    void *data = replay_next(m, &entry);
+    if (entry.n != n) {
+        console_flush(&m->console);
+        fatalf("replay diverged at pc 0x%lx: syscall %lu, the log has %u", m->state.pc, n, entry.n);
+    }
+
+    if (sys_replayed(n)) {
+        // a file mapping is anonymous memory filled from the log
+        u64 flags = machine_get_gp_reg(m, a3);
+        if (n == SYS_mmap) machine_set_gp_reg(m, a3, flags | GUEST_MAP_ANONYMOUS);
+        u64 ret = f(m);
+        if (n == SYS_mmap) machine_set_gp_reg(m, a3, flags);
+        if (ret != entry.ret) {
+            console_flush(&m->console);
+            fatalf("replay diverged at pc 0x%lx: syscall %lu returned 0x%lx, the log has 0x%lx", m->state.pc, n, ret, entry.ret);
+        }
+    } else if (entry.flags & REPLAY_CONSOLE) {
+        f(m);
+    }
+    if (entry.len) replay_write(m, entry.addr, data, entry.len);
+    return entry.ret;
+}
+
 u64 do_syscall(machine_t *m, u64 n) {
     syscall_t f = NULL;
-    f = syscall_table[n];
-    if (!f) fatal("unknown syscall");
-    return f(m);
+    if (n < sizeof(syscall_table) / sizeof(syscall_table[0])) f = syscall_table[n];
+    if (!f && n == SYS_snapshot) f = sys_snapshot;
+    if (!f) fatalf("unknown syscall: %ld", n);
+    // fatal without touching the host, the replay stops where the record did
+    if (f == sys_unimpl) return f(m);
+    if (m->replay.mode == replay_play) return sys_replay(m, n, f);
+
+    // the other syscalls see the guest writes done, and the file positions up to date
+    if (n != SYS_read && n != SYS_write && n != SYS_pwrite) uring_sync(&m->uring);
+    u64 ret = f(m);
+    if (m->replay.mode == replay_record) sys_record(m, n, ret);
+    return ret;
 }
\ No newline at end of file
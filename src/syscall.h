@@ -20,6 +20,7 @@
 #define SYS_chdir 49
 #define SYS_getcwd 17
 #define SYS_fstat 80
+#define SYS_fsync 82
 #define SYS_fstatat 79
 #define SYS_faccessat 48
 #define SYS_pread 67
@@ -0,0 +1,302 @@
+#define _GNU_SOURCE
+#include <signal.h>
+#include <ucontext.h>
+#include "rvemu.h"
+
+/**
+ * Guest traps
+ *
+ * Guest loads and stores are a single host memory access, without bounds
+ * check. The guest window is reserved PROT_NONE with guard regions around it
+ * (see mmu.c), so an access to memory the guest has not mapped raises SIGSEGV
+ * (or SIGBUS past the end of a mapped file) instead of reaching host memory.
+ *
+ * The signal handler finds the guest pc of the faulting access and jumps back
+ * to machine_step, which raises a precise access fault: the instructions
+ * before the faulting one have retired, the faulting one and the following
+ * ones have not.
+ *
+ * Exceptions found by the emulator itself, like the page faults of the Sv39
+ * translation, take the same way back through trap_throw.
+ *
+ * Host code copying from or to guest buffers, for the syscalls the emulator
+ * serves itself, goes through trap_copy, which turns a fault on the buffer
+ * into EFAULT as the kernel would.
+ */
+
+// machine running guest code on this thread, NULL while the host runs its own code
+static __thread machine_t *trap_machine;
+
+// buffers of trap_copy, either may be the guest one, and the way back to it on a fault
+typedef struct {
+    sigjmp_buf jmp;
+    u64 src;
+    u64 dst;
+    u64 len;
+} trap_copy_t;
+
+// copy in progress on this thread, NULL otherwise
+static __thread trap_copy_t *trap_copying;
+
+static const char *const trap_names[] = {
+    [instruction_address_misaligned] = "instruction address misaligned",
+    [instruction_access_fault] = "instruction access fault",
+    [load_access_fault] = "load access fault",
+    [store_access_fault] = "store access fault",
+    [load_address_misaligned] = "load address misaligned",
+    [store_address_misaligned] = "store address misaligned",
+    [instruction_page_fault] = "instruction page fault",
+    [load_page_fault] = "load page fault",
+    [store_page_fault] = "store page fault",
+};
+
+/**
+ * @brief SIGSEGV and SIGBUS handler
+ *
+ * @param sig     signal number
+ * @param info    faulting address
+ * @param context host registers at the fault
+ */
+static void trap_signal(int sig, siginfo_t *info, void *context) {
+    machine_t *m = trap_machine;
+    u64 addr = (u64) info->si_addr;
+
+    // a write to guest memory protected by the checkpoint dirty tracking, by
+    // the guest or by the host, goes on once it is marked
+    if (sig == SIGSEGV && checkpoint_fault(addr)) return;
+
+    // an unmapped guest buffer read or written by trap_copy
+    if (trap_copying && (addr - trap_copying->src < trap_copying->len || addr - trap_copying->dst < trap_copying->len)) {
+        siglongjmp(trap_copying->jmp, 1);
+    }
+
+    // a bug of the emulator, crash with the default action
+    if (!m || addr < TO_HOST(&m->mmu, 0) - GUEST_GUARD_SIZE || addr >= GUEST_END(&m->mmu) + GUEST_GUARD_SIZE) {
+        signal(sig, SIG_DFL);
+        return;
+    }
+
+    m->fault_addr = TO_GUEST(&m->mmu, addr);
+    m->fault_code = -1;
+
+    // native JIT code does not keep pc up to date, the interpreter and the
+    // handlers called back by the JIT do
+    #if defined(__x86_64__)
+    u64 pc;
+    ucontext_t *uc = context;
+    if (m->use_jit && jit_fault_pc(&m->jit, uc->uc_mcontext.gregs[REG_RIP], &pc)) m->state.pc = pc;
+    #endif
+
+    siglongjmp(m->trap_jmp, 1);
+}
+
+/**
+ * @brief raise a guest exception from emulator code running the guest
+ *
+ * Like a host fault, the exception is taken by machine_step, pc must be the
+ * guest pc of the trapping instruction (or of the fused pair ending with it).
+ *
+ * @param code exception code
+ * @param tval faulting address
+ */
+void trap_throw(enum exception_type_t code, u64 tval) {
+    machine_t *m = trap_machine;
+    m->fault_addr = tval;
+    m->fault_code = code;
+    siglongjmp(m->trap_jmp, 1);
+}
+
+/**
+ * @brief copy from or to a guest buffer in host code, the guest may pass memory it has not mapped
+ *
+ * @param dst host buffer, or host address of the guest buffer written
+ * @param src host address of the guest buffer read, or host buffer
+ * @param len bytes to copy
+ * @return i64 0, or -EFAULT if the guest buffer is not mapped, dst is then partly written
+ */
+i64 trap_copy(void *dst, void *src, u64 len) {
+    trap_copy_t copying = {.src = (u64) src, .dst = (u64) dst, .len = len};
+    if (sigsetjmp(copying.jmp, 0)) {
+        trap_copying = NULL;
+        return -EFAULT;
+    }
+    // the handler must see trap_copying set around the whole copy, which the
+    // compiler could otherwise move or drop as memcpy does not read it
+    trap_copying = &copying;
+    __atomic_signal_fence(__ATOMIC_SEQ_CST);
+    memcpy(dst, src, len);
+    __atomic_signal_fence(__ATOMIC_SEQ_CST);
+    trap_copying = NULL;
+    return 0;
+}
+
+/**
+ * @brief install the guest fault handlers
+ *
+ */
+void trap_init() {
+    // the handler never returns to the faulting code, SA_NODEFER leaves the
+    // signal unblocked so that sigsetjmp does not have to save the mask
+    struct sigaction action = {
+        .sa_sigaction = trap_signal,
+        .sa_flags = SA_SIGINFO | SA_NODEFER,
+    };
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGSEGV, &action, NULL) == -1 || sigaction(SIGBUS, &action, NULL) == -1) {
+        fatal(strerror(errno));
+    }
+}
+
+/**
+ * @brief route the faults of the guest window to a machine, its trap_jmp must be set
+ *
+ * @param m pointer to machine
+ */
+void trap_attach(machine_t *m) {
+    trap_machine = m;
+}
+
+/**
+ * @brief back to host code, faults crash the emulator again
+ *
+ */
+void trap_detach() {
+    trap_machine = NULL;
+}
+
+/**
+ * @brief is a decoded instruction a guest memory access
+ *
+ * @param inst decoded instruction
+ * @param store set if the access is a store
+ * @return true the instruction is a load or a store
+ */
+static bool trap_is_access(inst_t *inst, bool *store) {
+    switch (inst->type) {
+        case inst_lb: case inst_lh: case inst_lw: case inst_ld:
+        case inst_lbu: case inst_lhu: case inst_lwu:
+        case inst_clw: case inst_cld: case inst_clwsp: case inst_cldsp:
+        case inst_flw: case inst_fld:
+        case inst_lb_x0: case inst_lh_x0: case inst_lw_x0: case inst_ld_x0:
+            *store = false;
+            return true;
+        case inst_sb: case inst_sh: case inst_sw: case inst_sd:
+        case inst_csw: case inst_csd: case inst_cswsp: case inst_csdsp:
+        case inst_fsw: case inst_fsd:
+            *store = true;
+            return true;
+        default:
+            return false;
+    }
+}
+
+// instructions of block from the one at pc to its end, 0 if pc is not in block
+static u32 trap_unretired(block_t *block, u64 pc) {
+    u64 addr = block->pc;
+    u32 count = block->icount;
+    for (inst_t *inst = block->insts; inst < block->insts + block->len; inst++) {
+        if (addr == pc) return count;
+        count -= inst->fused ? 2 : 1;
+        addr += INST_LEN(inst);
+    }
+    return 0;
+}
+
+/**
+ * @brief raise the exception caught by the signal handler or thrown by trap_throw
+ *
+ * Called by machine_step after the handler jumped back to it, pc is the guest
+ * pc of the faulting instruction or of the fused pair ending with it. A host
+ * fault is an access fault whose kind is found from the instruction. instret
+ * loses the instructions of the running block that did not retire.
+ *
+ * @param m pointer to machine
+ */
+void trap_access_fault(machine_t *m) {
+    state_t *state = &m->state;
+    state->exit_reason = none;
+
+    // without a trap handler the guest is stopped, its output goes out first
+    if (!csr_read(state, mtvec_id)) console_flush(&m->console);
+
+    if (m->fetching) {
+        m->fetching = false;
+        trap_raise(state, m->fault_code < 0 ? instruction_access_fault : m->fault_code, m->fault_addr);
+        return;
+    }
+
+    // the running block was counted whole, its instructions from pc on did not retire
+    u32 unretired = state->block ? trap_unretired(state->block, state->pc) : 0;
+    state->instret -= unretired;
+    state->block = NULL;
+
+    // the code at pc may be gone as well, the fault is then taken on fetch
+    m->fetching = true;
+    inst_t inst;
+    bool store;
+    inst_decode(&inst, mmu_fetch(state, state->pc));
+    if (!trap_is_access(&inst, &store)) {
+        // second instruction of a fused pair, the first one has retired
+        state->pc += 4;
+        if (unretired) state->instret++;
+        inst_decode(&inst, mmu_fetch(state, state->pc));
+        if (!trap_is_access(&inst, &store)) fatalf("unexpected fault at pc 0x%lx", state->pc);
+    }
+    m->fetching = false;
+
+    if (m->fault_code >= 0) trap_raise(state, m->fault_code, m->fault_addr);
+    else trap_raise(state, store ? store_access_fault : load_access_fault, m->fault_addr);
+}
+
+// enter the machine mode handler at target, pc is saved to mepc
+static void trap_enter(state_t *state, u64 cause, u64 tval, u64 target) {
+    csr_write(state, mepc_id, state->pc);
+    csr_write(state, mcause_id, cause);
+    csr_write(state, mtval_id, tval);
+
+    u64 mstatus = csr_read(state, mstatus_id);
+    u64 mie = csr_get(mstatus, mie, mstatus);
+    mstatus = csr_set(mstatus, mpie, mstatus, mie << mstatus_mpie_pos);
+    mstatus = csr_set(mstatus, mie, mstatus, 0);
+    mstatus = csr_set(mstatus, mpp, mstatus, (u64) state->priv << mstatus_mpp_pos);
+    csr_write(state, mstatus_id, mstatus);
+
+    state->priv = priv_m;
+    mmu_update(state);
+    csr_timer_update(state);
+    state->pc = target;
+}
+
+/**
+ * @brief take a trap to the machine mode handler at mtvec
+ *
+ * Guest programs running without a trap handler (mtvec is zero) are stopped.
+ *
+ * @param state CPU state, pc is the guest pc of the trapping instruction
+ * @param code  exception code
+ * @param tval  faulting address
+ */
+void trap_raise(state_t *state, enum exception_type_t code, u64 tval) {
+    u64 mtvec = csr_read(state, mtvec_id);
+    if (!mtvec) fatalf("%s at pc 0x%lx, address 0x%lx", trap_names[code], state->pc, tval);
+
+    // direct and vectored modes are the same for exceptions
+    trap_enter(state, code, tval, mtvec & ~(u64) 0x3);
+}
+
+/**
+ * @brief take the timer interrupt of --icount to the machine mode handler at mtvec
+ *
+ * Called by machine_step when state->timer is reached, before the block at
+ * pc, which is the pc the handler returns to.
+ *
+ * @param state CPU state
+ */
+void trap_interrupt(state_t *state) {
+    u64 mtvec = csr_read(state, mtvec_id);
+    if (!mtvec) fatalf("timer interrupt at pc 0x%lx without a trap handler", state->pc);
+
+    u64 target = mtvec & ~(u64) 0x3;
+    if (mtvec & 0x1) target += 4 * mip_stip_pos;   // vectored mode
+    trap_enter(state, mcause_interrupt_mask | mip_stip_pos, 0, target);
+}
@@ -0,0 +1,483 @@
+#define _GNU_SOURCE
+#include <asm/unistd.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include "rvemu.h"
+
+/**
+ * io_uring file I/O backend
+ *
+ * With --io-uring, guest writes to the regular files the guest opened are
+ * copied to a registered buffer and queued on an io_uring, the guest goes on
+ * without waiting for the host. Small sequential writes are appended to the
+ * queued one while it is not submitted yet. The guest sees the same order as
+ * with blocking calls:
+ *
+ *   - the file position is kept here while writes are in flight, and handed
+ *     back to the host fd by uring_sync
+ *   - a write overlapping one in flight waits for it, and a read of the file
+ *     waits for all of its writes
+ *   - any other syscall first runs uring_sync, which waits for all the writes,
+ *     so close, fsync and exit see the data on the host
+ *
+ * A write failing on the host is reported by the next fsync or close of the
+ * file (EIO for a short write), like a write-back error of the kernel.
+ *
+ * Guest reads of these files are served from two registered readahead
+ * buffers: while the guest consumes one, the next chunk of the file is read
+ * into the other one by the ring.
+ *
+ * The ring is set up with the raw syscalls, without liburing.
+ */
+
+#if __has_include(<linux/io_uring.h>)
+
+#include <linux/io_uring.h>
+
+// completions of the readahead buffers are tagged with this bit
+#define URING_RA_TAG    (1ULL << 32)
+
+/**
+ * @brief set up the ring and its buffers
+ *
+ * @param ring io_uring backend
+ */
+void uring_init(uring_t *ring) {
+    struct io_uring_params params = {0};
+    ring->fd = syscall(__NR_io_uring_setup, URING_ENTRIES, &params);
+    if (ring->fd < 0) fatalf("io_uring is not available: %s", strerror(errno));
+
+    // the submission and completion rings share one mapping on recent kernels
+    u64 sq_size = params.sq_off.array + params.sq_entries * sizeof(u32);
+    u64 cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) sq_size = cq_size = MAX(sq_size, cq_size);
+
+    u8 *sq = mmap(NULL, sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+    if (sq == MAP_FAILED) fatal(strerror(errno));
+    u8 *cq = sq;
+    if (!(params.features & IORING_FEAT_SINGLE_MMAP)) {
+        cq = mmap(NULL, cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+        if (cq == MAP_FAILED) fatal(strerror(errno));
+    }
+    ring->sqes = mmap(NULL, params.sq_entries * sizeof(struct io_uring_sqe), PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+    if (ring->sqes == MAP_FAILED) fatal(strerror(errno));
+
+    ring->sq_head = (u32 *) (sq + params.sq_off.head);
+    ring->sq_tail = (u32 *) (sq + params.sq_off.tail);
+    ring->sq_array = (u32 *) (sq + params.sq_off.array);
+    ring->sq_mask = *(u32 *) (sq + params.sq_off.ring_mask);
+    ring->cq_head = (u32 *) (cq + params.cq_off.head);
+    ring->cq_tail = (u32 *) (cq + params.cq_off.tail);
+    ring->cq_mask = *(u32 *) (cq + params.cq_off.ring_mask);
+    ring->cqes = cq + params.cq_off.cqes;
+    ring->sq_ring = sq;
+    ring->cq_ring = cq;
+    ring->sq_size = sq_size;
+    ring->cq_size = cq_size;
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+
+    ring->buffers = mmap(NULL, URING_BUFFERS * URING_BUFFER_SIZE, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ring->buffers == MAP_FAILED) fatal(strerror(errno));
+
+    // registered buffers are pinned once instead of on every request, plain
+    // requests are used when the memlock limit is too low for them
+    struct iovec iov[URING_BUFFERS];
+    for (int i = 0; i < URING_BUFFERS; i++) {
+        iov[i] = (struct iovec) {.iov_base = ring->buffers + i * URING_BUFFER_SIZE, .iov_len = URING_BUFFER_SIZE};
+    }
+    ring->fixed = syscall(__NR_io_uring_register, ring->fd, IORING_REGISTER_BUFFERS, iov, URING_BUFFERS) == 0;
+
+    for (int i = URING_BUFFERS - 1; i >= URING_RA_BUFFERS; i--) ring->free[ring->num_free++] = i;
+    ring->ra_slot = -1;
+    ring->enabled = true;
+}
+
+// host address of a registered buffer
+static u8 *uring_buffer(uring_t *ring, u32 index) {
+    return ring->buffers + (u64) index * URING_BUFFER_SIZE;
+}
+
+/**
+ * @brief handle a completion
+ *
+ * @param ring io_uring backend
+ * @param cqe  completed request
+ */
+static void uring_complete(uring_t *ring, struct io_uring_cqe *cqe) {
+    ring->inflight--;
+
+    if (cqe->user_data & URING_RA_TAG) {
+        uring_ra_t *ra = &ring->ra[(u32) cqe->user_data];
+        ra->pending = false;
+        // a failed readahead is read again, and its error returned, by uring_read
+        ra->valid = cqe->res >= 0;
+        ra->len = ra->valid ? cqe->res : 0;
+        return;
+    }
+
+    u32 index = cqe->user_data;
+    uring_file_t *file = &ring->files[ring->owner[index].slot];
+    if (cqe->res != (i32) ring->owner[index].len && !file->error) file->error = cqe->res < 0 ? -cqe->res : EIO;
+    if (!--file->inflight) file->lo = file->hi = 0;
+    ring->free[ring->num_free++] = index;
+}
+
+/**
+ * @brief submit the queued requests and reap the completions
+ *
+ * @param ring io_uring backend
+ * @param wait wait for at least one completion
+ */
+static void uring_submit(uring_t *ring, bool wait) {
+    if (wait) ring->waits++;
+    while (ring->queued || wait) {
+        int ret = syscall(__NR_io_uring_enter, ring->fd, ring->queued, wait ? 1 : 0,
+                          wait ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+        if (ret < 0) {
+            if (errno == EINTR || errno == EAGAIN || errno == EBUSY) continue;
+            fatalf("io_uring_enter: %s", strerror(errno));
+        }
+        ring->queued -= ret;
+        ring->last = NULL;
+        if (!ring->queued) break;
+    }
+
+    u32 head = *ring->cq_head;
+    while (head != __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE)) {
+        uring_complete(ring, (struct io_uring_cqe *) ring->cqes + (head & ring->cq_mask));
+        head++;
+    }
+    __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief queue a request, it is submitted with the next batch
+ *
+ * @param ring   io_uring backend
+ * @param write  write or read request
+ * @param fd     host fd
+ * @param index  registered buffer
+ * @param len    bytes to transfer
+ * @param offset file offset
+ * @param data   user data of the completion
+ * @return struct io_uring_sqe* the queued request
+ */
+static struct io_uring_sqe *uring_queue(uring_t *ring, bool write, int fd, u32 index, u32 len, u64 offset, u64 data) {
+    // every request in flight has its buffer, so the rings never overflow
+    u32 tail = *ring->sq_tail;
+    u32 slot = tail & ring->sq_mask;
+    struct io_uring_sqe *sqe = (struct io_uring_sqe *) ring->sqes + slot;
+    *sqe = (struct io_uring_sqe) {
+        .opcode = ring->fixed ? (write ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED)
+                              : (write ? IORING_OP_WRITE : IORING_OP_READ),
+        .fd = fd,
+        .off = offset,
+        .addr = (u64) uring_buffer(ring, index),
+        .len = len,
+        .buf_index = ring->fixed ? index : 0,
+        .user_data = data,
+    };
+    ring->sq_array[slot] = slot;
+    __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    ring->queued++;
+    ring->inflight++;
+    return sqe;
+}
+
+/**
+ * @brief take over the file position of a guest fd
+ *
+ * @param ring io_uring backend
+ * @param file guest fd
+ * @return true the position is known
+ * @return false lseek failed, errno is set
+ */
+static bool uring_track(uring_t *ring, uring_file_t *file) {
+    if (file->tracked) return true;
+    off_t pos = lseek(file->host_fd, 0, SEEK_CUR);
+    if (pos < 0) return false;
+    file->pos = pos;
+    file->tracked = true;
+    ring->num_tracked++;
+    return true;
+}
+
+// drop the readahead data, the file it was read from may have changed
+static void uring_ra_reset(uring_t *ring, int slot) {
+    for (int i = 0; i < URING_RA_BUFFERS; i++) {
+        while (ring->ra[i].pending) uring_submit(ring, true);
+        ring->ra[i].valid = false;
+    }
+    ring->ra_slot = slot;
+}
+
+/**
+ * @brief is a guest fd handled by the backend
+ *
+ * Only regular files opened by the guest are: the standard streams may share
+ * their file position with the emulator or with each other, and the position
+ * of an O_APPEND file is not known in advance.
+ *
+ * @param ring    io_uring backend
+ * @param slot    guest fd
+ * @param host_fd host fd of the guest fd
+ * @return true   reads and writes of the fd go through the ring
+ */
+bool uring_accepts(uring_t *ring, int slot, int host_fd) {
+    if (!ring->enabled) return false;
+    uring_file_t *file = &ring->files[slot];
+    if (!file->kind) {
+        struct stat st;
+        int flags = fcntl(host_fd, F_GETFL);
+        bool regular = host_fd > STDERR_FILENO && fstat(host_fd, &st) == 0 && S_ISREG(st.st_mode) &&
+                       flags >= 0 && !(flags & O_APPEND);
+        *file = (uring_file_t) {.host_fd = host_fd, .kind = regular ? 1 : -1};
+    }
+    return file->kind > 0;
+}
+
+/**
+ * @brief queue a guest write
+ *
+ * Writes of a buffer size or more are written in place without queueing.
+ *
+ * @param ring   io_uring backend
+ * @param slot   guest fd, accepted by uring_accepts
+ * @param buf    guest data, copied before returning
+ * @param len    bytes to write
+ * @param offset file offset, -1 to write at the file position and advance it
+ * @return i64   len or -errno
+ */
+i64 uring_write(uring_t *ring, int slot, void *buf, u64 len, i64 offset) {
+    uring_file_t *file = &ring->files[slot];
+    if (offset < 0 && !uring_track(ring, file)) return -errno;
+    if (ring->ra_slot == slot) uring_ra_reset(ring, -1);
+
+    // large writes are not worth a copy, they are written in place after the queued ones
+    if (len >= URING_BUFFER_SIZE) {
+        while (file->inflight) uring_submit(ring, true);
+        ssize_t n = pwrite(file->host_fd, buf, len, offset < 0 ? (i64) file->pos : offset);
+        if (n < 0) return -errno;
+        if (offset < 0) file->pos += n;
+        return n;
+    }
+
+    // the position moves once the data is copied, see trap_copy
+    bool append = offset < 0;
+    if (append) offset = file->pos;
+    ring->writes++;
+
+    // writes in flight complete in any order, overlapping ones must not be in flight together
+    if (file->inflight && (u64) offset < file->hi && offset + len > file->lo) {
+        while (file->inflight) uring_submit(ring, true);
+    }
+
+    if (!len) return 0;
+
+    // append to the last queued write when it ends where this one starts
+    struct io_uring_sqe *last = ring->last;
+    if (last) {
+        u32 index = last->user_data;
+        if (ring->owner[index].slot == slot && last->off + last->len == (u64) offset &&
+            last->len + len <= URING_BUFFER_SIZE) {
+            if (trap_copy(uring_buffer(ring, index) + last->len, buf, len) < 0) return -EFAULT;
+            if (append) file->pos += len;
+            last->len += len;
+            ring->owner[index].len += len;
+            file->hi = MAX(file->hi, offset + len);
+            ring->merged++;
+            return len;
+        }
+    }
+
+    if (!ring->num_free) uring_submit(ring, true);
+    u32 index = ring->free[ring->num_free - 1];
+    if (trap_copy(uring_buffer(ring, index), buf, len) < 0) return -EFAULT;
+    if (append) file->pos += len;
+    ring->num_free--;
+    ring->owner[index].slot = slot;
+    ring->owner[index].len = len;
+
+    if (!file->inflight) file->lo = file->hi = offset;
+    file->lo = MIN(file->lo, (u64) offset);
+    file->hi = MAX(file->hi, offset + len);
+    file->inflight++;
+
+    ring->last = uring_queue(ring, true, file->host_fd, index, len, offset, index);
+    if (ring->queued >= URING_BATCH) uring_submit(ring, false);
+    return len;
+}
+
+// readahead buffer holding the file offset pos, NULL if none
+static uring_ra_t *uring_ra_find(uring_t *ring, u64 pos) {
+    for (int i = 0; i < URING_RA_BUFFERS; i++) {
+        uring_ra_t *ra = &ring->ra[i];
+        if (ra->pending && pos >= ra->start && pos < ra->start + URING_BUFFER_SIZE) return ra;
+        if (ra->valid && pos >= ra->start && pos < ra->start + ra->len) return ra;
+    }
+    return NULL;
+}
+
+// start reading the chunk of the file following a full readahead buffer
+static void uring_ra_next(uring_t *ring, uring_file_t *file, uring_ra_t *ra) {
+    if (ra->len != URING_BUFFER_SIZE) return;
+    u64 next = ra->start + URING_BUFFER_SIZE;
+    if (uring_ra_find(ring, next)) return;
+
+    uring_ra_t *other = &ring->ra[ra == &ring->ra[0]];
+    if (other->pending) return;
+    *other = (uring_ra_t) {.pending = true, .start = next};
+    uring_queue(ring, false, file->host_fd, other - ring->ra, URING_BUFFER_SIZE, next, URING_RA_TAG | (other - ring->ra));
+    uring_submit(ring, false);
+}
+
+/**
+ * @brief read a guest fd at its file position
+ *
+ * @param ring io_uring backend
+ * @param slot guest fd, accepted by uring_accepts
+ * @param buf  guest buffer
+ * @param len  bytes to read
+ * @return i64 bytes read or -errno
+ */
+i64 uring_read(uring_t *ring, int slot, void *buf, u64 len) {
+    uring_file_t *file = &ring->files[slot];
+    if (!uring_track(ring, file)) return -errno;
+    ring->reads++;
+
+    // the read sees the writes before it
+    while (file->inflight) uring_submit(ring, true);
+    if (ring->ra_slot != slot) uring_ra_reset(ring, slot);
+
+    u8 *data = buf;
+    u64 done = 0;
+    bool hit = true;
+    while (done < len) {
+        uring_ra_t *ra = uring_ra_find(ring, file->pos);
+        while (ra && ra->pending) uring_submit(ring, true);
+        if (ra && ra->valid && file->pos < ra->start + ra->len) {
+            u64 n = MIN(len - done, ra->start + ra->len - file->pos);
+            memcpy(data + done, uring_buffer(ring, ra - ring->ra) + (file->pos - ra->start), n);
+            done += n;
+            file->pos += n;
+            uring_ra_next(ring, file, ra);
+            continue;
+        }
+        hit = false;
+
+        // large reads go straight to the guest buffer
+        if (len - done >= URING_BUFFER_SIZE) {
+            ssize_t n = pread(file->host_fd, data + done, len - done, file->pos);
+            if (n < 0) return done ? (i64) done : -errno;
+            done += n;
+            file->pos += n;
+            break;
+        }
+
+        // miss, or a readahead failed or reached the end of the file
+        ra = &ring->ra[0];
+        while (ra->pending) uring_submit(ring, true);
+        ssize_t n = pread(file->host_fd, uring_buffer(ring, 0), URING_BUFFER_SIZE, file->pos);
+        if (n < 0) return done ? (i64) done : -errno;
+        *ra = (uring_ra_t) {.valid = true, .start = file->pos, .len = n};
+        if (!n) break;
+    }
+    if (hit) ring->ra_hits++;
+    return done;
+}
+
+/**
+ * @brief wait for the writes in flight and hand the file positions back to the host fds
+ *
+ * Called before any syscall the backend does not handle itself.
+ *
+ * @param ring io_uring backend
+ */
+void uring_sync(uring_t *ring) {
+    if (!ring->enabled) return;
+    while (ring->inflight) uring_submit(ring, true);
+    if (ring->ra_slot >= 0) uring_ra_reset(ring, -1);
+
+    for (int slot = 0; ring->num_tracked && slot < GUEST_MAX_FDS; slot++) {
+        uring_file_t *file = &ring->files[slot];
+        if (!file->tracked) continue;
+        lseek(file->host_fd, file->pos, SEEK_SET);
+        file->tracked = false;
+        ring->num_tracked--;
+    }
+}
+
+/**
+ * @brief take the error of a write which failed after the guest was told it succeeded
+ *
+ * @param ring io_uring backend
+ * @param slot guest fd
+ * @return int errno of the write, 0 if none
+ */
+int uring_error(uring_t *ring, int slot) {
+    if (!ring->enabled) return 0;
+    int error = ring->files[slot].error;
+    ring->files[slot].error = 0;
+    return error;
+}
+
+/**
+ * @brief forget a closed guest fd, after uring_sync
+ *
+ * @param ring io_uring backend
+ * @param slot guest fd
+ */
+void uring_close(uring_t *ring, int slot) {
+    if (ring->enabled) ring->files[slot] = (uring_file_t) {0};
+}
+
+/**
+ * @brief wait for the writes in flight and release the ring
+ *
+ * @param ring io_uring backend
+ */
+void uring_free(uring_t *ring) {
+    if (!ring->enabled) return;
+    uring_sync(ring);
+    munmap(ring->buffers, URING_BUFFERS * URING_BUFFER_SIZE);
+    munmap(ring->sqes, ring->sqes_size);
+    if (ring->cq_ring != ring->sq_ring) munmap(ring->cq_ring, ring->cq_size);
+    munmap(ring->sq_ring, ring->sq_size);
+    close(ring->fd);
+    ring->enabled = false;
+}
+
+#else
+
+void uring_init(uring_t *ring) {
+    fatal("io_uring is not supported on this host");
+}
+
+bool uring_accepts(uring_t *ring, int slot, int host_fd) {
+    return false;
+}
+
+i64 uring_write(uring_t *ring, int slot, void *buf, u64 len, i64 offset) {
+    unreachable();
+}
+
+i64 uring_read(uring_t *ring, int slot, void *buf, u64 len) {
+    unreachable();
+}
+
+void uring_sync(uring_t *ring) {
+}
+
+int uring_error(uring_t *ring, int slot) {
+    return 0;
+}
+
+void uring_close(uring_t *ring, int slot) {
+}
+
+void uring_free(uring_t *ring) {
+}
+
+#endif
@@ -1,9 +1,27 @@
 #!/usr/bin/python3
-# Test for the emulator using riscv-tests
-# https://github.com/riscv-software-src/riscv-tests
+# Tests of the emulator
+#
+#   test.py [rvemu]
+#
+# Runs the ISA tests of riscv-tests and the guest programs of test/guest with
+# every engine and decoder option of CONFIGS. The threaded interpreter is a
+# build option: build with make DISPATCH=threaded and run the tests again.
+#
+# riscv-tests (https://github.com/riscv-software-src/riscv-tests) are
+# expected built under test/riscv-tests/target, they are skipped otherwise.
+# The guest programs are assembled by test/rvasm.py and exit with 0 when
+# they pass, or with the number of the check that failed. Some of them run
+# again for the options they test, over two runs whose outputs are compared:
+# checkpoint and restore, record and replay.
 
 import os
 import subprocess
+import sys
+import tempfile
+
+sys.dont_write_bytecode = True
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "test"))
+import rvasm
 
 RV64UI_P_TEST = [
     "lui", "auipc",
@@ -23,24 +41,41 @@ RV64MI_P_TEST = [
     "mcsr", "csr",
 ]
 
+# engines and decoder options each test runs with
+CONFIGS = [
+    ("interpreter", []),
+    ("interpreter --no-fusion", ["--no-fusion"]),
+    ("jit", ["--jit"]),
+    ("jit --no-fusion", ["--jit", "--no-fusion"]),
+]
+
+# options of the guest programs testing a backend, added to the ones of CONFIGS
+GUEST_OPTIONS = {
+    "write_fault": ["--io-uring"],
+}
+
 
 class Tester:
 
-    def __init__(self):
+    def __init__(self, rvemu):
         self.path = os.getcwd()
+        self.rvemu = os.path.abspath(rvemu)
         self.isa_test_dir = "test/riscv-tests/target/share/riscv-tests/isa"
-        self.report_pass=False
-
-    def run_test(self, prefix, name):
-        self.test_path = self.isa_test_dir + "/" + prefix + name
-        cmd = "./rvemu " + self.test_path
-        proc = subprocess.Popen(cmd,
-                            stdout=subprocess.PIPE,
-                            stderr=subprocess.PIPE,
-                            shell=True,
-                            universal_newlines=True)
-        std_out, std_err = proc.communicate()
-        return proc.returncode
+        self.guest_dir = "test/guest"
+        self.tmpdir = tempfile.TemporaryDirectory(prefix="rvemu-test-")
+        self.tmp = self.tmpdir.name
+        self.report_pass = False
+        self.failed = 0
+
+    def run(self, options, args, input=None):
+        proc = subprocess.run([self.rvemu] + options + args, input=input,
+                              stdin=subprocess.DEVNULL if input is None else None,
+                              stdout=subprocess.PIPE, stderr=subprocess.PIPE, cwd=self.tmp)
+        return proc.returncode, proc.stdout, proc.stderr
+
+    def run_test(self, prefix, name, options):
+        self.test_path = os.path.join(self.path, self.isa_test_dir, prefix + name)
+        return self.run(options, [self.test_path])[0]
 
     def report_result(self, test_suite, name):
         print("Test Result for test suite: " + name)
@@ -56,16 +91,21 @@ class Tester:
                 failed += 1
         print("Total Passed: " + str(passed))
         print("Total Failed: " + str(failed))
+        self.failed += failed
 
     def run_test_suite(self, prefix, suite, suite_name):
-        self.test_result = []
-        for test in suite:
-            result = self.run_test(prefix, test)
-            if result == 0:
-                self.test_result.append(True)
-            else:
-                self.test_result.append(False)
-        self.report_result(suite, suite_name)
+        if not os.path.isdir(self.isa_test_dir):
+            print(f"{suite_name}: skipped, no riscv-tests in {self.isa_test_dir}")
+            return
+        for config, options in CONFIGS:
+            self.test_result = []
+            for test in suite:
+                result = self.run_test(prefix, test, options)
+                if result == 0:
+                    self.test_result.append(True)
+                else:
+                    self.test_result.append(False)
+            self.report_result(suite, f"{suite_name} ({config})")
 
     def run_rv64ui_p_test(self):
         self.run_test_suite('rv64ui-p-', RV64UI_P_TEST, "RV64UI_P_TEST")
@@ -76,9 +116,67 @@ class Tester:
     def run_rv64mi_p_test(self):
         self.run_test_suite('rv64mi-p-', RV64MI_P_TEST, "RV64MI_P_TEST")
 
+    # assemble test/guest/name.s, returns the path of the program
+    def guest(self, name):
+        elf = os.path.join(self.tmp, name + ".elf")
+        with open(os.path.join(self.path, self.guest_dir, name + ".s")) as source:
+            code = rvasm.assemble(source.read())
+        with open(elf, "wb") as out:
+            out.write(rvasm.elf(code))
+        return elf
+
+    def run_guest_tests(self):
+        names = sorted(name[:-2] for name in os.listdir(self.guest_dir) if name.endswith(".s"))
+        for config, options in CONFIGS:
+            self.test_result = []
+            for name in names:
+                result = self.run(options + GUEST_OPTIONS.get(name, []), [self.guest(name)])[0]
+                self.test_result.append(result == 0)
+            self.report_result(names, f"GUEST_TEST ({config})")
+
+    # --checkpoint-every, then --restore of the last checkpoint: the restored
+    # guest passes as well, printing the end of the output of the full run
+    def run_checkpoint_test(self, options):
+        elf = self.guest("checkpoint")
+        ckpt = os.path.join(self.tmp, "checkpoint.ckpt")
+        code, full, _ = self.run(options + ["--checkpoint-every", "3000", "--checkpoint-file", ckpt], [elf])
+        if code != 0:
+            return False
+        code, rest, _ = self.run(options + ["--restore", ckpt], [])
+        return code == 0 and 0 < len(rest) < len(full) and full.endswith(rest)
+
+    # --record with an input, then --replay without: same output
+    def run_replay_test(self, options):
+        elf = self.guest("replay")
+        log = os.path.join(self.tmp, "replay.log")
+        code, recorded, _ = self.run(options + ["--record", log], [elf], input=b"recorded")
+        if code != 0 or not recorded.startswith(b"recorded"):
+            return False
+        code, replayed, _ = self.run(options + ["--replay", log], [elf])
+        return code == 0 and replayed == recorded
+
+    def run_replay_fatal_test(self, options):
+        elf = self.guest("replay_fatal")
+        log = os.path.join(self.tmp, "replay_fatal.log")
+        code, recorded, error = self.run(options + ["--record", log], [elf], input=b"recorded")
+        if code != 1 or recorded != b"recorded" or b"unimplemented syscall" not in error:
+            return False
+        code, replayed, replay_error = self.run(options + ["--replay", log], [elf])
+        return code == 1 and replayed == recorded and replay_error == error
+
+    def run_option_tests(self):
+        names = ["checkpoint", "replay", "replay_fatal"]
+        for config, options in CONFIGS:
+            self.test_result = [self.run_checkpoint_test(options), self.run_replay_test(options),
+                                self.run_replay_fatal_test(options)]
+            self.report_result(names, f"OPTION_TEST ({config})")
+
 
 if __name__ == '__main__':
-    tester = Tester()
+    tester = Tester(sys.argv[1] if len(sys.argv) > 1 else "./rvemu")
     tester.run_rv64ui_p_test()
     tester.run_rv64um_p_test()
-    tester.run_rv64mi_p_test()
\ No newline at end of file
+    tester.run_rv64mi_p_test()
+    tester.run_guest_tests()
+    tester.run_option_tests()
+    sys.exit(1 if tester.failed else 0)
@@ -0,0 +1,42 @@
+# Direct, indirect and recursive calls: block chaining, the jump cache and
+# the return-address stack
+    li s0, 2000
+    li s1, 0
+    la s2, double
+loop:
+    mv a0, s0
+    jalr ra, 0(s2)              # indirect call
+    add s1, s1, a0
+    li a0, 50
+    jal ra, sum                 # 50 nested calls
+    add s1, s1, a0
+    addi s0, s0, -1
+    bne s0, zero, loop
+    li t0, 6552000              # 2000 * 2001 + 2000 * 1275
+    bne s1, t0, fail
+    li a0, 0
+    li a7, 93
+    ecall
+fail:
+    li a0, 1
+    li a7, 93
+    ecall
+
+double:
+    slli a0, a0, 1
+    jalr zero, 0(ra)
+
+# a0 + (a0 - 1) + ... + 1
+sum:
+    beq a0, zero, sum_done
+    addi sp, sp, -16
+    sd ra, 0(sp)
+    sd a0, 8(sp)
+    addi a0, a0, -1
+    jal ra, sum
+    ld t1, 8(sp)
+    add a0, a0, t1
+    ld ra, 0(sp)
+    addi sp, sp, 16
+sum_done:
+    jalr zero, 0(ra)
@@ -0,0 +1,34 @@
+# Checkpoint and restore: test.py runs it with --checkpoint-every and resumes
+# it with --restore from its last checkpoint. Each round writes its letter and
+# adds to a sum on the stack, the restored guest must find the sum the
+# checkpoint saved and print the letters of the rounds left
+    addi sp, sp, -16
+    sd zero, 0(sp)              # sum
+    li s0, 0                    # round
+    li s1, 16
+round:
+    addi t0, s0, 0x61           # a, b, c...
+    sb t0, 8(sp)
+    li a0, 1
+    addi a1, sp, 8
+    li a2, 1
+    li a7, 64                   # write, checkpoints are taken at syscalls
+    ecall
+    li t1, 500
+spin:
+    ld t2, 0(sp)
+    add t2, t2, s0
+    sd t2, 0(sp)
+    addi t1, t1, -1
+    bne t1, zero, spin
+    addi s0, s0, 1
+    bne s0, s1, round
+
+    ld t2, 0(sp)
+    li t0, 60000                # 500 * (0 + 1 + ... + 15)
+    li a0, 1
+    bne t2, t0, exit
+    li a0, 0
+exit:
+    li a7, 93
+    ecall
@@ -0,0 +1,50 @@
+# Access faults taken by the guest trap handler, with the mcause, mtval and
+# mepc of the faulting instruction, the second one of a fused pair included
+    la t0, handler
+    csrrw zero, 0x305, t0
+    li t1, 0x1000               # not mapped, below the program
+load:
+    ld a0, 0(t1)
+    li a0, 1
+    li t0, 5                    # load access fault
+    bne s1, t0, fail
+    bne s2, t1, fail
+    la t0, load
+    bne s3, t0, fail
+
+    addi t2, t1, 8
+store:
+    sd a0, 0(t2)
+    li a0, 2
+    li t0, 7                    # store access fault
+    bne s1, t0, fail
+    bne s2, t2, fail
+    la t0, store
+    bne s3, t0, fail
+
+pair:
+    auipc t4, 0
+pair_ld:
+    ld a0, -2048(t4)            # below the program too
+    li a0, 3
+    li t0, 5
+    bne s1, t0, fail
+    la t0, pair
+    addi t0, t0, -2048
+    bne s2, t0, fail
+    la t0, pair_ld
+    bne s3, t0, fail
+
+    li a0, 0
+fail:
+    li a7, 93
+    ecall
+
+# records mcause, mtval and mepc in s1, s2 and s3, resumes after the fault
+handler:
+    csrrs s1, 0x342, zero
+    csrrs s2, 0x343, zero
+    csrrs s3, 0x341, zero
+    addi t0, s3, 4
+    csrrw zero, 0x341, t0
+    mret
@@ -0,0 +1,36 @@
+# Pairs fused by the decoder (lui+addi, auipc+jalr, auipc+jalr zero, auipc+ld,
+# slli+srli and addi+bne) compute what the two instructions do
+    li s0, 3000                 # lui+addi
+    li s1, 0
+loop:
+    auipc ra, 0                 # auipc+jalr
+    jalr ra, 16(ra)
+    j load
+    nop
+low12:
+    slli t0, s0, 52             # slli+srli
+    srli t0, t0, 52
+    add s1, s1, t0
+    jalr zero, 0(ra)
+load:
+    auipc t1, 0                 # auipc+ld
+    ld t2, 12(t1)
+    j next
+    .dword 5
+next:
+    add s1, s1, t2
+    auipc t3, 0                 # auipc+jalr zero, a tail call
+    jalr zero, 12(t3)
+    addi s1, s1, 1              # skipped
+    add s1, s1, zero            # the pair does not link to x0
+    addi s0, s0, -1             # addi+bne
+    bne s0, zero, loop
+    li t0, 4516500              # 3000 * 3001 / 2 + 3000 * 5
+    bne s1, t0, fail
+    li a0, 0
+    li a7, 93
+    ecall
+fail:
+    li a0, 1
+    li a7, 93
+    ecall
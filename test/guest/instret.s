@@ -0,0 +1,45 @@
+# The instructions of a block after a faulting access do not retire: minstret
+# read by the trap handler counts the ones before the fault only, the first
+# instruction of a fused pair ending with the fault included
+    la t0, handler
+    csrrw zero, 0x305, t0
+    li t1, 0x1000               # not mapped, below the program
+
+    la s6, resume1
+    csrrs s5, 0xB02, zero       # a block of its own, it counts itself
+    addi t2, zero, 1
+    addi t2, t2, 1
+    ld a0, 0(t1)
+    addi t2, t2, 1
+    addi t2, t2, 1
+    j fail
+resume1:
+    li a0, 1
+    sub t0, s4, s5
+    li t3, 3                    # two addi and the csrrs of the handler
+    bne t0, t3, fail
+
+    la s6, resume2
+    csrrs s5, 0xB02, zero
+    addi t2, zero, 1
+    auipc t4, 0
+    ld a0, -2048(t4)            # below the program
+    addi t2, t2, 1
+    addi t2, t2, 1
+    j fail
+resume2:
+    li a0, 2
+    sub t0, s4, s5
+    li t3, 3                    # addi, auipc and the csrrs of the handler
+    bne t0, t3, fail
+
+    li a0, 0
+fail:
+    li a7, 93
+    ecall
+
+# records minstret in s4, resumes at s6
+handler:
+    csrrs s4, 0xB02, zero
+    csrrw zero, 0x341, s6
+    mret
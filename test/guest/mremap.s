@@ -0,0 +1,102 @@
+# mremap grows a mapping in place over the free room after it, and moves it
+# with its data when the room is taken, leaving the old range unmapped
+    la t0, handler
+    csrrw zero, 0x305, t0
+
+    li a0, 0
+    li a1, 0x6000
+    li a2, 3
+    li a3, 0x22                 # MAP_PRIVATE | MAP_ANONYMOUS
+    li a4, -1
+    li a5, 0
+    li a7, 222                  # mmap
+    ecall
+    mv s0, a0
+    li t0, 77
+    sb t0, 0(s0)
+
+    # keep the first two pages, the room after them is free again
+    li t0, 0x2000
+    add a0, s0, t0
+    li a1, 0x4000
+    li a7, 215                  # munmap
+    ecall
+    mv a0, s0
+    li a1, 0x2000
+    li a2, 0x4000
+    li a3, 0                    # in place only
+    li a7, 216                  # mremap
+    ecall
+    li s11, 1
+    beq a0, s0, grown
+fail:
+    mv a0, s11
+    li a7, 93
+    ecall
+
+grown:
+    li s11, 2
+    lbu t0, 0(s0)
+    li t1, 77
+    bne t0, t1, fail
+    li t0, 0x3fff
+    add t0, s0, t0
+    lbu t1, 0(t0)               # the new pages are zero and writable
+    li s11, 3
+    bne t1, zero, fail
+    li t1, 99
+    sb t1, 0(t0)
+
+    # a mapping just after it, then grow: it has to move
+    li t0, 0x4000
+    add a0, s0, t0
+    li a1, 0x1000
+    li a2, 3
+    li a3, 0x32                 # MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED
+    li a4, -1
+    li a5, 0
+    li a7, 222
+    ecall
+    li t0, 0x4000
+    add t0, s0, t0
+    li s11, 4
+    bne a0, t0, fail
+
+    mv a0, s0
+    li a1, 0x4000
+    li a2, 0x8000
+    li a3, 1                    # MREMAP_MAYMOVE
+    li a7, 216
+    ecall
+    mv s2, a0
+    li s11, 5
+    beq s2, s0, fail
+    li t0, -4096
+    bgeu s2, t0, fail
+    lbu t0, 0(s2)
+    li t1, 77
+    li s11, 6
+    bne t0, t1, fail
+    li t0, 0x3fff
+    add t0, s2, t0
+    lbu t0, 0(t0)
+    li t1, 99
+    li s11, 7
+    bne t0, t1, fail
+
+    li s4, 0
+    lbu t0, 0(s0)               # the old range is unmapped, load access fault
+    li t0, 5
+    li s11, 8
+    bne s4, t0, fail
+
+    li s11, 0
+    j fail
+
+# records mcause in s4, resumes after the fault
+handler:
+    csrrs s4, 0x342, zero
+    csrrs t0, 0x341, zero
+    addi t0, t0, 4
+    csrrw zero, 0x341, t0
+    mret
@@ -0,0 +1,94 @@
+# munmap of the program and of the heap unmaps their pages without handing
+# them out to mmap again, and brk does not grow over the heap pages unmapped
+    la t0, handler
+    csrrw zero, 0x305, t0
+
+    li a0, 0
+    li a7, 214                  # brk
+    ecall
+    mv s0, a0
+    li t0, 0x10000
+    add a0, s0, t0
+    li a7, 214
+    ecall
+    li t0, 0x10000
+    add s2, s0, t0              # break
+    li s11, 1
+    bne a0, s2, fail
+
+    # the second half of the heap below the break
+    li t0, 0x8000
+    add t0, s0, t0
+    li t1, 4095
+    add t0, t0, t1
+    srli t0, t0, 12
+    slli s1, t0, 12
+    mv a0, s1
+    sub a1, s2, s1
+    li a7, 215                  # munmap
+    ecall
+    li s11, 2
+    bne a0, zero, fail
+
+    li s4, 0
+    lb t0, 0(s1)                # unmapped, load access fault
+    li t0, 5
+    li s11, 3
+    bne s4, t0, fail
+
+    li t0, 0x20000
+    add a0, s0, t0
+    li a7, 214                  # refused, the break stays
+    ecall
+    li s11, 4
+    bne a0, s2, fail
+
+    mv a0, s1                   # the hint is not free
+    li a1, 0x1000
+    li a2, 3
+    li a3, 0x22                 # MAP_PRIVATE | MAP_ANONYMOUS
+    li a4, -1
+    li a5, 0
+    li a7, 222                  # mmap
+    ecall
+    li s11, 5
+    beq a0, s1, fail
+
+    # the last page of the program
+    la t0, end
+    li t1, 4095
+    add t0, t0, t1
+    srli t0, t0, 12
+    slli s3, t0, 12
+    mv a0, s3
+    li a1, 0x1000
+    li a7, 215
+    ecall
+    li s11, 6
+    bne a0, zero, fail
+
+    mv a0, s3
+    li a1, 0x1000
+    li a2, 3
+    li a3, 0x22
+    li a4, -1
+    li a5, 0
+    li a7, 222
+    ecall
+    li s11, 7
+    beq a0, s3, fail
+
+    li s11, 0
+fail:
+    mv a0, s11
+    li a7, 93
+    ecall
+
+# records mcause in s4, resumes after the fault
+handler:
+    csrrs s4, 0x342, zero
+    csrrs t0, 0x341, zero
+    addi t0, t0, 4
+    csrrw zero, 0x341, t0
+    mret
+end:
@@ -0,0 +1,34 @@
+# Record and replay: test.py runs it with --record and some input, then with
+# --replay and none. The replayed guest must read the recorded input and the
+# recorded time, and write them out as the recorded run did
+    addi sp, sp, -32
+    li a0, 0
+    mv a1, sp
+    li a2, 8
+    li a7, 63                   # read
+    ecall
+    mv a2, a0
+    blt a2, zero, fail
+    li a0, 1
+    mv a1, sp
+    li a7, 64                   # write, what was read
+    ecall
+
+    li a0, 1                    # CLOCK_MONOTONIC
+    addi a1, sp, 16
+    li a7, 113                  # clock_gettime
+    ecall
+    bne a0, zero, fail
+    li a0, 1
+    addi a1, sp, 16
+    li a2, 16
+    li a7, 64                   # write, the time
+    ecall
+
+    li a0, 0
+    li a7, 93
+    ecall
+fail:
+    li a0, 1
+    li a7, 93
+    ecall
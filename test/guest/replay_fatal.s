@@ -0,0 +1,26 @@
+# Record and replay of a failing run: with some input it writes it out and
+# ends in an unimplemented syscall, test.py records it and expects the replay
+# to fail the same way. Without input it exits with 0
+    addi sp, sp, -16
+    li a0, 0
+    mv a1, sp
+    li a2, 8
+    li a7, 63                   # read
+    ecall
+    mv a2, a0
+    blt a2, zero, fail
+    beq a2, zero, pass
+    li a0, 1
+    mv a1, sp
+    li a7, 64                   # write, what was read
+    ecall
+    li a7, 172                  # getpid, unimplemented
+    ecall
+fail:
+    li a0, 1
+    li a7, 93
+    ecall
+pass:
+    li a0, 0
+    li a7, 93
+    ecall
@@ -0,0 +1,25 @@
+# Negative immediates of the compressed instructions are sign extended.
+# rvasm has no RVC, the pairs of 2 bytes instructions are given as words
+    li s2, 1
+    .word 0x1541557d            # c.li a0, -1; c.addi a0, -16
+    li t0, -17
+    bne a0, t0, fail
+
+    li s2, 2
+    .word 0x000175fd            # c.lui a1, 0xfffff; c.nop
+    li t0, -4096
+    bne a1, t0, fail
+
+    li s2, 3
+    mv s0, sp
+    .word 0x0001717d            # c.addi16sp sp, -16; c.nop
+    sub t0, s0, sp
+    li t1, 16
+    bne t0, t1, fail
+    mv sp, s0
+
+    li s2, 0
+fail:
+    mv a0, s2
+    li a7, 93
+    ecall
@@ -0,0 +1,79 @@
+# The structs and paths the emulator copies itself fail with EFAULT when the
+# guest has not mapped them, like the buffers the host kernel reads
+    li s0, 0x1000               # not mapped, below the program
+    li s3, -14                  # EFAULT
+    addi sp, sp, -128
+
+    li a0, 1
+    mv a1, s0
+    li a7, 80                   # fstat, to an unmapped stat
+    ecall
+    li s2, 1
+    bne a0, s3, fail
+
+    li a0, -100                 # AT_FDCWD
+    mv a1, s0
+    mv a2, sp
+    li a3, 0
+    li a7, 79                   # fstatat, from an unmapped path
+    ecall
+    li s2, 2
+    bne a0, s3, fail
+
+    li a0, -100
+    la a1, dot
+    mv a2, s0
+    li a3, 0
+    li a7, 79                   # fstatat, to an unmapped stat
+    ecall
+    li s2, 3
+    bne a0, s3, fail
+
+    li a0, -100
+    la a1, dot
+    mv a2, sp
+    li a3, 0
+    li a7, 79                   # fstatat, mapped
+    ecall
+    li s2, 4
+    bne a0, zero, fail
+
+    li a0, 1                    # CLOCK_MONOTONIC
+    mv a1, s0
+    li a7, 113                  # clock_gettime
+    ecall
+    li s2, 5
+    bne a0, s3, fail
+
+    mv a0, s0
+    li a1, 0
+    li a7, 169                  # gettimeofday
+    ecall
+    li s2, 6
+    bne a0, s3, fail
+
+    li a0, 1
+    mv a1, s0
+    li a2, 1
+    li a7, 66                   # writev, from an unmapped iovec
+    ecall
+    li s2, 7
+    bne a0, s3, fail
+
+    li a0, -100
+    mv a1, s0
+    li a2, 0
+    li a3, 0
+    li a7, 56                   # openat, from an unmapped path
+    ecall
+    li s2, 8
+    bne a0, s3, fail
+
+    li s2, 0
+fail:
+    mv a0, s2
+    li a7, 93
+    ecall
+
+dot:
+    .dword 0x2e                 # .
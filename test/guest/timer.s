@@ -0,0 +1,28 @@
+# Without --icount the time CSR reads 0 in every run, and mip.STIP is not
+# pending until the guest arms the timer by writing stimecmp
+    li s0, 1
+    csrrs t0, 0xC01, zero       # time
+    bne t0, zero, fail
+    li s0, 2
+    li t1, 0x20                 # STIP
+    csrrs t0, 0x344, zero       # mip
+    and t0, t0, t1
+    bne t0, zero, fail
+
+    li s0, 3
+    li t2, 100
+    csrrw zero, 0x14D, t2       # stimecmp in the future
+    csrrs t0, 0x344, zero
+    and t0, t0, t1
+    bne t0, zero, fail
+    li s0, 4
+    csrrw zero, 0x14D, zero     # stimecmp reached
+    csrrs t0, 0x344, zero
+    and t0, t0, t1
+    beq t0, zero, fail
+
+    li s0, 0
+fail:
+    mv a0, s0
+    li a7, 93
+    ecall
@@ -0,0 +1,42 @@
+# Addresses above 4 GiB wrap around the guest window: a pointer at 8 GiB and
+# a non-canonical one raise load access faults on the unmapped page below the
+# program instead of reaching host memory
+    la t0, handler
+    csrrw zero, 0x305, t0
+    li t1, 1
+    slli t1, t1, 33
+    addi t1, t1, 0x100          # 8 GiB + 0x100
+    li s1, 0
+high:
+    ld a0, 0(t1)
+    li a0, 1
+    li t0, 5                    # load access fault
+    bne s1, t0, fail
+    la t0, high
+    bne s3, t0, fail
+
+    li t1, 1
+    slli t1, t1, 63
+    addi t1, t1, 0x100          # non-canonical
+    li s1, 0
+noncanonical:
+    sw a0, 0(t1)
+    li a0, 2
+    li t0, 7                    # store access fault
+    bne s1, t0, fail
+    la t0, noncanonical
+    bne s3, t0, fail
+
+    li a0, 0
+fail:
+    li a7, 93
+    ecall
+
+# records mcause, mtval and mepc in s1, s2 and s3, resumes after the fault
+handler:
+    csrrs s1, 0x342, zero
+    csrrs s2, 0x343, zero
+    csrrs s3, 0x341, zero
+    addi t0, s3, 4
+    csrrw zero, 0x341, t0
+    mret
@@ -0,0 +1,69 @@
+# Writes from memory the guest has not mapped fail with EFAULT, to the console
+# and to a file queued by --io-uring alike, and do not move the file position
+    li s0, 0x1000               # not mapped, below the program
+
+    li a0, 1
+    mv a1, s0
+    li a2, 5
+    li a7, 64                   # write
+    ecall
+    li t0, -14                  # EFAULT
+    li s2, 1
+    bne a0, t0, fail
+
+    li a0, -100                 # AT_FDCWD
+    la a1, path
+    li a2, 0x241                # O_WRONLY | O_CREAT | O_TRUNC
+    li a3, 420
+    li a7, 56                   # openat
+    ecall
+    mv s1, a0
+    li s2, 2
+    blt s1, zero, fail
+
+    mv a0, s1
+    mv a1, s0
+    li a2, 5
+    li a7, 64
+    ecall
+    li t0, -14
+    li s2, 3
+    bne a0, t0, fail
+
+    mv a0, s1
+    la a1, msg
+    li a2, 3
+    li a7, 64
+    ecall
+    li t0, 3
+    li s2, 4
+    bne a0, t0, fail
+
+    mv a0, s1                   # would be appended to the queued write
+    mv a1, s0
+    li a2, 5
+    li a7, 64
+    ecall
+    li t0, -14
+    li s2, 5
+    bne a0, t0, fail
+
+    mv a0, s1
+    li a1, 0
+    li a2, 1                    # SEEK_CUR
+    li a7, 62                   # lseek
+    ecall
+    li t0, 3
+    li s2, 6
+    bne a0, t0, fail
+
+    li s2, 0
+fail:
+    mv a0, s2
+    li a7, 93
+    ecall
+
+msg:
+    .dword 0x636261             # abc
+path:
+    .dword 0x7478742e74756f     # out.txt
@@ -0,0 +1,48 @@
+# Loads to register zero still access memory: they fault like any other load
+# and do not become nop
+    la t0, handler
+    csrrw zero, 0x305, t0
+    li t1, 0x1000               # not mapped, below the program
+    li s1, 0
+load_w:
+    lw zero, 0(t1)
+    li a0, 1
+    li t0, 5                    # load access fault
+    bne s1, t0, fail
+    bne s2, t1, fail
+    la t0, load_w
+    bne s3, t0, fail
+
+    li s1, 0
+    addi t2, t1, 16
+load_bu:
+    lbu x0, 0(t2)
+    li a0, 2
+    li t0, 5
+    bne s1, t0, fail
+    bne s2, t2, fail
+    la t0, load_bu
+    bne s3, t0, fail
+
+    la t0, data                 # mapped, nothing to trap
+    li s1, 0
+    ld zero, 0(t0)
+    li a0, 3
+    bne s1, zero, fail
+
+    li a0, 0
+fail:
+    li a7, 93
+    ecall
+
+# records mcause, mtval and mepc in s1, s2 and s3, resumes after the fault
+handler:
+    csrrs s1, 0x342, zero
+    csrrs s2, 0x343, zero
+    csrrs s3, 0x341, zero
+    addi t0, s3, 4
+    csrrw zero, 0x341, t0
+    mret
+
+data:
+    .dword 0
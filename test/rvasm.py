@@ -0,0 +1,197 @@
+#!/usr/bin/python3
+# Minimal RV64 assembler for the guest program tests of test.py
+#
+#   rvasm.py program.s program.elf
+#
+# Knows the base integer instructions, the M extension, the CSR instructions,
+# mret, fence.i and sfence.vma, the pseudo instructions li (32 bits signed),
+# la, j, mv and nop, and the directives .word, .dword and .zero. The program
+# is linked as a single RWX segment at BASE with BSS bytes of zeroes after it,
+# its entry is its first instruction.
+
+import re
+import struct
+import sys
+
+BASE = 0x10000
+BSS = 0x10000
+
+REGS = "zero ra sp gp tp t0 t1 t2 s0 s1 a0 a1 a2 a3 a4 a5 a6 a7 s2 s3 s4 s5 s6 s7 s8 s9 s10 s11 t3 t4 t5 t6".split()
+REG = {name: i for i, name in enumerate(REGS)}
+REG.update({"x{}".format(i): i for i in range(32)})
+REG["fp"] = 8
+
+# funct3, funct7
+ALU = {"add": (0, 0), "sub": (0, 0x20), "sll": (1, 0), "slt": (2, 0), "sltu": (3, 0), "xor": (4, 0),
+       "srl": (5, 0), "sra": (5, 0x20), "or": (6, 0), "and": (7, 0),
+       "mul": (0, 1), "mulh": (1, 1), "mulhsu": (2, 1), "mulhu": (3, 1),
+       "div": (4, 1), "divu": (5, 1), "rem": (6, 1), "remu": (7, 1)}
+ALUW = {"addw": (0, 0), "subw": (0, 0x20), "sllw": (1, 0), "srlw": (5, 0), "sraw": (5, 0x20),
+        "mulw": (0, 1), "divw": (4, 1), "divuw": (5, 1), "remw": (6, 1), "remuw": (7, 1)}
+ALUI = {"addi": 0, "slti": 2, "sltiu": 3, "xori": 4, "ori": 6, "andi": 7}
+# funct3, imm[11:6]
+SHIFT = {"slli": (1, 0), "srli": (5, 0), "srai": (5, 0x10)}
+LOAD = {"lb": 0, "lh": 1, "lw": 2, "ld": 3, "lbu": 4, "lhu": 5, "lwu": 6}
+STORE = {"sb": 0, "sh": 1, "sw": 2, "sd": 3}
+BRANCH = {"beq": 0, "bne": 1, "blt": 4, "bge": 5, "bltu": 6, "bgeu": 7}
+CSR = {"csrrw": 1, "csrrs": 2, "csrrc": 3, "csrrwi": 5, "csrrsi": 6, "csrrci": 7}
+FIXED = {"ecall": 0x00000073, "ebreak": 0x00100073, "mret": 0x30200073,
+         "fence": 0x0ff0000f, "fence.i": 0x0000100f, "sfence.vma": 0x12000073, "nop": 0x00000013}
+
+
+def r_type(opcode, funct3, funct7, rd, rs1, rs2):
+    return funct7 << 25 | rs2 << 20 | rs1 << 15 | funct3 << 12 | rd << 7 | opcode
+
+
+def i_type(opcode, funct3, rd, rs1, imm):
+    return (imm & 0xFFF) << 20 | rs1 << 15 | funct3 << 12 | rd << 7 | opcode
+
+
+def s_type(funct3, rs1, rs2, imm):
+    return (imm >> 5 & 0x7F) << 25 | rs2 << 20 | rs1 << 15 | funct3 << 12 | (imm & 0x1F) << 7 | 0x23
+
+
+def b_type(funct3, rs1, rs2, off):
+    return ((off >> 12 & 1) << 31 | (off >> 5 & 0x3F) << 25 | rs2 << 20 | rs1 << 15 | funct3 << 12
+            | (off >> 1 & 0xF) << 8 | (off >> 11 & 1) << 7 | 0x63)
+
+
+def u_type(opcode, rd, imm):
+    return (imm & 0xFFFFF) << 12 | rd << 7 | opcode
+
+
+def j_type(rd, off):
+    return ((off >> 20 & 1) << 31 | (off >> 1 & 0x3FF) << 21 | (off >> 11 & 1) << 20
+            | (off >> 12 & 0xFF) << 12 | rd << 7 | 0x6F)
+
+
+# upper and lower parts of a 32 bits value, for lui/auipc + addi
+def split_imm(value):
+    lo = ((value & 0xFFF) ^ 0x800) - 0x800
+    return (value - lo) >> 12 & 0xFFFFF, lo
+
+
+def size_of(op, args):
+    if op in ("li", "la"):
+        return 8
+    if op == ".dword":
+        return 8
+    if op == ".zero":
+        return int(args[0], 0)
+    return 4
+
+
+def assemble(source):
+    # first pass: the address of every label
+    labels, items, pc = {}, [], BASE
+    for number, line in enumerate(source.splitlines(), 1):
+        line = line.split("#")[0].strip()
+        while ":" in line:
+            label, line = line.split(":", 1)
+            labels[label.strip()] = pc
+            line = line.strip()
+        if not line:
+            continue
+        op, *args = line.replace(",", " ").split()
+        items.append((number, pc, op, args))
+        pc += size_of(op, args)
+
+    def reg(name):
+        return REG[name]
+
+    def imm(text, pc=None):
+        if text in labels:
+            return labels[text] - pc if pc is not None else labels[text]
+        return int(text, 0)
+
+    def mem(text):
+        offset, base = re.match(r"(.*)\((\w+)\)$", text).groups()
+        return int(offset or "0", 0), reg(base)
+
+    code = b""
+    for number, pc, op, a in items:
+        try:
+            if op == ".zero":
+                code += bytes(int(a[0], 0))
+                continue
+            if op == ".dword":
+                code += struct.pack("<Q", imm(a[0]) & (1 << 64) - 1)
+                continue
+            if op in ("li", "la"):
+                value = imm(a[1]) if op == "li" else labels[a[1]] - pc
+                if op == "li" and not -(1 << 31) <= value < 1 << 31:
+                    raise ValueError("li takes a 32 bits signed value")
+                hi, lo = split_imm(value)
+                first = u_type(0x37 if op == "li" else 0x17, reg(a[0]), hi)
+                code += struct.pack("<II", first, i_type(0x13, 0, reg(a[0]), reg(a[0]), lo))
+                continue
+
+            if op in FIXED:
+                word = FIXED[op]
+            elif op == ".word":
+                word = imm(a[0])
+            elif op in ALU:
+                word = r_type(0x33, *ALU[op], reg(a[0]), reg(a[1]), reg(a[2]))
+            elif op in ALUW:
+                word = r_type(0x3B, *ALUW[op], reg(a[0]), reg(a[1]), reg(a[2]))
+            elif op in ALUI:
+                word = i_type(0x13, ALUI[op], reg(a[0]), reg(a[1]), imm(a[2]))
+            elif op == "addiw":
+                word = i_type(0x1B, 0, reg(a[0]), reg(a[1]), imm(a[2]))
+            elif op == "mv":
+                word = i_type(0x13, 0, reg(a[0]), reg(a[1]), 0)
+            elif op in SHIFT:
+                funct3, high = SHIFT[op]
+                word = i_type(0x13, funct3, reg(a[0]), reg(a[1]), high << 6 | imm(a[2]))
+            elif op in LOAD:
+                offset, base = mem(a[1])
+                word = i_type(0x03, LOAD[op], reg(a[0]), base, offset)
+            elif op in STORE:
+                offset, base = mem(a[1])
+                word = s_type(STORE[op], base, reg(a[0]), offset)
+            elif op in BRANCH:
+                word = b_type(BRANCH[op], reg(a[0]), reg(a[1]), imm(a[2], pc))
+            elif op == "lui":
+                word = u_type(0x37, reg(a[0]), imm(a[1]))
+            elif op == "auipc":
+                word = u_type(0x17, reg(a[0]), imm(a[1]))
+            elif op == "jal":
+                word = j_type(reg(a[0]), imm(a[1], pc))
+            elif op == "j":
+                word = j_type(0, imm(a[0], pc))
+            elif op == "jalr":
+                offset, base = mem(a[1])
+                word = i_type(0x67, 0, reg(a[0]), base, offset)
+            elif op in CSR:
+                source = int(a[2], 0) if op.endswith("i") else reg(a[2])
+                word = i_type(0x73, CSR[op], reg(a[0]), source, imm(a[1]))
+            else:
+                raise ValueError("unknown instruction " + op)
+        except (KeyError, ValueError, AttributeError, IndexError) as error:
+            raise SystemExit("line {}: {}: {}".format(number, op, error))
+        code += struct.pack("<I", word & 0xFFFFFFFF)
+    return code
+
+
+def elf(code):
+    ehdr_size, phdr_size, offset = 64, 56, 0x1000
+    ident = b"\x7fELF" + bytes([2, 1, 1]) + bytes(9)
+    ehdr = ident + struct.pack("<HHIQQQIHHHHHH", 2, 0xF3, 1, BASE, ehdr_size, 0, 0,
+                               ehdr_size, phdr_size, 1, 64, 0, 0)
+    # PT_LOAD, RWX
+    phdr = struct.pack("<IIQQQQQQ", 1, 7, offset, BASE, BASE, len(code), len(code) + BSS, 0x1000)
+    headers = ehdr + phdr
+    return headers + bytes(offset - len(headers)) + code
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit("usage: rvasm.py program.s program.elf")
+    with open(sys.argv[1]) as source:
+        code = assemble(source.read())
+    with open(sys.argv[2], "wb") as out:
+        out.write(elf(code))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,383 @@
+#include "decode.c"
+
+/**
+ * Differential test of the decoder
+ *
+ * Decodes every 16 bits word and random 32 bits words, most of them valid
+ * encodings of insts.spec, with the decoder generated from the spec and with
+ * the hand written decoder it replaced (test/decode_ref.c), and compares the
+ * fields. The bugs of the reference the generated decoder fixed, and the
+ * instructions changed since, are the only differences allowed: test_known
+ * lists the encodings of each and the fields they must decode to, taken from
+ * the spec rather than from the reference where it was wrong.
+ *
+ *   test_decode
+ */
+
+#define TEST_RANDOM     (1 << 21)   // random words decoded
+#define TEST_REPORTED   20          // differences printed
+
+void ref_decode(inst_t *inst, u32 raw_inst);
+
+static const char *const test_names[] = {
+    #define OP(name) #name,
+    #include "ops.h"
+    #undef OP
+};
+
+static u64 rng = 0x9E3779B97F4A7C15ULL;
+
+static u64 test_rand() {
+    rng ^= rng << 13;
+    rng ^= rng >> 7;
+    rng ^= rng << 17;
+    return rng;
+}
+
+// way back from fatalf while a decoder runs, NULL otherwise
+static sigjmp_buf *test_jmp;
+
+void fatal_exit() {
+    if (test_jmp) siglongjmp(*test_jmp, 1);
+    exit(1);
+}
+
+static void test_fields(inst_t *inst, u32 raw) {
+    *inst = (inst_t) {0};
+    inst_decode_fields(inst, raw);
+}
+
+/**
+ * @brief decode with one of the decoders, an invalid encoding is not fatal
+ *
+ * @param decode    decoder
+ * @param inst      instruction struct
+ * @param raw       raw instruction
+ * @return true     raw is valid
+ */
+static bool test_run(void (*decode)(inst_t *, u32), inst_t *inst, u32 raw) {
+    sigjmp_buf jmp;
+    if (sigsetjmp(jmp, 0)) {
+        test_jmp = NULL;
+        return false;
+    }
+    test_jmp = &jmp;
+    decode(inst, raw);
+    test_jmp = NULL;
+    return true;
+}
+
+static bool test_same(inst_t *a, inst_t *b) {
+    return a->type == b->type && a->rd == b->rd && a->rs1 == b->rs1 && a->rs2 == b->rs2 &&
+           a->rs3 == b->rs3 && a->imm == b->imm && a->rvc == b->rvc && a->cont == b->cont && a->fused == b->fused;
+}
+
+// what the generated decoder must do with the encodings of a test_known_t
+enum {
+    TEST_SAME,          // the same as the reference
+    TEST_RESERVED,      // reject them, whatever the reference did
+    TEST_FIELDS,        // decode them to the fields of the entry
+};
+
+// where an expected field comes from
+enum {
+    TEST_REF,           // the reference, it must have accepted the encoding
+    TEST_ZERO,
+    TEST_ONE,
+    TEST_RD,            // bits 11:7, also the full register of the RVC forms
+    TEST_RS1,           // bits 19:15
+    TEST_RS2,           // bits 24:20
+    TEST_CRS2,          // bits 6:2, rs2 of the CR forms
+    TEST_CRS1_,         // x8 + bits 9:7, rs1' and rd' of the CB and CA forms
+    TEST_CRS2_,         // x8 + bits 4:2, rs2' and rd' of the CIW, CL and CS forms
+    TEST_IMM_I,         // imm[11:0] of the I format
+    TEST_IMM_CI,        // imm[5|4:0] of the CI format, sign extended
+    TEST_IMM_CI_SH,     // the same, zero extended, the shift amount of c.slli and c.srli
+    TEST_IMM_CLUI,      // the CI immediate of c.lui, imm[17|16:12]
+    TEST_IMM_C16SP,     // imm[9|4|6|8:7|5] of c.addi16sp
+    TEST_IMM_LWSP,      // offset[5|4:2|7:6] of c.lwsp
+    TEST_IMM_LDSP,      // offset[5|4:3|8:6] of c.ldsp
+    TEST_IMM_CB,        // offset[8|4:3|7:6|2:1|5] of c.beqz and c.bnez
+    TEST_IMM_CJ,        // offset[11|4|9:8|10|6|7|3:1|5] of c.j
+};
+
+// encodings the decoders differ on, and what the generated one must do
+typedef struct {
+    u32 mask;
+    u32 match;
+    u8 how;             // TEST_SAME, TEST_RESERVED or TEST_FIELDS
+    u8 type;            // enum inst_type_t of TEST_FIELDS
+    u8 rd, rs1, rs2, imm, cont;
+} test_known_t;
+
+#define TEST_R(mask, match, name) \
+    {mask, match, TEST_FIELDS, inst_##name, TEST_RD, TEST_RS1, TEST_RS2, TEST_ZERO, TEST_ZERO}
+
+/**
+ * The bugs of the reference the generated decoder fixed, and the later
+ * changes, the first entry matching an encoding applies. Encodings no entry
+ * matches must decode as with the reference.
+ */
+static const test_known_t test_known[] = {
+    // the M extension, the reference knew mul and mulw only, ran the others
+    // with funct3 0x1-0x4, 0x6 and 0x7 as the base op of their funct3 and
+    // rejected the others: all are checked against the spec
+    TEST_R(0xfe00707f, 0x02000033, mul),
+    TEST_R(0xfe00707f, 0x02001033, mulh),
+    TEST_R(0xfe00707f, 0x02002033, mulhsu),
+    TEST_R(0xfe00707f, 0x02003033, mulhu),
+    TEST_R(0xfe00707f, 0x02004033, div),
+    TEST_R(0xfe00707f, 0x02005033, divu),
+    TEST_R(0xfe00707f, 0x02006033, rem),
+    TEST_R(0xfe00707f, 0x02007033, remu),
+    TEST_R(0xfe00707f, 0x0200003b, mulw),
+    TEST_R(0xfe00707f, 0x0200403b, divw),
+    TEST_R(0xfe00707f, 0x0200503b, divuw),
+    TEST_R(0xfe00707f, 0x0200603b, remw),
+    TEST_R(0xfe00707f, 0x0200703b, remuw),
+
+    // OP and OP-32, the reference ignored funct7 of the ops without a
+    // funct7 variant, the other values are reserved
+    {0xfe00007f, 0x00000033, TEST_SAME},
+    {0xfe00707f, 0x40000033, TEST_SAME},        // sub
+    {0xfe00707f, 0x40005033, TEST_SAME},        // sra
+    {0x0000007f, 0x00000033, TEST_RESERVED},
+    {0xfe00007f, 0x0000003b, TEST_SAME},
+    {0xfe00707f, 0x4000003b, TEST_SAME},        // subw
+    {0xfe00707f, 0x4000503b, TEST_SAME},        // sraw
+    {0x0000007f, 0x0000003b, TEST_RESERVED},
+
+    // RV64 srli and srai by 32 or more, which the reference rejected, and
+    // the reserved high immediate bits of the shifts, which it ignored
+    {0xfe00707f, 0x02005013, TEST_FIELDS, inst_srli, TEST_RD, TEST_RS1, TEST_ZERO, TEST_IMM_I, TEST_ZERO},
+    {0xfe00707f, 0x42005013, TEST_FIELDS, inst_srai, TEST_RD, TEST_RS1, TEST_ZERO, TEST_IMM_I, TEST_ZERO},
+    {0xfc00707f, 0x00001013, TEST_SAME},        // slli
+    {0xfc00707f, 0x00005013, TEST_SAME},        // srli
+    {0xfc00707f, 0x40005013, TEST_SAME},        // srai
+    {0x0000707f, 0x00001013, TEST_RESERVED},
+    {0x0000707f, 0x00005013, TEST_RESERVED},
+    {0xfe00707f, 0x0000101b, TEST_SAME},        // slliw
+    {0x0000707f, 0x0000101b, TEST_RESERVED},
+
+    // jalr with a funct3, which the reference ignored
+    {0x0000707f, 0x00000067, TEST_SAME},
+    {0x0000007f, 0x00000067, TEST_RESERVED},
+
+    // fsqrt with an rs2, which the reference ignored
+    {0xfff0007f, 0x58000053, TEST_SAME},
+    {0xfff0007f, 0x5a000053, TEST_SAME},
+    {0xfe00007f, 0x58000053, TEST_RESERVED},
+    {0xfe00007f, 0x5a000053, TEST_RESERVED},
+
+    // LOAD-FP and STORE-FP of another width, which fell through to the
+    // cases of the next opcode of the reference
+    {0x0000707f, 0x00002007, TEST_SAME},        // flw
+    {0x0000707f, 0x00003007, TEST_SAME},        // fld
+    {0x0000007f, 0x00000007, TEST_RESERVED},
+    {0x0000707f, 0x00002027, TEST_SAME},        // fsw
+    {0x0000707f, 0x00003027, TEST_SAME},        // fsd
+    {0x0000007f, 0x00000027, TEST_RESERVED},
+
+    // SYSTEM, the reference ignored the fields of ecall and ebreak and did
+    // not know sfence.vma, which came with the Sv39 translation, as did the
+    // end of the block after the Zicsr instructions
+    {0xffffffff, 0x00000073, TEST_SAME},        // ecall
+    {0xffffffff, 0x00100073, TEST_SAME},        // ebreak
+    {0xffffffff, 0x30200073, TEST_SAME},        // mret
+    {0xfe007fff, 0x12000073, TEST_FIELDS, inst_sfence_vma, TEST_ZERO, TEST_RS1, TEST_RS2, TEST_ZERO, TEST_ONE},
+    {0x0000707f, 0x00000073, TEST_RESERVED},
+    {0x0000707f, 0x00001073, TEST_FIELDS, inst_csrrw, .cont = TEST_ONE},
+    {0x0000707f, 0x00002073, TEST_FIELDS, inst_csrrs, .cont = TEST_ONE},
+    {0x0000707f, 0x00003073, TEST_FIELDS, inst_csrrc, .cont = TEST_ONE},
+    {0x0000707f, 0x00005073, TEST_FIELDS, inst_csrrwi, .cont = TEST_ONE},
+    {0x0000707f, 0x00006073, TEST_FIELDS, inst_csrrsi, .cont = TEST_ONE},
+    {0x0000707f, 0x00007073, TEST_FIELDS, inst_csrrci, .cont = TEST_ONE},
+
+    // RVC, the reference numbered the 3 bits registers from x0 instead of
+    // x8, took rd' of c.srli, c.srai, c.andi and the CA forms from the bits
+    // of rs2', left zero rs1 or rd of the forms where both are the same
+    // register, and did not sign extend the immediates
+    {0xffe3, 0x0000, TEST_RESERVED},            // c.addi4spn with a zero immediate
+    {0xe003, 0x0000, TEST_FIELDS, inst_caddi4spn, .rd = TEST_CRS2_},
+    {0xe003, 0x4000, TEST_FIELDS, inst_clw, .rd = TEST_CRS2_, .rs1 = TEST_CRS1_},
+    {0xe003, 0x6000, TEST_FIELDS, inst_cld, .rd = TEST_CRS2_, .rs1 = TEST_CRS1_},
+    {0xe003, 0xc000, TEST_FIELDS, inst_csw, .rs1 = TEST_CRS1_, .rs2 = TEST_CRS2_},
+    {0xe003, 0xe000, TEST_FIELDS, inst_csd, .rs1 = TEST_CRS1_, .rs2 = TEST_CRS2_},
+    {0xe003, 0xa001, TEST_FIELDS, inst_cj, TEST_ZERO, TEST_ZERO, TEST_ZERO, TEST_IMM_CJ, TEST_ONE},
+    {0xe003, 0xc001, TEST_FIELDS, inst_cbeqz, TEST_ZERO, TEST_CRS1_, TEST_ZERO, TEST_IMM_CB, TEST_ONE},
+    {0xe003, 0xe001, TEST_FIELDS, inst_cbnez, TEST_ZERO, TEST_CRS1_, TEST_ZERO, TEST_IMM_CB, TEST_ONE},
+    {0xec03, 0x8801, TEST_FIELDS, inst_candi, TEST_CRS1_, TEST_CRS1_, TEST_ZERO, TEST_IMM_CI, TEST_ZERO},
+    {0xfc63, 0x8c01, TEST_FIELDS, inst_csub, .rd = TEST_CRS1_, .rs1 = TEST_CRS1_, .rs2 = TEST_CRS2_},
+    {0xfc63, 0x8c21, TEST_FIELDS, inst_cxor, .rd = TEST_CRS1_, .rs1 = TEST_CRS1_, .rs2 = TEST_CRS2_},
+    {0xfc63, 0x8c41, TEST_FIELDS, inst_cor, .rd = TEST_CRS1_, .rs1 = TEST_CRS1_, .rs2 = TEST_CRS2_},
+    {0xfc63, 0x8c61, TEST_FIELDS, inst_cand, .rd = TEST_CRS1_, .rs1 = TEST_CRS1_, .rs2 = TEST_CRS2_},
+    {0xfc63, 0x9c01, TEST_FIELDS, inst_csubw, .rd = TEST_CRS1_, .rs1 = TEST_CRS1_, .rs2 = TEST_CRS2_},
+    {0xfc63, 0x9c21, TEST_FIELDS, inst_caddw, .rd = TEST_CRS1_, .rs1 = TEST_CRS1_, .rs2 = TEST_CRS2_},
+
+    // the RVC HINTs and the encodings writing x0, which the reference
+    // rejected and inst_specialise turns into nop or a load dropping its
+    // value, c.ebreak, which it rejected too, and the x0 of the other forms
+    {0xef83, 0x0001, TEST_FIELDS, inst_cnop, TEST_ZERO, TEST_ZERO, TEST_ZERO, TEST_ZERO, TEST_ZERO},
+    {0xe003, 0x0001, TEST_FIELDS, inst_caddi, TEST_RD, TEST_RD, TEST_ZERO, TEST_IMM_CI, TEST_ZERO},
+    {0xe003, 0x2001, TEST_FIELDS, inst_caddiw, TEST_RD, TEST_RD, TEST_ZERO, TEST_IMM_CI, TEST_ZERO},
+    {0xe003, 0x4001, TEST_FIELDS, inst_cli, TEST_RD, TEST_RD, TEST_ZERO, TEST_IMM_CI, TEST_ZERO},
+    // c.addi16sp names sp in its handler
+    {0xef83, 0x6101, TEST_FIELDS, inst_caddi16sp, TEST_ZERO, TEST_ZERO, TEST_ZERO, TEST_IMM_C16SP, TEST_ZERO},
+    {0xe003, 0x6001, TEST_FIELDS, inst_clui, TEST_RD, TEST_ZERO, TEST_ZERO, TEST_IMM_CLUI, TEST_ZERO},
+    {0xec03, 0x8001, TEST_FIELDS, inst_csrli, TEST_CRS1_, TEST_CRS1_, TEST_ZERO, TEST_IMM_CI_SH, TEST_ZERO},
+    {0xec03, 0x8401, TEST_FIELDS, inst_csrai, TEST_CRS1_, TEST_CRS1_, TEST_ZERO, TEST_IMM_CI_SH, TEST_ZERO},
+    {0xe003, 0x0002, TEST_FIELDS, inst_cslli, TEST_RD, TEST_RD, TEST_ZERO, TEST_IMM_CI_SH, TEST_ZERO},
+    {0xef83, 0x4002, TEST_FIELDS, inst_clwsp, TEST_ZERO, TEST_ZERO, TEST_ZERO, TEST_IMM_LWSP, TEST_ZERO},
+    {0xef83, 0x6002, TEST_FIELDS, inst_cldsp, TEST_ZERO, TEST_ZERO, TEST_ZERO, TEST_IMM_LDSP, TEST_ZERO},
+    {0xf07f, 0x8002, TEST_FIELDS, inst_cjr, TEST_RD, TEST_RD, TEST_ZERO, TEST_ZERO, TEST_ONE},
+    {0xf003, 0x8002, TEST_FIELDS, inst_cmv, TEST_RD, TEST_RD, TEST_CRS2, TEST_ZERO, TEST_ZERO},
+    {0xffff, 0x9002, TEST_FIELDS, inst_ebreak, TEST_ZERO, TEST_ZERO, TEST_ZERO, TEST_ZERO, TEST_ONE},
+    {0xf07f, 0x9002, TEST_FIELDS, inst_cjalr, TEST_RD, TEST_RD, TEST_ZERO, TEST_ZERO, TEST_ONE},
+    {0xf003, 0x9002, TEST_FIELDS, inst_cadd, TEST_RD, TEST_RD, TEST_CRS2, TEST_ZERO, TEST_ZERO},
+};
+
+// bits hi to lo of raw
+#define TEST_BITS(hi, lo) ((i64) (raw >> (lo)) & ((1 << ((hi) - (lo) + 1)) - 1))
+
+/**
+ * @brief an expected field of an encoding
+ *
+ * @param source    TEST_* source of the field
+ * @param raw       raw instruction
+ * @param ref       the field as the reference decoded it, -1 if it rejected raw
+ * @return i64      the field, -1 if it comes from a reference that rejected raw
+ */
+static i64 test_field(u8 source, u32 raw, i64 ref) {
+    switch (source) {
+        case TEST_REF: return ref;
+        case TEST_ZERO: return 0;
+        case TEST_ONE: return 1;
+        case TEST_RD: return (raw >> 7) & 0x1f;
+        case TEST_RS1: return (raw >> 15) & 0x1f;
+        case TEST_RS2: return (raw >> 20) & 0x1f;
+        case TEST_CRS2: return (raw >> 2) & 0x1f;
+        case TEST_CRS1_: return 8 + ((raw >> 7) & 0x7);
+        case TEST_CRS2_: return 8 + ((raw >> 2) & 0x7);
+        case TEST_IMM_I: return (i32) raw >> 20;
+        case TEST_IMM_CI: return -(TEST_BITS(12, 12) << 5) | TEST_BITS(6, 2);
+        case TEST_IMM_CI_SH: return TEST_BITS(12, 12) << 5 | TEST_BITS(6, 2);
+        case TEST_IMM_CLUI: return test_field(TEST_IMM_CI, raw, ref) * 4096;
+        case TEST_IMM_C16SP:
+            return -(TEST_BITS(12, 12) << 9) | TEST_BITS(6, 6) << 4 | TEST_BITS(5, 5) << 6 |
+                   TEST_BITS(4, 3) << 7 | TEST_BITS(2, 2) << 5;
+        case TEST_IMM_LWSP: return TEST_BITS(12, 12) << 5 | TEST_BITS(6, 4) << 2 | TEST_BITS(3, 2) << 6;
+        case TEST_IMM_LDSP: return TEST_BITS(12, 12) << 5 | TEST_BITS(6, 5) << 3 | TEST_BITS(4, 2) << 6;
+        case TEST_IMM_CB:
+            return -(TEST_BITS(12, 12) << 8) | TEST_BITS(11, 10) << 3 | TEST_BITS(6, 5) << 6 |
+                   TEST_BITS(4, 3) << 1 | TEST_BITS(2, 2) << 5;
+        case TEST_IMM_CJ:
+            return -(TEST_BITS(12, 12) << 11) | TEST_BITS(11, 11) << 4 | TEST_BITS(10, 9) << 8 |
+                   TEST_BITS(8, 8) << 10 | TEST_BITS(7, 7) << 6 | TEST_BITS(6, 6) << 7 |
+                   TEST_BITS(5, 3) << 1 | TEST_BITS(2, 2) << 5;
+        default: fatalf("unknown field source %u", source);
+    }
+}
+
+/**
+ * @brief what the generated decoder must decode
+ *
+ * @param raw       raw instruction
+ * @param ref       fields of the reference decoder, NULL if raw is invalid
+ * @param expect    expected fields
+ * @param known     set if a test_known entry applies
+ * @return true     raw must be valid
+ */
+static bool test_expect(u32 raw, inst_t *ref, inst_t *expect, bool *known) {
+    const test_known_t *entry = NULL;
+    for (u64 i = 0; i < sizeof(test_known) / sizeof(test_known[0]) && !entry; i++) {
+        if ((raw & test_known[i].mask) == test_known[i].match) entry = &test_known[i];
+    }
+    *known = entry && entry->how != TEST_SAME;
+    if (!entry || entry->how == TEST_SAME) {
+        if (ref) *expect = *ref;
+        return ref;
+    }
+    if (entry->how == TEST_RESERVED) return false;
+
+    i64 rd = test_field(entry->rd, raw, ref ? ref->rd : -1);
+    i64 rs1 = test_field(entry->rs1, raw, ref ? ref->rs1 : -1);
+    i64 rs2 = test_field(entry->rs2, raw, ref ? ref->rs2 : -1);
+    i64 imm = test_field(entry->imm, raw, ref ? ref->imm : -1);
+    i64 cont = test_field(entry->cont, raw, ref ? ref->cont : -1);
+    if (!ref && (entry->rd == TEST_REF || entry->rs1 == TEST_REF || entry->rs2 == TEST_REF ||
+                 entry->imm == TEST_REF || entry->cont == TEST_REF)) {
+        return false;
+    }
+    *expect = (inst_t) {
+        .type = entry->type,
+        .rd = rd,
+        .rs1 = rs1,
+        .rs2 = rs2,
+        .imm = imm,
+        .rvc = (raw & 0x3) != 0x3,
+        .cont = cont,
+    };
+    return true;
+}
+
+static void test_print(const char *what, u32 raw, inst_t *inst) {
+    if (!inst) {
+        printf("  %s 0x%08x: invalid\n", what, raw);
+        return;
+    }
+    printf("  %s 0x%08x: %s rd %u rs1 %u rs2 %u rs3 %u imm %d rvc %u cont %u\n", what, raw,
+           test_names[inst->type], inst->rd, inst->rs1, inst->rs2, inst->rs3, inst->imm, inst->rvc, inst->cont);
+}
+
+int main() {
+    // both decoders report invalid encodings on stderr
+    if (!freopen("/dev/null", "w", stderr)) fatal("can not silence stderr");
+
+    // the 32 bits encodings of the spec, the RVC ones are all tested
+    const decode_entry_t *encodings[sizeof(decode_slots) / sizeof(decode_slots[0]) + sizeof(decode_overflow) / sizeof(decode_overflow[0])];
+    u64 num_encodings = 0;
+    for (u64 i = 0; i < sizeof(decode_slots) / sizeof(decode_slots[0]); i++) {
+        if (decode_slots[i].mask && !decode_slots[i].inst.rvc) encodings[num_encodings++] = &decode_slots[i];
+    }
+    for (u64 i = 1; i < sizeof(decode_overflow) / sizeof(decode_overflow[0]); i++) {
+        if (!decode_overflow[i].inst.rvc) encodings[num_encodings++] = &decode_overflow[i];
+    }
+
+    u64 tested = 0, known = 0, failed = 0;
+    for (u64 i = 0; i < 0x10000 + TEST_RANDOM; i++) {
+        u32 raw;
+        if (i < 0x10000) {
+            raw = i;
+            if ((raw & 0x3) == 0x3) continue;
+        } else {
+            // one in four words is left random, it hits the reserved
+            // encodings of the major opcodes
+            raw = (u32) test_rand() | 0x3;
+            if (i & 0x3) {
+                const decode_entry_t *entry = encodings[test_rand() % num_encodings];
+                raw = (raw & ~entry->mask) | entry->match;
+            }
+        }
+
+        inst_t inst, ref, expect;
+        bool valid = test_run(test_fields, &inst, raw);
+        bool ref_valid = test_run(ref_decode, &ref, raw);
+        if (!valid && !ref_valid) continue;
+        tested++;
+
+        bool known_entry;
+        bool expect_valid = test_expect(raw, ref_valid ? &ref : NULL, &expect, &known_entry);
+        if (valid == expect_valid && (!valid || test_same(&inst, &expect))) {
+            if (valid != ref_valid || (valid && !test_same(&inst, &ref))) known++;
+            continue;
+        }
+        if (failed++ >= TEST_REPORTED) continue;
+        printf("decoders differ on 0x%08x%s\n", raw, known_entry ? ", a known difference" : "");
+        test_print("generated", raw, valid ? &inst : NULL);
+        test_print("expected ", raw, expect_valid ? &expect : NULL);
+        test_print("reference", raw, ref_valid ? &ref : NULL);
+    }
+
+    printf("decode: %lu encodings, %lu known differences, %lu failed\n", tested, known, failed);
+    return failed ? 1 : 0;
+}